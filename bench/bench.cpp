@@ -0,0 +1,660 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+// Reproducible CPU, bus, PPU and full-system benchmarks. Results go to stdout (or --json=file)
+// as JSON so runs from different commits can be compared.
+// Usage: breadedSNES-bench [--filter=text] [--min-time=seconds] [--repetitions=n] [--json=file] [--rom=file]...
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bus.h"
+#include "cpu.h"
+#include "flat_bus.h"
+#include "interrupts.h"
+#include "ppu.h"
+#include "scheduler.h"
+#include "system.h"
+
+#ifndef BREADEDSNES_GIT_REVISION
+#define BREADEDSNES_GIT_REVISION "unknown"
+#endif
+
+#ifdef __VERSION__
+#define BREADEDSNES_COMPILER __VERSION__
+#else
+#define BREADEDSNES_COMPILER "unknown"
+#endif
+
+namespace {
+
+struct Options {
+    std::string filter;
+    double min_time = 0.25;     // Seconds per repetition
+    int repetitions = 5;
+    std::string json_path;
+    std::vector<std::string> roms;
+};
+
+struct Benchmark {
+    std::string name;
+    std::string unit;
+    // Does `iterations` units of work and returns how many items that was
+    std::function<double(uint64_t iterations)> run;
+};
+
+struct Result {
+    std::string name;
+    std::string unit;
+    std::vector<double> rates;  // Items per second, one per repetition
+};
+
+// Something the benchmark can't measure yet, reported as such rather than as a number
+struct Unsupported {
+    std::string name;
+    std::string reason;
+};
+
+// Keeps results alive so the optimizer can't drop the work that produced them
+volatile uint64_t sink;
+
+// Synthetic programs
+
+// LoROM-style image: code at $00:8000 lives at ROM offset $8000
+constexpr uint32_t kCodeStart = 0x8000;
+
+class ProgramBuilder {
+    std::vector<uint8_t> rom = std::vector<uint8_t>(0x10000, 0xEA);
+    uint32_t at = kCodeStart;
+
+public:
+    void Emit(std::initializer_list<uint8_t> bytes) {
+        for (const uint8_t byte : bytes) rom[at++] = byte;
+    }
+
+    [[nodiscard]] uint32_t Here() const { return at; }
+    void Seek(const uint32_t address) { at = address; }
+
+    void SetVector(const uint32_t vector, const uint16_t target) {
+        rom[vector] = target & 0xFF;
+        rom[vector + 1] = target >> 8;
+    }
+
+    std::vector<uint8_t> Finish() {
+        SetVector(0xFFFC, kCodeStart);
+        return std::move(rom);
+    }
+};
+
+enum class Mix { ALU8, ALU16, Memory, Branch, Stack };
+
+// Native mode, a fixed-seed stream of instructions from one mix, then a jump back to the
+// top. Only uses instructions that leave M/X alone so the stream decodes the same every pass.
+std::vector<uint8_t> BuildMixProgram(const Mix mix) {
+    ProgramBuilder program;
+    std::mt19937 random(0x5EED0000 + static_cast<int>(mix));
+    const auto byte = [&random] { return static_cast<uint8_t>(random()); };
+
+    program.Emit({0x18, 0xFB});                             // CLC; XCE
+    if (mix == Mix::ALU16) {
+        program.Emit({0xC2, 0x30});                         // REP #$30
+    } else {
+        program.Emit({0xE2, 0x30});                         // SEP #$30
+    }
+    program.Emit({0xA2, 0x10});                             // LDX #$10 (low byte in 16-bit mode)
+    if (mix == Mix::ALU16) program.Emit({0x00});
+    const uint32_t loop = program.Here();
+
+    constexpr uint32_t kBodyEnd = 0xE000;                   // Leaves room for subroutines
+    const uint32_t subroutine = kBodyEnd + 0x10;
+    while (program.Here() < kBodyEnd - 16) {
+        switch (mix) {
+            case Mix::ALU8: {
+                static constexpr uint8_t immediate[] = {0xA9, 0x69, 0xE9, 0x29, 0x09, 0x49, 0x89, 0xC9, 0xE0, 0xC0};
+                static constexpr uint8_t implied[] = {0x1A, 0x3A, 0x0A, 0x4A, 0x2A, 0x6A, 0xAA, 0xA8, 0x8A,
+                                                      0x98, 0xE8, 0xCA, 0xC8, 0x88, 0x18, 0x38, 0xEB};
+                if (random() % 2) {
+                    program.Emit({immediate[random() % std::size(immediate)], byte()});
+                } else {
+                    program.Emit({implied[random() % std::size(implied)]});
+                }
+                break;
+            }
+            case Mix::ALU16: {
+                static constexpr uint8_t immediate[] = {0xA9, 0x69, 0xE9, 0x29, 0x09, 0x49, 0x89, 0xC9, 0xE0, 0xC0};
+                static constexpr uint8_t implied[] = {0x1A, 0x3A, 0x0A, 0x4A, 0x2A, 0x6A, 0xAA, 0xA8, 0x8A,
+                                                      0x98, 0xE8, 0xCA, 0xC8, 0x88, 0x18, 0x38, 0xEB, 0x5B, 0x7B};
+                if (random() % 2) {
+                    program.Emit({immediate[random() % std::size(immediate)], byte(), byte()});
+                } else {
+                    program.Emit({implied[random() % std::size(implied)]});
+                }
+                break;
+            }
+            case Mix::Memory: {
+                // Loads, stores and read-modify-writes against WRAM, with X/Y kept below $100
+                switch (random() % 12) {
+                    case 0: program.Emit({0xA5, byte()}); break;                        // LDA dp
+                    case 1: program.Emit({0xB5, byte()}); break;                        // LDA dp,X
+                    case 2: program.Emit({0xAD, byte(), static_cast<uint8_t>(random() % 0x20)}); break;  // LDA abs
+                    case 3: program.Emit({0xBD, byte(), static_cast<uint8_t>(random() % 0x1F)}); break;  // LDA abs,X
+                    case 4: program.Emit({0xAF, byte(), byte(), 0x7E}); break;          // LDA long
+                    case 5: program.Emit({0x65, byte()}); break;                        // ADC dp
+                    case 6: program.Emit({0x04, byte()}); break;                        // TSB dp
+                    case 7: program.Emit({0x1C, byte(), static_cast<uint8_t>(random() % 0x20)}); break;  // TRB abs
+                    case 8: program.Emit({0x85, byte()}); break;                        // STA dp
+                    case 9: program.Emit({0x8D, byte(), static_cast<uint8_t>(random() % 0x20)}); break;  // STA abs
+                    case 10: program.Emit({0xE6, byte()}); break;                       // INC dp
+                    case 11: program.Emit({0xC5, byte()}); break;                       // CMP dp
+                }
+                break;
+            }
+            case Mix::Branch: {
+                // Short counted loops, taken and untaken branches
+                switch (random() % 4) {
+                    case 0: {
+                        program.Emit({0xA0, static_cast<uint8_t>(2 + random() % 6)});  // LDY #n
+                        program.Emit({0x88, 0xD0, 0xFD});                               // DEY; BNE -3
+                        break;
+                    }
+                    case 1: program.Emit({0x80, 0x00}); break;                          // BRA +0
+                    case 2: program.Emit({0x18, 0xB0, 0x02}); break;                    // CLC; BCS +2 (not taken)
+                    case 3: program.Emit({0x38, 0xB0, 0x00}); break;                    // SEC; BCS +0
+                }
+                break;
+            }
+            case Mix::Stack: {
+                switch (random() % 4) {
+                    case 0: program.Emit({0x48, 0x68}); break;                          // PHA; PLA
+                    case 1: program.Emit({0xDA, 0x5A, 0x7A, 0xFA}); break;              // PHX; PHY; PLY; PLX
+                    case 2: program.Emit({0x08, 0x28}); break;                          // PHP; PLP
+                    case 3:
+                        program.Emit({0x20, static_cast<uint8_t>(subroutine), static_cast<uint8_t>(subroutine >> 8)});
+                        break;                                                          // JSR sub
+                }
+                break;
+            }
+        }
+    }
+    program.Emit({0x4C, static_cast<uint8_t>(loop), static_cast<uint8_t>(loop >> 8)});  // JMP loop
+
+    program.Seek(subroutine);
+    program.Emit({0x8B, 0xAB, 0x60});                       // PHB; PLB; RTS
+    return program.Finish();
+}
+
+// Full-system workloads: NMI every frame plus either a WAI loop, a busy main loop, or a
+// block copy in the NMI handler. Display is a WAI loop with the screen on, in mode 7 with
+// sprites, so the PPU draws every line.
+enum class Workload { Idle, Busy, BlockCopy, Display };
+
+std::vector<uint8_t> BuildSystemProgram(const Workload workload) {
+    ProgramBuilder program;
+    program.Emit({0x18, 0xFB, 0xC2, 0x10, 0xE2, 0x20});     // CLC; XCE; REP #$10; SEP #$20
+    if (workload == Workload::Display) {
+        program.Emit({0xA9, 0x07, 0x8D, 0x05, 0x21});       // LDA #$07; STA $2105 (mode 7)
+        program.Emit({0xA9, 0x11, 0x8D, 0x2C, 0x21});       // LDA #$11; STA $212C (BG1 and OBJ)
+        program.Emit({0xA9, 0x0F, 0x8D, 0x00, 0x21});       // LDA #$0F; STA $2100 (screen on)
+    }
+    program.Emit({0xA9, 0x80, 0x0C, 0x00, 0x42});           // LDA #$80; TSB $4200 (NMI on)
+    const uint32_t loop = program.Here();
+    if (workload == Workload::Busy) {
+        program.Emit({0xA0, 0x00, 0x01});                   // LDY #$0100
+        program.Emit({0xB9, 0x00, 0x00});                   // LDA $0000,Y
+        program.Emit({0x69, 0x01, 0x04, 0x20});             // ADC #$01; TSB $20
+        program.Emit({0x88, 0xD0, 0xF6});                   // DEY; BNE -10
+    } else {
+        program.Emit({0xCB});                               // WAI
+    }
+    program.Emit({0x4C, static_cast<uint8_t>(loop), static_cast<uint8_t>(loop >> 8)});
+
+    constexpr uint16_t kNMIHandler = 0x9000;
+    program.Seek(kNMIHandler);
+    program.Emit({0xAD, 0x10, 0x42});                       // LDA $4210
+    if (workload == Workload::BlockCopy) {
+        program.Emit({0xC2, 0x20});                         // REP #$20
+        program.Emit({0xA9, 0xFF, 0x1F});                   // LDA #$1FFF
+        program.Emit({0xA2, 0x00, 0x80, 0xA0, 0x00, 0x00}); // LDX #$8000; LDY #$0000
+        program.Emit({0x54, 0x7F, 0x00});                   // MVN $00,$7F: 8KB of ROM into WRAM
+        program.Emit({0x4B, 0xAB, 0xE2, 0x20});             // PHK; PLB; SEP #$20
+    }
+    program.Emit({0x40});                                   // RTI
+    program.SetVector(0xFFEA, kNMIHandler);
+    return program.Finish();
+}
+
+// Benchmarks
+
+const char* BackendName(const CPUBackend backend) {
+    switch (backend) {
+        case CPUBackend::Interpreter: return "interpreter";
+        case CPUBackend::BlockCache: return "cached";
+        case CPUBackend::JIT: return "jit";
+    }
+    return "?";
+}
+
+// Runs one mix for a fixed number of CPU cycles per iteration. Instructions are counted
+// once on the interpreter so every backend reports instructions/s for the same work.
+void AddCPUBenchmarks(std::vector<Benchmark>& benchmarks) {
+    static constexpr std::pair<Mix, const char*> mixes[] = {
+        {Mix::ALU8, "alu8"}, {Mix::ALU16, "alu16"}, {Mix::Memory, "memory"}, {Mix::Branch, "branch"},
+        {Mix::Stack, "stack"},
+    };
+    constexpr uint64_t kCyclesPerIteration = 10000;
+
+    for (const auto& [mix, mix_name] : mixes) {
+        auto cartridge = std::make_shared<std::vector<uint8_t>>(BuildMixProgram(mix));
+
+        auto interpreter_bus = std::make_unique<Bus>(cartridge.get());
+        CPU counter(interpreter_bus.get());
+        counter.SetBackend(CPUBackend::Interpreter);
+        uint64_t counted = 0;
+        while (counter.GetCycles() < 1000000) {
+            counter.Step();
+            counted++;
+        }
+        const double instructions_per_cycle = static_cast<double>(counted) / counter.GetCycles();
+
+        for (const CPUBackend backend : {CPUBackend::Interpreter, CPUBackend::BlockCache, CPUBackend::JIT}) {
+            if (backend == CPUBackend::JIT && !JIT::IsSupported()) continue;
+
+            auto bus = std::make_shared<Bus>(cartridge.get());
+            auto cpu = std::make_shared<CPU>(bus.get());
+            cpu->SetBackend(backend);
+            benchmarks.push_back({
+                std::string("cpu/") + BackendName(backend) + "/" + mix_name, "instructions/s",
+                [cartridge, bus, cpu, instructions_per_cycle](const uint64_t iterations) {
+                    const uint64_t start = cpu->GetCycles();
+                    cpu->SetCycleDeadline(start + iterations * kCyclesPerIteration);
+                    cpu->Run();
+                    return (cpu->GetCycles() - start) * instructions_per_cycle;
+                },
+            });
+        }
+
+        // The same program on a FlatBus, to separate memory map cost from instruction cost
+        auto flat_bus = std::make_shared<FlatBus>();
+        std::ranges::copy(*cartridge, flat_bus->GetMemory());
+        auto flat_cpu = std::make_shared<BasicCPU<FlatBus>>(flat_bus.get());
+        flat_cpu->SetBackend(CPUBackend::Interpreter);
+        benchmarks.push_back({
+            std::string("cpu/interpreter-flat/") + mix_name, "instructions/s",
+            [flat_bus, flat_cpu, instructions_per_cycle](const uint64_t iterations) {
+                const uint64_t start = flat_cpu->GetCycles();
+                flat_cpu->SetCycleDeadline(start + iterations * kCyclesPerIteration);
+                flat_cpu->Run();
+                return (flat_cpu->GetCycles() - start) * instructions_per_cycle;
+            },
+        });
+    }
+}
+
+void AddBusBenchmarks(std::vector<Benchmark>& benchmarks) {
+    struct Region {
+        const char* name;
+        uint32_t base;
+        uint32_t size;
+    };
+    static constexpr Region regions[] = {
+        {"wram_low", 0x000000, 0x2000},
+        {"wram", 0x7E0000, 0x20000},
+        {"rom", 0x808000, 0x8000},
+        {"rom_mirror", 0x008000, 0x8000},
+        {"io_hvbjoy", 0x004212, 1},
+        {"open_bus", 0x005000, 0x1000},
+    };
+    constexpr uint64_t kAccessesPerIteration = 4096;
+
+    // Shared hardware: a bus with the interrupt controller attached, as in System
+    struct Hardware {
+        std::vector<uint8_t> cartridge = std::vector<uint8_t>(0x10000, 0x42);
+        Scheduler scheduler;
+        std::unique_ptr<Bus> bus = std::make_unique<Bus>(&cartridge);
+        std::unique_ptr<CPU> cpu = std::make_unique<CPU>(bus.get());
+        std::unique_ptr<InterruptController> interrupts =
+            std::make_unique<InterruptController>(cpu.get(), &scheduler, [] { return uint64_t{0}; });
+        Hardware() { bus->ConnectInterrupts(interrupts.get()); }
+    };
+    auto hardware = std::make_shared<Hardware>();
+
+    for (const Region& region : regions) {
+        auto addresses = std::make_shared<std::vector<uint32_t>>(kAccessesPerIteration);
+        std::mt19937 random(0xB05 + region.base);
+        for (uint32_t& address : *addresses) address = region.base + random() % region.size;
+
+        benchmarks.push_back({
+            std::string("bus/read/") + region.name, "accesses/s",
+            [hardware, addresses](const uint64_t iterations) {
+                uint64_t total = 0;
+                for (uint64_t i = 0; i < iterations; i++) {
+                    for (const uint32_t address : *addresses) total += hardware->bus->Read(address);
+                }
+                sink = total;
+                return static_cast<double>(iterations * addresses->size());
+            },
+        });
+
+        // ROM and HVBJOY ignore writes, but the lookup still costs
+        benchmarks.push_back({
+            std::string("bus/write/") + region.name, "accesses/s",
+            [hardware, addresses](const uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; i++) {
+                    uint8_t value = static_cast<uint8_t>(i);
+                    for (const uint32_t address : *addresses) hardware->bus->Write(address, value++);
+                }
+                return static_cast<double>(iterations * addresses->size());
+            },
+        });
+    }
+}
+
+void AddPPUBenchmarks(std::vector<Benchmark>& benchmarks) {
+    auto ppu = std::make_shared<PPU>();
+    benchmarks.push_back({
+        "ppu/advance_scanline", "scanlines/s",
+        [ppu](const uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) ppu->Advance(PPU::kDotsPerScanline);
+            return static_cast<double>(iterations);
+        },
+    });
+
+    // 128 16x16/32x32 sprites scattered over the screen with random tile data, drawn a frame at a time.
+    // "static" keeps OAM fixed so evaluation is cached; "oam_rewrite" rewrites OAM every frame like a DMA.
+    auto sprites = std::make_shared<PPU>();
+    std::mt19937 random(0x5EED0039);
+    sprites->WriteRegister(0x2115, 0x80);
+    for (uint32_t i = 0; i < 0x8000; i++) {
+        sprites->WriteRegister(0x2118, static_cast<uint8_t>(random()));
+        sprites->WriteRegister(0x2119, static_cast<uint8_t>(random()));
+    }
+    for (uint32_t i = 0; i < 0x200; i++) sprites->WriteRegister(0x2122, static_cast<uint8_t>(random()));
+    auto oam = std::make_shared<std::vector<uint8_t>>(0x220);
+    for (uint8_t& byte : *oam) byte = static_cast<uint8_t>(random());
+    const auto write_oam = [sprites, oam] {
+        sprites->WriteRegister(0x2102, 0);
+        sprites->WriteRegister(0x2103, 0);
+        for (const uint8_t byte : *oam) sprites->WriteRegister(0x2104, byte);
+    };
+    write_oam();
+    sprites->WriteRegister(0x2101, 0x60);
+    sprites->WriteRegister(0x212C, 0x10);
+    sprites->WriteRegister(0x2100, 0x0F);
+
+    for (const bool rewrite : {false, true}) {
+        benchmarks.push_back({
+            rewrite ? "ppu/render_obj/oam_rewrite" : "ppu/render_obj/static", "scanlines/s",
+            [sprites, write_oam, rewrite](const uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; i++) {
+                    if (rewrite) write_oam();
+                    for (uint16_t line = 1; line < PPU::kVBlankScanline; line++) sprites->RenderScanline(line);
+                }
+                sink = sprites->GetFramebuffer()[PPU::kScreenWidth * 100];
+                return static_cast<double>(iterations * (PPU::kVBlankScanline - 1));
+            },
+        });
+    }
+
+    // Mode 7 over random VRAM with a rotated, scaled matrix, in each M7SEL fill mode.
+    // "windows_math" adds sprites on both screens, a window on the main screen's sprites and
+    // half-add color math, to exercise every compositor stage, and "windows_math_parallel" draws
+    // the same frames at VBlank on every hardware thread. "pseudo_hires" draws BG1 on both
+    // screens into 512-wide frames.
+    struct Mode7Setup {
+        uint8_t fill;
+        const char* name;
+        bool compositing;
+        bool hires;
+        bool parallel;
+    };
+    static constexpr Mode7Setup setups[] = {
+        {0x00, "wrap", false, false, false},         {0x80, "transparent", false, false, false},
+        {0xC0, "tile0", false, false, false},        {0x00, "windows_math", true, false, false},
+        {0x00, "windows_math_parallel", true, false, true}, {0x00, "pseudo_hires", false, true, false},
+    };
+    for (const auto& [fill, setup_name, compositing, hires, parallel] : setups) {
+        auto mode7 = std::make_shared<PPU>();
+        mode7->WriteRegister(0x2115, 0x80);
+        for (uint32_t i = 0; i < 0x8000; i++) {
+            mode7->WriteRegister(0x2118, static_cast<uint8_t>(random()));
+            mode7->WriteRegister(0x2119, static_cast<uint8_t>(random()));
+        }
+        for (uint32_t i = 0; i < 0x200; i++) mode7->WriteRegister(0x2122, static_cast<uint8_t>(random()));
+        // cos/sin of ~30 degrees at 1.5x zoom, centered on the middle of the plane
+        static constexpr std::pair<uint16_t, uint16_t> registers[] = {
+            {0x211B, 0x014C}, {0x211C, 0x00C0}, {0x211D, 0xFF40}, {0x211E, 0x014C},
+            {0x211F, 0x0200}, {0x2120, 0x0200}, {0x210D, 0x0180}, {0x210E, 0x0190},
+        };
+        for (const auto& [address, value] : registers) {
+            mode7->WriteRegister(address, value & 0xFF);
+            mode7->WriteRegister(address, value >> 8);
+        }
+        mode7->WriteRegister(0x211A, fill);
+        mode7->WriteRegister(0x2105, 0x07);
+        mode7->WriteRegister(0x212C, 0x01);
+        mode7->WriteRegister(0x2100, 0x0F);
+        if (compositing) {
+            for (const uint8_t byte : *oam) mode7->WriteRegister(0x2104, byte);
+            static constexpr std::pair<uint16_t, uint8_t> compositor_registers[] = {
+                {0x2101, 0x60}, {0x212C, 0x11}, {0x212D, 0x10}, {0x2125, 0x02}, {0x2126, 64},
+                {0x2127, 191},  {0x212E, 0x10}, {0x2130, 0x02}, {0x2131, 0x41},
+            };
+            for (const auto& [address, value] : compositor_registers) mode7->WriteRegister(address, value);
+        }
+        if (hires) {
+            mode7->WriteRegister(0x212D, 0x01);
+            mode7->WriteRegister(0x2133, 0x08);
+        }
+        if (parallel) mode7->SetRenderThreads(std::max(std::thread::hardware_concurrency(), 1u));
+
+        benchmarks.push_back({
+            std::string("ppu/render_mode7/") + setup_name, "scanlines/s",
+            [mode7](const uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; i++) {
+                    for (uint16_t line = 1; line < PPU::kVBlankScanline; line++) mode7->RenderScanline(line);
+                    mode7->OnVBlankStart();
+                }
+                sink = mode7->GetFramebuffer()[PPU::kScreenWidth * 100];
+                return static_cast<double>(iterations * (PPU::kVBlankScanline - 1));
+            },
+        });
+    }
+}
+
+// Only OBJ and mode 7 lines are drawn so far; timing a BG mode would only time the backdrop
+void AddUnsupportedPPUBenchmarks(std::vector<Unsupported>& unsupported) {
+    for (int mode = 0; mode <= 6; mode++) {
+        unsupported.push_back({"ppu/render_bg/mode" + std::to_string(mode), "PPU::DrawLine has no BG layers"});
+    }
+}
+
+// APU::Step doesn't run SPC700 code yet, so there are no APU cycles to time
+void AddUnsupportedAPUBenchmarks(std::vector<Unsupported>& unsupported) {
+    unsupported.push_back({"apu/cycles", "APU::Step is empty"});
+}
+
+void AddSystemBenchmark(std::vector<Benchmark>& benchmarks, const std::string& name,
+                        const std::vector<uint8_t>& rom, const CPUBackend backend, const uint32_t frame_skip = 0) {
+    auto system = std::make_shared<System>();
+    system->LoadROM(rom);
+    system->SetCPUBackend(backend);
+    system->SetFrameSkip(frame_skip);
+    system->Reset();
+    benchmarks.push_back({
+        "system/" + std::string(BackendName(backend)) + "/" + name, "frames/s",
+        [system](const uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) system->RunFrame();
+            return static_cast<double>(iterations);
+        },
+    });
+}
+
+void AddSystemBenchmarks(std::vector<Benchmark>& benchmarks, const std::vector<std::string>& roms) {
+    static constexpr std::pair<Workload, const char*> workloads[] = {
+        {Workload::Idle, "nmi_wai"}, {Workload::Busy, "nmi_busy"}, {Workload::BlockCopy, "nmi_mvn"},
+        {Workload::Display, "display"},
+    };
+
+    for (const CPUBackend backend : {CPUBackend::Interpreter, CPUBackend::BlockCache, CPUBackend::JIT}) {
+        if (backend == CPUBackend::JIT && !JIT::IsSupported()) continue;
+
+        for (const auto& [workload, workload_name] : workloads) {
+            AddSystemBenchmark(benchmarks, workload_name, BuildSystemProgram(workload), backend);
+        }
+        // Fast-forward: three of every four frames skipped
+        AddSystemBenchmark(benchmarks, "display_skip3", BuildSystemProgram(Workload::Display), backend, 3);
+        for (const std::string& path : roms) {
+            std::ifstream file(path, std::ios::binary);
+            if (!file) {
+                std::cerr << "Failed to open ROM file: " << path << std::endl;
+                continue;
+            }
+            std::vector<uint8_t> rom((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            const std::string name = path.substr(path.find_last_of("/\\") + 1);
+            AddSystemBenchmark(benchmarks, "rom/" + name, rom, backend);
+        }
+    }
+}
+
+// Harness
+
+double Seconds(const std::function<double(uint64_t)>& run, const uint64_t iterations, double& items) {
+    const auto start = std::chrono::steady_clock::now();
+    items = run(iterations);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+Result Measure(const Benchmark& benchmark, const Options& options) {
+    // Grow the iteration count until one repetition takes at least min_time
+    uint64_t iterations = 1;
+    double items = 0;
+    for (double elapsed = Seconds(benchmark.run, iterations, items); elapsed < options.min_time;
+         elapsed = Seconds(benchmark.run, iterations, items)) {
+        const double scale = elapsed > 0 ? options.min_time / elapsed * 1.2 : 10;
+        iterations = std::max(iterations + 1, static_cast<uint64_t>(iterations * std::min(scale, 10.0)));
+    }
+
+    Result result{benchmark.name, benchmark.unit, {}};
+    for (int i = 0; i < options.repetitions; i++) {
+        const double elapsed = Seconds(benchmark.run, iterations, items);
+        result.rates.push_back(items / elapsed);
+    }
+    return result;
+}
+
+std::string JSONString(const std::string& text) {
+    std::string quoted = "\"";
+    for (const char c : text) {
+        if (c == '"' || c == '\\') quoted += '\\';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+void WriteJSON(std::ostream& out, const std::vector<Result>& results, const std::vector<Unsupported>& unsupported,
+               const Options& options) {
+    out << "{\n";
+    out << "  \"revision\": " << JSONString(BREADEDSNES_GIT_REVISION) << ",\n";
+    out << "  \"compiler\": " << JSONString(BREADEDSNES_COMPILER) << ",\n";
+    out << "  \"repetitions\": " << options.repetitions << ",\n";
+    out << "  \"min_time\": " << options.min_time << ",\n";
+    out << "  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        std::vector<double> rates = results[i].rates;
+        std::ranges::sort(rates);
+        char numbers[160];
+        std::snprintf(numbers, sizeof(numbers), "\"median\": %.6g, \"min\": %.6g, \"max\": %.6g",
+                      rates[rates.size() / 2], rates.front(), rates.back());
+        out << "    {\"name\": " << JSONString(results[i].name) << ", \"unit\": " << JSONString(results[i].unit)
+            << ", " << numbers << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n";
+    out << "  \"unsupported\": [\n";
+    for (size_t i = 0; i < unsupported.size(); i++) {
+        out << "    {\"name\": " << JSONString(unsupported[i].name) << ", \"reason\": "
+            << JSONString(unsupported[i].reason) << "}" << (i + 1 < unsupported.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+} // namespace
+
+int main(const int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg.starts_with("--filter=")) {
+            options.filter = arg.substr(9);
+        } else if (arg.starts_with("--min-time=")) {
+            options.min_time = std::stod(arg.substr(11));
+        } else if (arg.starts_with("--repetitions=")) {
+            options.repetitions = std::max(1, std::stoi(arg.substr(14)));
+        } else if (arg.starts_with("--json=")) {
+            options.json_path = arg.substr(7);
+        } else if (arg.starts_with("--rom=")) {
+            options.roms.push_back(arg.substr(6));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--filter=text] [--min-time=seconds] [--repetitions=n]"
+                      << " [--json=file] [--rom=file]..." << std::endl;
+            return 1;
+        }
+    }
+
+    // System prints to stdout when it loads ROMs; keep stdout for the JSON
+    std::streambuf* const stdout_buffer = std::cout.rdbuf(std::cerr.rdbuf());
+
+    std::vector<Benchmark> benchmarks;
+    AddCPUBenchmarks(benchmarks);
+    AddBusBenchmarks(benchmarks);
+    AddPPUBenchmarks(benchmarks);
+    AddSystemBenchmarks(benchmarks, options.roms);
+
+    std::vector<Unsupported> unsupported;
+    AddUnsupportedPPUBenchmarks(unsupported);
+    AddUnsupportedAPUBenchmarks(unsupported);
+    std::erase_if(unsupported, [&options](const Unsupported& entry) {
+        return !options.filter.empty() && entry.name.find(options.filter) == std::string::npos;
+    });
+
+    std::vector<Result> results;
+    for (const Benchmark& benchmark : benchmarks) {
+        if (!options.filter.empty() && benchmark.name.find(options.filter) == std::string::npos) continue;
+
+        results.push_back(Measure(benchmark, options));
+        std::vector<double> rates = results.back().rates;
+        std::ranges::sort(rates);
+        char line[160];
+        std::snprintf(line, sizeof(line), "%-36s %14.6g %s", benchmark.name.c_str(), rates[rates.size() / 2],
+                      benchmark.unit.c_str());
+        std::cerr << line << std::endl;
+    }
+    for (const Unsupported& entry : unsupported) {
+        char line[160];
+        std::snprintf(line, sizeof(line), "%-36s %14s (%s)", entry.name.c_str(), "unsupported", entry.reason.c_str());
+        std::cerr << line << std::endl;
+    }
+
+    std::cout.rdbuf(stdout_buffer);
+    if (options.json_path.empty()) {
+        WriteJSON(std::cout, results, unsupported, options);
+    } else {
+        std::ofstream file(options.json_path);
+        if (!file) {
+            std::cerr << "Failed to open " << options.json_path << std::endl;
+            return 1;
+        }
+        WriteJSON(file, results, unsupported, options);
+    }
+    return 0;
+}
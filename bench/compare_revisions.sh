@@ -0,0 +1,42 @@
+#!/bin/sh
+# Builds cpu_revisions.cpp against the sources of each revision given, then runs the builds in
+# turn for a few rounds and prints each one's best interpreter instruction rate. For the lazy
+# flags change:
+#   bench/compare_revisions.sh 707a321^ 707a321
+# Usage: bench/compare_revisions.sh <revision>...   (ROUNDS=5 and SECONDS_PER_RUN=1 by default)
+set -e
+
+root=$(git rev-parse --show-toplevel)
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+index=0
+for revision in "$@"; do
+    index=$((index + 1))
+    tree="$work/$index"
+    mkdir -p "$tree"
+    git -C "$root" archive "$revision" | tar -x -C "$tree"
+    # Everything but the SDL front end
+    sources=$(ls "$tree"/src/*.cpp | grep -v '/main\.cpp$')
+    # shellcheck disable=SC2086
+    ${CXX:-c++} -std=c++23 -O2 -DNDEBUG -I"$tree/src" -I"$tree/include" "$root/bench/cpu_revisions.cpp" \
+        $sources -lpthread -o "$tree/cpu-revisions"
+done
+
+# Interleaved, so a machine that gets busier partway through doesn't favor one revision
+round=0
+while [ "$round" -lt "${ROUNDS:-5}" ]; do
+    round=$((round + 1))
+    index=0
+    for revision in "$@"; do
+        index=$((index + 1))
+        "$work/$index/cpu-revisions" "${SECONDS_PER_RUN:-1}" >> "$work/$index/runs"
+    done
+done
+
+index=0
+for revision in "$@"; do
+    index=$((index + 1))
+    best=$(sort -g -r "$work/$index/runs" | head -n 1)
+    echo "$revision: $best"
+done
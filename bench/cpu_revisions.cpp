@@ -0,0 +1,77 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+// Interpreter instructions/sec on a flag-heavy ALU and branch loop, using only the Bus and CPU
+// calls that have been there since before the lazy flags change. compare_revisions.sh builds it
+// against older revisions' sources, which breadedSNES-bench can't be. The program runs from WRAM
+// since that's the one place every revision maps the same way, in 16-bit mode and without
+// compares or stores, which took the wrong number of operand bytes before the conformance work.
+// Usage: breadedSNES-cpu-revisions [seconds]
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include "bus.h"
+#include "cpu.h"
+
+namespace {
+
+constexpr uint16_t kCodeStart = 0x0200;
+
+void LoadProgram(Bus& bus) {
+    uint16_t at = kCodeStart;
+    const auto emit = [&bus, &at](const std::initializer_list<uint8_t> bytes) {
+        for (const uint8_t byte : bytes) bus.Write(at++, byte);
+    };
+
+    emit({0x18, 0xFB, 0xC2, 0x30});                              // CLC; XCE; REP #$30
+    const uint16_t loop = at;
+    emit({0xA2, 0x40, 0x00});                                    // LDX #$0040
+    const uint16_t inner = at;
+    emit({0x98, 0x69, 0x37, 0x13, 0x2A, 0x45, 0x11});            // TYA; ADC #$1337; ROL A; EOR $11
+    emit({0x90, 0x01, 0xC8});                                    // BCC +1; INY
+    emit({0x29, 0x0F, 0x0F, 0x09, 0x20, 0x20, 0x4A});            // AND #$0F0F; ORA #$2020; LSR A
+    emit({0x38, 0xE5, 0x12, 0x24, 0x12, 0xA8});                  // SEC; SBC $12; BIT $12; TAY
+    emit({0xCA, 0xD0, static_cast<uint8_t>(inner - (at + 2))});  // DEX; BNE inner
+    emit({0x80, static_cast<uint8_t>(loop - (at + 2))});         // BRA loop
+}
+
+} // namespace
+
+int main(const int argc, char* argv[]) {
+    const double seconds = argc > 1 ? std::stod(argv[1]) : 2.0;
+
+    std::vector<uint8_t> cartridge(0x8000, 0xEA);
+    Bus bus(&cartridge);
+    LoadProgram(bus);
+    CPU cpu(&bus);
+    cpu.SetBackend(CPUBackend::Interpreter);
+    CPU::State state = cpu.GetState();
+    state.PC = kCodeStart;
+    state.PB = 0;
+    cpu.SetState(state);
+
+    // Best of several slices, so a busy machine only ever makes the result look worse
+    double best = 0;
+    uint64_t instructions = 0;
+    CPU::State first_slice{};
+    const auto start = std::chrono::steady_clock::now();
+    while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < seconds) {
+        const auto slice_start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 1000000; i++) cpu.Step();
+        instructions += 1000000;
+        if (instructions == 1000000) first_slice = cpu.GetState();
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - slice_start).count();
+        if (1e6 / elapsed > best) best = 1e6 / elapsed;
+    }
+
+    // Where the first slice ended shows that both revisions ran the same program
+    std::printf("%.1fM instructions/s (best 1M slice); after 1M: A=%04X X=%04X P=%02X cycles=%llu\n", best / 1e6,
+                first_slice.A, first_slice.X, first_slice.P, static_cast<unsigned long long>(first_slice.cycles));
+    return 0;
+}
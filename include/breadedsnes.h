@@ -0,0 +1,114 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+// C API for embedding the emulator, mainly as a reinforcement-learning environment. A batch holds
+// many independent consoles running the same ROM and steps all of them at once on a pool of
+// threads (see BatchRunner). Each step leaves every console's picture in one contiguous
+// observation buffer that the caller reads in place, environment after environment.
+//
+// Calls on one batch must not overlap. Pointers returned by a batch stay valid until it is
+// destroyed; what they point to changes with every step, reset or state load.
+
+#ifndef BREADEDSNES_H
+#define BREADEDSNES_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define BREADED_API
+#else
+#define BREADED_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct breaded_batch breaded_batch;
+
+// Observation pixel formats. The value is the number of bytes per pixel.
+typedef enum breaded_observation {
+    BREADED_OBSERVATION_NONE = 0,   // No observations, and no frames drawn at all
+    BREADED_OBSERVATION_GRAY = 1,   // Luma
+    BREADED_OBSERVATION_RGB = 3,    // Red, green, blue
+} breaded_observation;
+
+typedef enum breaded_cpu {
+    BREADED_CPU_INTERPRETER,
+    BREADED_CPU_CACHED,
+    BREADED_CPU_JIT,
+} breaded_cpu;
+
+// Observations are one 256x224 picture per environment, rows top to bottom. Hi-res and
+// interlaced frames keep every other column or line; overscan lines past 224 are cut off.
+#define BREADED_OBSERVATION_WIDTH 256
+#define BREADED_OBSERVATION_HEIGHT 224
+
+#define BREADED_PORTS 2
+#define BREADED_WRAM_SIZE 0x20000
+
+// Pad buttons, as in Controllers::Button
+#define BREADED_BUTTON_B 0x8000
+#define BREADED_BUTTON_Y 0x4000
+#define BREADED_BUTTON_SELECT 0x2000
+#define BREADED_BUTTON_START 0x1000
+#define BREADED_BUTTON_UP 0x0800
+#define BREADED_BUTTON_DOWN 0x0400
+#define BREADED_BUTTON_LEFT 0x0200
+#define BREADED_BUTTON_RIGHT 0x0100
+#define BREADED_BUTTON_A 0x0080
+#define BREADED_BUTTON_X 0x0040
+#define BREADED_BUTTON_L 0x0020
+#define BREADED_BUTTON_R 0x0010
+
+// `threads` 0 means one per hardware thread. There are never more threads than environments.
+// Returns NULL if the batch can't be allocated.
+BREADED_API breaded_batch* breaded_create(uint32_t environments, uint32_t threads, breaded_observation observation);
+BREADED_API void breaded_destroy(breaded_batch* batch);
+
+// Every environment gets the ROM and powers on. Also drops the reset state. Only the file is
+// checked: the ROM image itself isn't validated, so any data loads.
+BREADED_API bool breaded_load_rom(breaded_batch* batch, const char* path);
+BREADED_API void breaded_load_rom_data(breaded_batch* batch, const void* data, size_t size);
+
+BREADED_API void breaded_set_cpu(breaded_batch* batch, breaded_cpu cpu);
+BREADED_API uint32_t breaded_environments(const breaded_batch* batch);
+
+// What breaded_reset goes back to: a state from breaded_save_state, or power-on if `state` is
+// NULL. Returns false, keeping the old reset state, if the state doesn't load.
+BREADED_API bool breaded_set_reset_state(breaded_batch* batch, const void* state, size_t size);
+// Resets the environments whose `mask` byte is nonzero, or all of them if `mask` is NULL. Each
+// one then runs a frame without input, so its observation shows where the episode starts.
+BREADED_API void breaded_reset(breaded_batch* batch, const uint8_t* mask);
+// Holds each environment's buttons for `frames` frames, then writes its observation. `actions`
+// has BREADED_PORTS button masks per environment, or is NULL for no input. Only the last frame
+// of a step is drawn.
+BREADED_API void breaded_step(breaded_batch* batch, const uint16_t* actions, uint32_t frames);
+
+// environments * breaded_observation_size bytes, NULL without observations
+BREADED_API const uint8_t* breaded_observations(const breaded_batch* batch);
+BREADED_API size_t breaded_observation_size(const breaded_batch* batch);
+
+// The calls below take an environment index, and return NULL, 0 or false when it isn't below
+// breaded_environments.
+
+// The environment's last drawn frame as 0xAARRGGBB pixels, at its own resolution
+BREADED_API const uint32_t* breaded_framebuffer(breaded_batch* batch, uint32_t environment, uint32_t* width,
+                                                uint32_t* height);
+// BREADED_WRAM_SIZE bytes of work RAM, for reading game variables such as score or lives
+BREADED_API const uint8_t* breaded_wram(breaded_batch* batch, uint32_t environment);
+
+// Writes the environment's state to `buffer` if it fits in `capacity` bytes. Returns the state's
+// size either way, so a call with capacity 0 finds out how much room to make.
+BREADED_API size_t breaded_save_state(breaded_batch* batch, uint32_t environment, void* buffer, size_t capacity);
+// States from any environment of a batch with the same ROM load into any other. The observation
+// is left alone until the next step.
+BREADED_API bool breaded_load_state(breaded_batch* batch, uint32_t environment, const void* state, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //BREADEDSNES_H
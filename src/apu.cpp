@@ -13,7 +13,29 @@ void APU::Reset() {
     PC = 0x0000;
     PSW = 0x02;
 
-    std::fill(spc_ram, spc_ram + sizeof(spc_ram), 0);
+    std::fill(memory->spc_ram, memory->spc_ram + sizeof(Memory::spc_ram), 0);
+    spc_ram_dirty.MarkAll();
+}
+
+void APU::SaveState(StateWriter& writer) const {
+    writer.WriteBytes(memory->spc_ram, sizeof(Memory::spc_ram));
+    writer.Write(A);
+    writer.Write(X);
+    writer.Write(Y);
+    writer.Write(SP);
+    writer.Write(PC);
+    writer.Write(PSW);
+}
+
+void APU::LoadState(StateReader& reader) {
+    reader.ReadBytes(memory->spc_ram, sizeof(Memory::spc_ram));
+    reader.Read(A);
+    reader.Read(X);
+    reader.Read(Y);
+    reader.Read(SP);
+    reader.Read(PC);
+    reader.Read(PSW);
+    spc_ram_dirty.MarkAll();
 }
 
 void APU::Step() {
@@ -21,9 +43,10 @@ void APU::Step() {
 }
 
 uint8_t APU::ReadSPC(uint16_t address) {
-    return spc_ram[address];
+    return memory->spc_ram[address];
 }
 
 void APU::WriteSPC(uint16_t address, uint8_t value) {
-    spc_ram[address] = value;
+    memory->spc_ram[address] = value;
+    spc_ram_dirty.Mark(address);
 }
\ No newline at end of file
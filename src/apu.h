@@ -6,10 +6,20 @@
 #define APU_H
 #include <cstdint>
 
+#include "dirty_pages.h"
+#include "memory_arena.h"
+#include "save_state.h"
+
 // SPC700 APU
-class APU {
+class alignas(64) APU {
+public:
+    struct Memory {
+        std::uint8_t spc_ram[0x10000];   // 64KB SPC700 RAM
+    };
+
 private:
-    std::uint8_t spc_ram[0x10000];   // 64KB SPC700 RAM
+    BulkMemory<Memory> memory;
+    DirtyPageMap<sizeof(Memory::spc_ram)> spc_ram_dirty;
 
     // APU registers
     uint8_t A, X, Y, SP;
@@ -17,15 +27,22 @@ private:
     uint8_t PSW;
 
 public:
-    APU() {
+    // Without a block of the System's arena, the APU allocates its own memory
+    explicit APU(Memory* block = nullptr) : memory(block) {
         Reset();
     }
 
     void Reset();
+    void SaveState(StateWriter& writer) const;
+    void LoadState(StateReader& reader);
     void Step();
 
     uint8_t ReadSPC(uint16_t address);
     void WriteSPC(uint16_t address, uint8_t value);
+
+    // Incremental snapshot support
+    [[nodiscard]] const uint8_t* GetSPCRAM() const { return memory->spc_ram; }
+    DirtyPageMap<sizeof(Memory::spc_ram)>& GetSPCRAMDirtyPages() { return spc_ram_dirty; }
 };
 
 #endif //APU_H
@@ -0,0 +1,64 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#include "batch_runner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+
+BatchRunner::BatchRunner(const uint32_t instances, const uint32_t threads)
+    : workers(std::max(threads, 1u) - 1), systems(instances), frames_run(instances, 0) {
+    workers.RunPinned(instances, [this](const uint32_t instance) { systems[instance] = std::make_unique<System>(); });
+}
+
+bool BatchRunner::LoadROM(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        std::cout << "Failed to open ROM file: " << filename << std::endl;
+        return false;
+    }
+    LoadROM(std::vector<uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>()));
+    return true;
+}
+
+void BatchRunner::LoadROM(const std::vector<uint8_t>& data) {
+    ForEach([&data, this](const uint32_t instance, System& system) {
+        system.LoadROM(data);
+        system.PowerOn();
+        frames_run[instance] = 0;
+    });
+}
+
+bool BatchRunner::StartPlayback(const Movie& movie) {
+    std::atomic<bool> loaded = true;
+    ForEach([&movie, &loaded](uint32_t, System& system) {
+        if (!system.StartPlayback(movie)) loaded = false;
+    });
+    return loaded;
+}
+
+void BatchRunner::RunFrames(const uint64_t frames) {
+    ForEach([frames, this](const uint32_t instance, System& system) {
+        const uint64_t first = frames_run[instance];
+        for (uint64_t frame = first; frame < first + frames; frame++) {
+            if (input) input(instance, frame, system);
+            system.RunFrame();
+        }
+        frames_run[instance] = first + frames;
+    });
+}
+
+void BatchRunner::ForEach(const std::function<void(uint32_t instance, System& system)>& fn) {
+    workers.RunPinned(GetInstanceCount(), [&fn, this](const uint32_t instance) {
+        fn(instance, *systems[instance]);
+    });
+}
+
+uint64_t BatchRunner::GetTotalFrames() const {
+    return std::accumulate(frames_run.begin(), frames_run.end(), uint64_t{0});
+}
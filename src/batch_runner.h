@@ -0,0 +1,53 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "system.h"
+#include "worker_pool.h"
+
+// Many independent Systems stepped side by side, for training farms and ROM regression runs.
+// Instance i belongs to thread i % threads for its whole life: it's built there, so its memory
+// is first touched by that thread, and every frame of it runs there.
+class BatchRunner {
+public:
+    // Called on the instance's own thread before each frame it runs, to set that frame's input
+    using InputCallback = std::function<void(uint32_t instance, uint64_t frame, System& system)>;
+
+private:
+    WorkerPool workers;
+    std::vector<std::unique_ptr<System>> systems;
+    std::vector<uint64_t> frames_run;   // Per instance
+    InputCallback input;
+
+public:
+    BatchRunner(uint32_t instances, uint32_t threads);
+
+    // Every instance gets its own copy of the ROM, then powers on
+    bool LoadROM(const std::string& filename);
+    void LoadROM(const std::vector<uint8_t>& data);
+
+    void SetInputCallback(InputCallback callback) { input = std::move(callback); }
+    // Plays `movie` on every instance; false if its anchor doesn't load
+    bool StartPlayback(const Movie& movie);
+
+    // Runs every instance `frames` frames and returns once all of them are done
+    void RunFrames(uint64_t frames);
+    // Calls fn(instance, system) for every instance, each on its own thread
+    void ForEach(const std::function<void(uint32_t instance, System& system)>& fn);
+
+    [[nodiscard]] uint32_t GetInstanceCount() const { return static_cast<uint32_t>(systems.size()); }
+    [[nodiscard]] uint32_t GetThreadCount() const { return workers.GetThreadCount(); }
+    [[nodiscard]] System& GetSystem(uint32_t instance) { return *systems[instance]; }
+    // Frames run by all instances together
+    [[nodiscard]] uint64_t GetTotalFrames() const;
+};
+
+#endif //BATCH_RUNNER_H
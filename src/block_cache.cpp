@@ -0,0 +1,114 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#include "block_cache.h"
+
+#include "flat_bus.h"
+#include "opcodes.h"
+
+template <typename BusT>
+BasicBlock* BlockCache<BusT>::Lookup(const uint32_t address, const bool m_8bit, const bool x_8bit, const bool emulation) {
+    const uint32_t key = MakeKey(address, m_8bit, x_8bit, emulation);
+    if (const auto it = blocks.find(key); it != blocks.end()) {
+        return &it->second;
+    }
+    return Decode(key, address & 0xFFFFFF, m_8bit, x_8bit);
+}
+
+// Next's slow path: looks the block up and links it in
+template <typename BusT>
+BasicBlock* BlockCache<BusT>::LinkNext(BasicBlock& from, const uint32_t key) {
+    BasicBlock* next = nullptr;
+    if (const auto it = blocks.find(key); it != blocks.end()) {
+        next = &it->second;
+    } else {
+        next = Decode(key, key & 0xFFFFFF, key & (1u << 24), key & (1u << 25));
+    }
+    if (next) {
+        // A branch fills both links; anything with more ways out keeps replacing the second
+        BasicBlock::Link& link = from.links[from.links[0].generation == generation ? 1 : 0];
+        link = {next, key, generation};
+    }
+    return next;
+}
+
+template <typename BusT>
+BasicBlock* BlockCache<BusT>::Decode(const uint32_t key, const uint32_t address, const bool m_8bit, const bool x_8bit) {
+    BasicBlock block;
+    block.start = address;
+
+    uint32_t pc = address;
+    while (block.instructions.size() < kMaxBlockInstructions) {
+        const uint8_t opcode = bus->Read(pc);
+        const uint8_t length = InstructionLength(opcode, m_8bit, x_8bit);
+
+        // Don't let a block run off the end of the bank or into I/O space
+        if (((pc + length - 1) & 0xFF0000) != (address & 0xFF0000)) break;
+        bool plain = true;
+        for (uint32_t i = 0; i < length; i++) {
+            plain &= bus->IsPlainMemory(pc + i);
+        }
+        if (!plain) break;
+
+        const CycleRange cycles = InstructionCycles(opcode, m_8bit, x_8bit);
+        DecodedInstruction instruction{pc, 0, opcode, length, static_cast<uint8_t>(cycles.min)};
+        for (uint32_t i = 1; i < length; i++) {
+            instruction.operand |= bus->Read(pc + i) << (8 * (i - 1));
+        }
+        block.instructions.push_back(instruction);
+        block.cycles += cycles.min;
+        block.max_cycles = cycles.max == kVariableCycles ? kVariableCycles : block.max_cycles + cycles.max;
+        pc += length;
+
+        if (kOpcodeTable[opcode].ends_block) break;
+    }
+
+    if (block.instructions.empty()) return nullptr;
+    block.end = pc;
+
+    // Watch the WRAM pages this block came from so writes to them invalidate it
+    int32_t last_page = -1;
+    for (uint32_t a = block.start; a < block.end; a++) {
+        const int32_t offset = BusT::WRAMOffset(a);
+        if (offset < 0 || offset / 0x100 == last_page) continue;
+        last_page = offset / 0x100;
+        bus->MarkCodePage(a);
+        page_blocks[last_page].push_back(key);
+        if (page_invalidations[last_page] > 1) block.self_modifying = true;
+    }
+
+    return &blocks.emplace(key, std::move(block)).first->second;
+}
+
+template <typename BusT>
+void BlockCache<BusT>::InvalidateWrittenCode() {
+    bus->TakeWrittenCodePages([this](const size_t page) {
+        for (const uint32_t key : page_blocks[page]) {
+            blocks.erase(key);
+        }
+        page_blocks[page].clear();
+        generation++;
+        if (page_invalidations[page] < 0xFF) page_invalidations[page]++;
+    });
+}
+
+template <typename BusT>
+void BlockCache<BusT>::Clear() {
+    blocks.clear();
+    generation++;
+    for (auto& keys : page_blocks) {
+        keys.clear();
+    }
+}
+
+template <typename BusT>
+void BlockCache<BusT>::ClearNative() {
+    for (auto& [key, block] : blocks) {
+        block.native = nullptr;
+        block.executions = 0;
+    }
+}
+
+template class BlockCache<Bus>;
+template class BlockCache<FlatBus>;
@@ -0,0 +1,97 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#ifndef BLOCK_CACHE_H
+#define BLOCK_CACHE_H
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "bus.h"
+
+// One predecoded instruction
+struct DecodedInstruction {
+    uint32_t address;   // 24-bit address of the opcode
+    uint32_t operand;   // Operand bytes, little endian
+    uint8_t opcode;
+    uint8_t length;     // Opcode + operand bytes
+    uint8_t cycles;     // Fewest it can take, see InstructionCycles
+};
+
+// Compiled form of a block, see jit.h. Runs at most `limit` instructions and returns how many it ran.
+using NativeBlockFunction = uint32_t (*)(void* cpu, uint32_t limit);
+
+// Straight-line run of instructions that ends at the first branch, jump,
+// return or M/X/E change. Only valid for the flag state it was decoded under.
+struct BasicBlock {
+    uint32_t start;
+    uint32_t end;       // Address just past the last instruction
+    std::vector<DecodedInstruction> instructions;
+    bool self_modifying = false;    // Decoded from a WRAM page that has been rewritten before
+    uint32_t cycles = 0;            // Fewest cycles the whole block can take
+    uint32_t max_cycles = 0;        // Most, or kVariableCycles if that depends on the deadline
+
+    // Blocks execution went on to from here, so following them skips the hash lookup. A link only
+    // holds while the cache hasn't dropped any block since it was made.
+    struct Link {
+        BasicBlock* block = nullptr;
+        uint32_t key = 0;
+        uint64_t generation = 0;
+    };
+    Link links[2];
+
+    // JIT state
+    uint32_t executions = 0;
+    bool jit_rejected = false;
+    NativeBlockFunction native = nullptr;
+};
+
+// Cache of basic blocks keyed by (PB:PC, M, X, E). Instantiated in block_cache.cpp for Bus and FlatBus.
+template <typename BusT>
+class BlockCache {
+    static constexpr size_t kMaxBlockInstructions = 32;
+    static constexpr size_t kWRAMPageCount = 0x20000 / 0x100;
+
+    BusT* bus;
+    std::unordered_map<uint32_t, BasicBlock> blocks;
+    std::vector<uint32_t> page_blocks[kWRAMPageCount]; // Keys of blocks decoded from each WRAM page
+    uint8_t page_invalidations[kWRAMPageCount] = {};   // Saturating count of code writes per WRAM page
+    uint64_t generation = 1;                            // Bumped whenever blocks are dropped
+
+    static uint32_t MakeKey(uint32_t address, bool m_8bit, bool x_8bit, bool emulation) {
+        return (address & 0xFFFFFF) | (m_8bit ? 1u << 24 : 0) | (x_8bit ? 1u << 25 : 0) | (emulation ? 1u << 26 : 0);
+    }
+
+    BasicBlock* Decode(uint32_t key, uint32_t address, bool m_8bit, bool x_8bit);
+    BasicBlock* LinkNext(BasicBlock& from, uint32_t key);
+
+public:
+    explicit BlockCache(BusT* memory_bus) : bus(memory_bus) {}
+
+    // Returns nullptr if code at this address can't be cached (e.g. it runs from I/O space)
+    BasicBlock* Lookup(uint32_t address, bool m_8bit, bool x_8bit, bool emulation);
+    // Lookup for the block execution went on to after `from`, through from's links
+    BasicBlock* Next(BasicBlock& from, const uint32_t address, const bool m_8bit, const bool x_8bit,
+                     const bool emulation) {
+        const uint32_t key = MakeKey(address, m_8bit, x_8bit, emulation);
+        for (const BasicBlock::Link& link : from.links) {
+            if (link.key == key && link.generation == generation) return link.block;
+        }
+        return LinkNext(from, key);
+    }
+
+    // Drops blocks decoded from WRAM pages the bus has seen written since the last call
+    void InvalidateWrittenCode();
+    void Clear();
+    // Forgets every block's compiled code, for when the JIT starts its code buffer over
+    void ClearNative();
+
+    [[nodiscard]] size_t Size() const { return blocks.size(); }
+};
+
+class FlatBus;
+extern template class BlockCache<Bus>;
+extern template class BlockCache<FlatBus>;
+
+#endif //BLOCK_CACHE_H
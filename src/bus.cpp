@@ -4,29 +4,75 @@
 
 #include "bus.h"
 
+#include <cstring>
+
+#include "controllers.h"
+#include "interrupts.h"
+#include "ppu.h"
+
 // Bus class
 uint8_t Bus::Read(uint32_t address) {
     // TODO: Map properly based on SNES memory map
     if (address < 0x2000) {
-        return wram[address];
+        return memory->wram[address];
     } else if (address >= 0x7E0000 && address < 0x800000) {
-        return wram[address - 0x7E0000];
-    } else if (address >= 0x800000 && cartridge) {
-        // ROM access
-        if (const uint32_t rom_addr = address & 0x7FFFFF; rom_addr < cartridge->size()) {
-            return (*cartridge)[rom_addr];
+        return memory->wram[address - 0x7E0000];
+    } else if (IsIOAddress(address)) {
+        const uint16_t offset = address & 0xFFFF;
+        if (offset >= 0x4210 && offset <= 0x4212) return interrupts ? interrupts->Read(offset) : 0x00;
+        side_effect_reads++;
+        if (ppu && offset >= 0x2100 && offset <= 0x213F) return ppu->ReadRegister(offset);
+        if (controllers && (offset == 0x4016 || offset == 0x4017 || (offset >= 0x4218 && offset <= 0x421F))) {
+            return controllers->Read(offset);
         }
+    } else if (const int64_t rom_offset = ROMOffset(address); rom_offset >= 0) {
+        return (*cartridge)[rom_offset];
     }
     return 0x00; // Open bus
 }
 
 void Bus::Write(uint32_t address, uint8_t value) {
     if (address < 0x2000) {
-        wram[address] = value;
+        WriteWRAM(address, value);
     } else if (address >= 0x7E0000 && address < 0x800000) {
-        wram[address - 0x7E0000] = value;
+        WriteWRAM(address - 0x7E0000, value);
+    } else if (IsIOAddress(address)) {
+        const uint16_t offset = address & 0xFFFF;
+        if (ppu && offset >= 0x2100 && offset <= 0x213F) {
+            ppu->WriteRegister(offset, value);
+        } else if (interrupts && (offset == 0x4200 || (offset >= 0x4207 && offset <= 0x420A))) {
+            interrupts->Write(offset, value);
+        } else if (controllers && offset == 0x4016) {
+            controllers->Write(offset, value);
+        }
+    }
+    // TODO: Add APU register writes here
+}
+
+void Bus::WriteWRAM(const uint32_t offset, const uint8_t value) {
+    memory->wram[offset] = value;
+    wram_dirty.Mark(offset);
+
+    if (code_pages.IsDirtyAddress(offset)) {
+        // Self-modifying code: the CPU has to drop blocks predecoded from this page
+        code_pages.ClearPage(offset / decltype(code_pages)::kPageSize);
+        written_code_pages.Mark(offset);
+        code_written = true;
+    }
+}
+
+// Bookkeeping for WRAM written behind WriteWRAM's back
+void Bus::NoteWRAMWrite(const uint32_t offset, const uint32_t length) {
+    wram_dirty.MarkRange(offset, length);
+
+    constexpr uint32_t page_size = decltype(code_pages)::kPageSize;
+    for (uint32_t page = offset / page_size; page <= (offset + length - 1) / page_size; page++) {
+        if (code_pages.IsDirty(page)) {
+            code_pages.ClearPage(page);
+            written_code_pages.Mark(page * page_size);
+            code_written = true;
+        }
     }
-    // TODO: Add PPU/APU register writes here
 }
 
 uint16_t Bus::Read16(uint32_t address) {
@@ -37,3 +83,68 @@ void Bus::Write16(uint32_t address, uint16_t value) {
     Write(address, value & 0xFF);
     Write(address + 1, (value >> 8) & 0xFF);
 }
+
+bool Bus::IsPlainMemory(const uint32_t address) const {
+    return WRAMOffset(address) >= 0 || ROMOffset(address) >= 0;
+}
+
+// ROM is mapped linearly from bank $80, and the upper half of banks $00-$3F mirrors banks $80-$BF
+int64_t Bus::ROMOffset(uint32_t address) const {
+    if (address < 0x400000 && (address & 0x8000)) address |= 0x800000;
+    if (address < 0x800000 || IsIOAddress(address) || !cartridge) return -1;
+
+    const uint32_t offset = address & 0x7FFFFF;
+    return offset < cartridge->size() ? static_cast<int64_t>(offset) : -1;
+}
+
+int32_t Bus::WRAMOffset(const uint32_t address) {
+    if (address < 0x2000) return static_cast<int32_t>(address);
+    if (address >= 0x7E0000 && address < 0x800000) return static_cast<int32_t>(address - 0x7E0000);
+    return -1;
+}
+
+const uint8_t* Bus::PlainMemory(const uint32_t address, const uint32_t length) const {
+    if (const int32_t offset = WRAMOffset(address); offset >= 0) {
+        // The low mirror ends at $2000, so both ends have to map into the same contiguous run
+        if (WRAMOffset(address + length - 1) != offset + static_cast<int32_t>(length) - 1) return nullptr;
+        return memory->wram + offset;
+    }
+    if (const int64_t offset = ROMOffset(address); offset >= 0) {
+        if (ROMOffset(address + length - 1) != offset + length - 1) return nullptr;
+        return cartridge->data() + offset;
+    }
+    return nullptr;
+}
+
+bool Bus::CopyBlock(const uint32_t dest, const uint32_t src, const uint32_t count, const bool decrement) {
+    const uint32_t dest_low = decrement ? dest - (count - 1) : dest;
+    const uint32_t src_low = decrement ? src - (count - 1) : src;
+
+    const int32_t dest_offset = WRAMOffset(dest_low);
+    const uint8_t* source = PlainMemory(src_low, count);
+    if (dest_offset < 0 || !source || !PlainMemory(dest_low, count)) return false;
+    uint8_t* destination = memory->wram + dest_offset;
+
+    // The CPU moves one byte at a time, so a destination that overlaps ahead of the
+    // source repeats bytes instead of shifting the block like memmove would
+    if (!decrement && destination > source && destination < source + count) {
+        for (uint32_t i = 0; i < count; i++) {
+            destination[i] = source[i];
+        }
+    } else if (decrement && destination < source && destination + count > source) {
+        for (uint32_t i = count; i-- > 0;) {
+            destination[i] = source[i];
+        }
+    } else {
+        std::memmove(destination, source, count);
+    }
+
+    NoteWRAMWrite(dest_offset, count);
+    return true;
+}
+
+void Bus::MarkCodePage(const uint32_t address) {
+    if (const int32_t offset = WRAMOffset(address); offset >= 0) {
+        code_pages.Mark(offset);
+    }
+}
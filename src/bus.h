@@ -8,23 +8,112 @@
 #include <cstdint>
 #include <vector>
 
+#include "dirty_pages.h"
+#include "memory_arena.h"
+#include "save_state.h"
+
+class Controllers;
+class InterruptController;
+class PPU;
+
 // Memory Bus - handles memory mapping
-class Bus {
+class alignas(64) Bus {
+public:
+    struct Memory {
+        uint8_t wram[0x20000];      // 128KB Work RAM
+        uint8_t sram[0x8000];       // 32KB Save RAM
+    };
+
 private:
-    uint8_t wram[0x20000];      // 128KB Work RAM
-    uint8_t sram[0x8000];       // 32KB Save RAM
+    BulkMemory<Memory> memory;
     std::vector<uint8_t>* cartridge; // Cartridge Data
+    InterruptController* interrupts = nullptr;
+    PPU* ppu = nullptr;
+    Controllers* controllers = nullptr;
+
+    DirtyPageMap<sizeof(Memory::wram)> wram_dirty;
+
+    // WRAM pages that predecoded CPU blocks were built from
+    DirtyPageMap<sizeof(Memory::wram)> code_pages;
+    DirtyPageMap<sizeof(Memory::wram)> written_code_pages;
+    bool code_written = false;
+    uint64_t side_effect_reads = 0;
+
+    void WriteWRAM(uint32_t offset, uint8_t value);
+    void NoteWRAMWrite(uint32_t offset, uint32_t length);
+
+    // Host pointer to `length` bytes of WRAM/ROM starting at a CPU address, or nullptr
+    const uint8_t* PlainMemory(uint32_t address, uint32_t length) const;
+
+    // Cartridge offset for a CPU address, or -1 if it isn't ROM
+    [[nodiscard]] int64_t ROMOffset(uint32_t address) const;
+
+    // $2000-$7FFF in banks $00-$3F and $80-$BF
+    static bool IsIOAddress(uint32_t address) {
+        const uint16_t offset = address & 0xFFFF;
+        return !(address & 0x400000) && offset >= 0x2000 && offset < 0x8000;
+    }
 
 public:
-    Bus(std::vector<uint8_t>* cart) : cartridge(cart) {
-        std::fill(wram, wram + sizeof(wram), 0);
-        std::fill(sram, sram + sizeof(sram), 0);
+    // Without a block of the System's arena, the bus allocates its own memory
+    explicit Bus(std::vector<uint8_t>* cart, Memory* block = nullptr) : memory(block), cartridge(cart) {
+        ClearMemory();
+    }
+
+    // WRAM and SRAM as at power-on. A reset leaves both alone.
+    void ClearMemory() {
+        std::fill(memory->wram, memory->wram + sizeof(Memory::wram), 0);
+        std::fill(memory->sram, memory->sram + sizeof(Memory::sram), 0);
+        wram_dirty.MarkAll();
+    }
+
+    void SaveState(StateWriter& writer) const {
+        writer.WriteBytes(memory->wram, sizeof(Memory::wram));
+        writer.WriteBytes(memory->sram, sizeof(Memory::sram));
     }
+    void LoadState(StateReader& reader) {
+        reader.ReadBytes(memory->wram, sizeof(Memory::wram));
+        reader.ReadBytes(memory->sram, sizeof(Memory::sram));
+        wram_dirty.MarkAll();
+    }
+
+    void ConnectInterrupts(InterruptController* controller) { interrupts = controller; }
+    void ConnectPPU(PPU* connected_ppu) { ppu = connected_ppu; }
+    void ConnectControllers(Controllers* connected_controllers) { controllers = connected_controllers; }
 
     uint8_t Read(uint32_t address);
     void Write(uint32_t address, uint8_t value);
     uint16_t Read16(uint32_t address);
     void Write16(uint32_t address, uint16_t value);
+
+    // Incremental snapshot support
+    [[nodiscard]] const uint8_t* GetWRAM() const { return memory->wram; }
+    DirtyPageMap<sizeof(Memory::wram)>& GetWRAMDirtyPages() { return wram_dirty; }
+
+    // True for WRAM and ROM, where reads have no side effects
+    [[nodiscard]] bool IsPlainMemory(uint32_t address) const;
+    // I/O reads so far that may have changed something: every register but the interrupt status
+    // ones at $4210-$4212, which only report state. Idle loops can't be skipped past these.
+    [[nodiscard]] uint64_t GetSideEffectReads() const { return side_effect_reads; }
+
+    // WRAM offset for a CPU address, or -1 if the address isn't WRAM
+    static int32_t WRAMOffset(uint32_t address);
+
+    // MVN/MVP bulk copy of `count` bytes, walking up from dest/src or (decrement) down from them.
+    // Returns false without copying anything unless the source is plain memory and the
+    // destination is WRAM, in which case the caller has to fall back to single bytes.
+    bool CopyBlock(uint32_t dest, uint32_t src, uint32_t count, bool decrement);
+
+    // Code tracking for the CPU block cache
+    void MarkCodePage(uint32_t address);
+    [[nodiscard]] bool HasCodeWrites() const { return code_written; }
+
+    template <typename Fn>
+    void TakeWrittenCodePages(Fn&& fn) {
+        written_code_pages.ForEachDirty(fn);
+        written_code_pages.Clear();
+        code_written = false;
+    }
 };
 
 #endif //BUS_H
@@ -0,0 +1,199 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+// The C API in include/breadedsnes.h, on top of BatchRunner. Everything per environment, from
+// the frames to writing its slice of the observation buffer, runs on the environment's own thread.
+
+#include "breadedsnes.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "batch_runner.h"
+
+struct breaded_batch {
+    BatchRunner runner;
+    breaded_observation observation;
+    size_t observation_size;
+    std::unique_ptr<uint8_t[]> observations;
+    std::vector<uint8_t> reset_state;   // Empty: reset powers on
+
+    breaded_batch(const uint32_t environments, const uint32_t threads, const breaded_observation format)
+        : runner(environments, threads), observation(format),
+          observation_size(static_cast<size_t>(BREADED_OBSERVATION_WIDTH) * BREADED_OBSERVATION_HEIGHT * format) {
+        if (!observation_size) return;
+        // Left uninitialized here so each environment's thread is the first to touch its slice
+        observations = std::make_unique_for_overwrite<uint8_t[]>(environments * observation_size);
+        runner.ForEach([this](const uint32_t environment, System&) {
+            std::fill_n(Observation(environment), observation_size, 0);
+        });
+    }
+
+    uint8_t* Observation(const uint32_t environment) const {
+        return observations.get() + environment * observation_size;
+    }
+
+    // Frames drawn from here on show up in GetFramebuffer, unless the batch has no observations
+    void RunFrames(System& system, const uint32_t frames) const {
+        if (!frames) return;
+        system.SkipNextFrames(observation == BREADED_OBSERVATION_NONE ? frames : frames - 1);
+        for (uint32_t frame = 0; frame < frames; frame++) system.RunFrame();
+    }
+
+    void WriteObservation(const uint32_t environment, const System& system) const {
+        if (observation == BREADED_OBSERVATION_NONE) return;
+        const uint32_t* frame = system.GetFramebuffer();
+        const uint32_t width = system.GetFrameWidth(), height = system.GetFrameHeight();
+        const uint32_t column_step = width / BREADED_OBSERVATION_WIDTH;
+        const uint32_t row_step = height > PPU::kMaxScreenHeight ? 2 : 1;
+        uint8_t* out = Observation(environment);
+
+        for (uint32_t y = 0; y < BREADED_OBSERVATION_HEIGHT; y++) {
+            if (y * row_step >= height) {
+                std::fill(out, Observation(environment) + observation_size, 0);
+                return;
+            }
+            const uint32_t* row = frame + y * row_step * width;
+            if (observation == BREADED_OBSERVATION_GRAY) {
+                for (uint32_t x = 0; x < BREADED_OBSERVATION_WIDTH; x++) {
+                    const uint32_t pixel = row[x * column_step];
+                    // BT.601 weights in 8-bit fixed point
+                    *out++ = static_cast<uint8_t>((((pixel >> 16) & 0xFF) * 77 + ((pixel >> 8) & 0xFF) * 150 +
+                                                   (pixel & 0xFF) * 29) >> 8);
+                }
+            } else {
+                for (uint32_t x = 0; x < BREADED_OBSERVATION_WIDTH; x++) {
+                    const uint32_t pixel = row[x * column_step];
+                    *out++ = static_cast<uint8_t>(pixel >> 16);
+                    *out++ = static_cast<uint8_t>(pixel >> 8);
+                    *out++ = static_cast<uint8_t>(pixel);
+                }
+            }
+        }
+    }
+};
+
+extern "C" {
+
+breaded_batch* breaded_create(const uint32_t environments, uint32_t threads, const breaded_observation observation) {
+    if (!environments) return nullptr;
+    if (observation != BREADED_OBSERVATION_NONE && observation != BREADED_OBSERVATION_GRAY &&
+        observation != BREADED_OBSERVATION_RGB) {
+        return nullptr;
+    }
+    if (!threads) threads = std::max(std::thread::hardware_concurrency(), 1u);
+    try {
+        return new breaded_batch(environments, std::min(threads, environments), observation);
+    } catch (const std::exception& e) {
+        std::cout << "Failed to create " << environments << " environments: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+void breaded_destroy(breaded_batch* batch) {
+    delete batch;
+}
+
+bool breaded_load_rom(breaded_batch* batch, const char* path) {
+    if (!batch->runner.LoadROM(path)) return false;
+    batch->reset_state.clear();
+    return true;
+}
+
+void breaded_load_rom_data(breaded_batch* batch, const void* data, const size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    batch->runner.LoadROM(std::vector<uint8_t>(bytes, bytes + size));
+    batch->reset_state.clear();
+}
+
+void breaded_set_cpu(breaded_batch* batch, const breaded_cpu cpu) {
+    const CPUBackend backend = cpu == BREADED_CPU_INTERPRETER ? CPUBackend::Interpreter
+                               : cpu == BREADED_CPU_JIT       ? CPUBackend::JIT
+                                                              : CPUBackend::BlockCache;
+    batch->runner.ForEach([backend](uint32_t, System& system) { system.SetCPUBackend(backend); });
+}
+
+uint32_t breaded_environments(const breaded_batch* batch) {
+    return batch->runner.GetInstanceCount();
+}
+
+bool breaded_set_reset_state(breaded_batch* batch, const void* state, const size_t size) {
+    if (!state) {
+        batch->reset_state.clear();
+        return true;
+    }
+    // Tried on the first environment, which then goes back to where it was
+    const auto* bytes = static_cast<const uint8_t*>(state);
+    std::vector<uint8_t> original;
+    batch->runner.GetSystem(0).SaveState(original);
+    if (!batch->runner.GetSystem(0).LoadState(bytes, size)) return false;
+    batch->runner.GetSystem(0).LoadState(original.data(), original.size());
+    batch->reset_state.assign(bytes, bytes + size);
+    return true;
+}
+
+void breaded_reset(breaded_batch* batch, const uint8_t* mask) {
+    batch->runner.ForEach([batch, mask](const uint32_t environment, System& system) {
+        if (mask && !mask[environment]) return;
+        if (batch->reset_state.empty() ||
+            !system.LoadState(batch->reset_state.data(), batch->reset_state.size())) {
+            system.PowerOn();
+        }
+        for (uint32_t port = 0; port < BREADED_PORTS; port++) system.SetButtons(port, 0);
+        batch->RunFrames(system, 1);
+        batch->WriteObservation(environment, system);
+    });
+}
+
+void breaded_step(breaded_batch* batch, const uint16_t* actions, const uint32_t frames) {
+    batch->runner.ForEach([batch, actions, frames](const uint32_t environment, System& system) {
+        for (uint32_t port = 0; port < BREADED_PORTS; port++) {
+            system.SetButtons(port, actions ? actions[environment * BREADED_PORTS + port] : 0);
+        }
+        batch->RunFrames(system, frames);
+        batch->WriteObservation(environment, system);
+    });
+}
+
+const uint8_t* breaded_observations(const breaded_batch* batch) {
+    return batch->observations.get();
+}
+
+size_t breaded_observation_size(const breaded_batch* batch) {
+    return batch->observation_size;
+}
+
+const uint32_t* breaded_framebuffer(breaded_batch* batch, const uint32_t environment, uint32_t* width,
+                                    uint32_t* height) {
+    if (environment >= batch->runner.GetInstanceCount()) return nullptr;
+    const System& system = batch->runner.GetSystem(environment);
+    if (width) *width = system.GetFrameWidth();
+    if (height) *height = system.GetFrameHeight();
+    return system.GetFramebuffer();
+}
+
+const uint8_t* breaded_wram(breaded_batch* batch, const uint32_t environment) {
+    if (environment >= batch->runner.GetInstanceCount()) return nullptr;
+    return batch->runner.GetSystem(environment).GetWRAM();
+}
+
+size_t breaded_save_state(breaded_batch* batch, const uint32_t environment, void* buffer, const size_t capacity) {
+    if (environment >= batch->runner.GetInstanceCount()) return 0;
+    std::vector<uint8_t> state;
+    batch->runner.GetSystem(environment).SaveState(state);
+    if (state.size() <= capacity) std::memcpy(buffer, state.data(), state.size());
+    return state.size();
+}
+
+bool breaded_load_state(breaded_batch* batch, const uint32_t environment, const void* state, const size_t size) {
+    if (environment >= batch->runner.GetInstanceCount()) return false;
+    return batch->runner.GetSystem(environment).LoadState(static_cast<const uint8_t*>(state), size);
+}
+
+} // extern "C"
@@ -0,0 +1,86 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#include "controllers.h"
+
+void Controllers::Reset() {
+    for (uint32_t port = 0; port < kPorts; port++) {
+        auto_read[port] = 0;
+        shift[port] = 0;
+    }
+    strobe = false;
+    frame_input = {};
+    frame_input_taken = false;
+}
+
+// The front end's live button state isn't part of a save state, only what the game has latched
+void Controllers::SaveState(StateWriter& writer) const {
+    writer.Write(auto_read);
+    writer.Write(shift);
+    writer.Write(strobe);
+    writer.Write(frame_input);
+    writer.Write(frame_input_taken);
+}
+
+void Controllers::LoadState(StateReader& reader) {
+    reader.Read(auto_read);
+    reader.Read(shift);
+    reader.Read(strobe);
+    reader.Read(frame_input);
+    reader.Read(frame_input_taken);
+}
+
+Controllers::FrameInput Controllers::TakeFrameInput() {
+    if (!frame_input_taken) {
+        if (poll) poll();
+        for (uint32_t port = 0; port < kPorts; port++) {
+            frame_input[port] = buttons[port].load(std::memory_order_acquire);
+        }
+        frame_input_taken = true;
+    }
+    return frame_input;
+}
+
+void Controllers::Latch() {
+    const FrameInput input = TakeFrameInput();
+    for (uint32_t port = 0; port < kPorts; port++) shift[port] = input[port];
+}
+
+uint8_t Controllers::Read(const uint16_t address) {
+    switch (address) {
+        case 0x4016:    // JOYSER0
+        case 0x4017: {  // JOYSER1, bits 2-4 are tied high
+            // While the strobe is held the pads keep reloading, so reads return B. Once all 16
+            // bits are out, standard pads return 1s.
+            uint16_t& bits = shift[address - 0x4016];
+            if (strobe) Latch();
+            const uint8_t data = bits >> 15;
+            if (!strobe) bits = static_cast<uint16_t>((bits << 1) | 1);
+            return address == 0x4017 ? 0x1C | data : data;
+        }
+        case 0x4218: return auto_read[0] & 0xFF;    // JOY1L
+        case 0x4219: return auto_read[0] >> 8;      // JOY1H
+        case 0x421A: return auto_read[1] & 0xFF;    // JOY2L
+        case 0x421B: return auto_read[1] >> 8;      // JOY2H
+        default:
+            return 0x00;    // JOY3/JOY4: no multitap
+    }
+}
+
+void Controllers::Write(const uint16_t address, const uint8_t value) {
+    if (address != 0x4016) return;     // JOYOUT
+    const bool was_strobed = strobe;
+    strobe = value & 0x01;
+    if (was_strobed && !strobe) Latch();
+}
+
+// The hardware strobes the pads and clocks all 16 bits into JOY1/JOY2, leaving the shift
+// registers empty
+void Controllers::OnAutoJoypadRead() {
+    Latch();
+    for (uint32_t port = 0; port < kPorts; port++) {
+        auto_read[port] = shift[port];
+        shift[port] = 0xFFFF;
+    }
+}
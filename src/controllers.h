@@ -0,0 +1,76 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#ifndef CONTROLLERS_H
+#define CONTROLLERS_H
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "save_state.h"
+
+// Standard pads in both ports: $4016/$4017 serial reads, and the $4218-$421F results of the
+// auto-joypad read. The front end hands over button state through SetButtons from any thread;
+// it's only picked up when the game latches the pads.
+//
+// Input is sampled once a frame, at the first latch, and every later latch in the frame sees the
+// same state. That keeps a frame's input down to one value per port, which movies record and
+// replay (see movie.h).
+class Controllers {
+public:
+    static constexpr uint32_t kPorts = 2;
+
+    // Button bits in the order the pad shifts them out, B first. $4219/$4218 read them as a word.
+    enum Button : uint16_t {
+        B = 0x8000, Y = 0x4000, Select = 0x2000, Start = 0x1000,
+        Up = 0x0800, Down = 0x0400, Left = 0x0200, Right = 0x0100,
+        A = 0x0080, X = 0x0040, L = 0x0020, R = 0x0010,
+    };
+
+    using FrameInput = std::array<uint16_t, kPorts>;
+
+private:
+    std::atomic<uint16_t> buttons[kPorts] = {};     // Latest state from the front end
+    std::function<void()> poll;
+
+    uint16_t auto_read[kPorts] = {};    // $4218-$421B
+    uint16_t shift[kPorts] = {};        // Serial shift registers
+    bool strobe = false;                // $4016 bit 0
+
+    FrameInput frame_input = {};        // What this frame's latches load
+    bool frame_input_taken = false;
+
+    void Latch();
+
+public:
+    void Reset();
+    void SaveState(StateWriter& writer) const;
+    void LoadState(StateReader& reader);
+
+    // Safe to call from any thread
+    void SetButtons(uint32_t port, uint16_t state) { buttons[port].store(state, std::memory_order_release); }
+    // Called on the emulation thread right before the pads are latched, so a front end on the
+    // same thread can pump its events as late as possible
+    void SetPoll(std::function<void()> callback) { poll = std::move(callback); }
+
+    uint8_t Read(uint16_t address);
+    void Write(uint16_t address, uint8_t value);
+
+    // Auto-joypad read at the start of VBlank
+    void OnAutoJoypadRead();
+
+    // Called by System at the start of each frame, so the next latch samples fresh input
+    void BeginFrame() { frame_input_taken = false; }
+    // The input this frame latched, sampling it now if the game hasn't latched yet
+    FrameInput TakeFrameInput();
+    // Fixes this frame's input, for movie playback. SetButtons and the poll hook have no effect
+    // until the next frame.
+    void SetFrameInput(const FrameInput& input) {
+        frame_input = input;
+        frame_input_taken = true;
+    }
+};
+
+#endif //CONTROLLERS_H
@@ -4,105 +4,577 @@
 
 #include "cpu.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <tuple>
+#include <utility>
+
+#include "flat_bus.h"
+#include "opcodes.h"
+#ifdef BREADEDSNES_TRACE
+#include "trace.h"
+#endif
+#ifdef BREADEDSNES_PROFILE
+#include "profiler.h"
+#endif
 
 // CPU Implementation
-void CPU::Reset() {
+template <typename BusT>
+void BasicCPU<BusT>::Reset() {
     A = D = X = Y = 0;
     SP = 0x01FF;    // Start of page 1
     PC = ReadWord(0x00FFFC);
-    P = 0x34;     // Start in emulation mode
+    SetP(0x34);   // Start in emulation mode
     DB = PB = 0;
     cycles = 0;
+    stopped = false;
+    waiting_for_interrupt = false;
+    nmi_pending = false;
+    irq_line = false;
+
+    block_cache.Clear();
+    jit.Reset();
+    current_block = nullptr;
+    idle_tracking = false;
+    idle_loop_cycles = 0;
 }
 
-void CPU::Step() {
-    if (!stopped) ExecuteInstruction();
+template <typename BusT>
+void BasicCPU<BusT>::Step() {
+    // Halted by STP or WAI; the system lets time pass until reset or an interrupt
+    if (stopped || waiting_for_interrupt) return;
+
+    if (nmi_pending) {
+        nmi_pending = false;
+        ServiceInterrupt(0xFFEA, 0xFFFA);
+        return;
+    }
+    if (irq_line && !(P & FLAG_I)) {
+        ServiceInterrupt(0xFFEE, 0xFFFE);
+        return;
+    }
+
+    if (backend == CPUBackend::Interpreter) {
+        ExecuteInstruction();
+    } else {
+        ExecuteCachedInstruction();
+    }
+}
+
+template <typename BusT>
+void BasicCPU<BusT>::Run() {
+    // Whatever ended the last run may have changed what a loop reads, so it has to come round
+    // unchanged again after this point before it counts as idle
+    idle_tracking = false;
+    while (cycles < cycle_deadline && !IsIdle()) {
+        if (backend != CPUBackend::Interpreter && !InterruptPending()) {
+            RunBlocks();
+        } else {
+            Step();
+        }
+    }
+}
+
+template <typename BusT>
+void BasicCPU<BusT>::SetBackend(CPUBackend new_backend) {
+    if (new_backend == CPUBackend::JIT && !JIT::IsSupported()) {
+        std::cout << "JIT is not supported on this platform, using the block cache" << std::endl;
+        new_backend = CPUBackend::BlockCache;
+    }
+
+    backend = new_backend;
+    block_cache.Clear();
+    jit.Reset();
+    current_block = nullptr;
+}
+
+template <typename BusT>
+typename BasicCPU<BusT>::State BasicCPU<BusT>::GetState() const {
+    return {A, X, Y, SP, D, PC, GetP(), DB, PB, emulation_mode, stopped, waiting_for_interrupt, cycles};
+}
+
+template <typename BusT>
+void BasicCPU<BusT>::SetState(const State& state) {
+    A = state.A;
+    X = state.X;
+    Y = state.Y;
+    SP = state.SP;
+    D = state.D;
+    PC = state.PC;
+    SetP(state.P);
+    DB = state.DB;
+    PB = state.PB;
+    emulation_mode = state.emulation_mode;
+    stopped = state.stopped;
+    waiting_for_interrupt = state.waiting_for_interrupt;
+    cycles = state.cycles;
+    current_block = nullptr;
+    idle_tracking = false;
+    idle_loop_cycles = 0;
+}
+
+template <typename BusT>
+void BasicCPU<BusT>::SaveState(StateWriter& writer) const {
+    const State state = GetState();
+    writer.Write(state.A);
+    writer.Write(state.X);
+    writer.Write(state.Y);
+    writer.Write(state.SP);
+    writer.Write(state.D);
+    writer.Write(state.PC);
+    writer.Write(state.P);
+    writer.Write(state.DB);
+    writer.Write(state.PB);
+    writer.Write(state.emulation_mode);
+    writer.Write(state.stopped);
+    writer.Write(state.waiting_for_interrupt);
+    writer.Write(state.cycles);
+    writer.Write(nmi_pending);
+}
+
+template <typename BusT>
+void BasicCPU<BusT>::LoadState(StateReader& reader) {
+    State state = GetState();
+    bool nmi = false;
+    reader.Read(state.A);
+    reader.Read(state.X);
+    reader.Read(state.Y);
+    reader.Read(state.SP);
+    reader.Read(state.D);
+    reader.Read(state.PC);
+    reader.Read(state.P);
+    reader.Read(state.DB);
+    reader.Read(state.PB);
+    reader.Read(state.emulation_mode);
+    reader.Read(state.stopped);
+    reader.Read(state.waiting_for_interrupt);
+    reader.Read(state.cycles);
+    reader.Read(nmi);
+    SetState(state);
+    nmi_pending = nmi;
+
+    block_cache.Clear();
+    jit.Reset();
+}
+
+template <typename BusT>
+void BasicCPU<BusT>::SkipIdleCycles(const uint64_t count) {
+#ifdef BREADEDSNES_PROFILE
+    const uint64_t start_cycles = cycles;
+#endif
+    if (idle_loop_cycles && !stopped && !waiting_for_interrupt) {
+        cycles += count / idle_loop_cycles * idle_loop_cycles;
+        idle_loop_cycles = 0;
+    } else {
+        cycles += count;
+    }
+
+#ifdef BREADEDSNES_PROFILE
+    if (profiler) [[unlikely]] profiler->RecordIdle(PC, cycles - start_cycles);
+#endif
+}
+
+template <typename BusT>
+void BasicCPU<BusT>::RaiseNMI() {
+    nmi_pending = true;
+    waiting_for_interrupt = false;
+    idle_tracking = false;
+    idle_loop_cycles = 0;
+}
+
+template <typename BusT>
+void BasicCPU<BusT>::SetIRQLine(const bool asserted) {
+    irq_line = asserted;
+    if (asserted) {
+        waiting_for_interrupt = false;
+        idle_tracking = false;
+        idle_loop_cycles = 0;
+    }
+}
+
+// Pushes the return state and jumps through the NMI/IRQ vector, like BRK without the signature byte
+template <typename BusT>
+void BasicCPU<BusT>::ServiceInterrupt(const uint16_t native_vector, const uint16_t emulation_vector) {
+    if (!emulation_mode) {
+        PushByte(PB);
+        PushWord(PC);
+        PushByte(GetP());
+        PC = ReadWord(native_vector);
+    } else {
+        PushWord(PC);
+        PushByte(GetP() & ~0x10);
+        PC = ReadWord(emulation_vector);
+    }
+    cycles += 2;
+
+    P |= FLAG_I;
+    P &= ~FLAG_D;
+    PB = 0;
+    // The pushes may have landed on cached code
+    InvalidateWrittenCode();
+}
+
+// Throws away cached blocks whose code has been written over, before anything runs from them
+template <typename BusT>
+void BasicCPU<BusT>::InvalidateWrittenCode() {
+    if (!bus->HasCodeWrites()) [[likely]] return;
+    block_cache.InvalidateWrittenCode();
+    current_block = nullptr;
+}
+
+// Called after every taken branch or jump, by every backend
+template <typename BusT>
+void BasicCPU<BusT>::CheckIdleLoop() {
+    State state = GetState();
+    const uint64_t iteration = cycles - idle_state.cycles;
+    state.cycles = idle_state.cycles;
+    const uint64_t side_effect_reads = bus->GetSideEffectReads();
+    if (idle_tracking && memory_writes == idle_writes && side_effect_reads == idle_reads &&
+        iteration <= kMaxIdleLoopCycles && state == idle_state) {
+        idle_loop_cycles = iteration;
+    }
+
+    state.cycles = cycles;
+    idle_state = state;
+    idle_writes = memory_writes;
+    idle_reads = side_effect_reads;
+    idle_tracking = true;
+}
+
+// Runs the next instruction out of a predecoded block, decoding a new block
+// when execution leaves the current one
+template <typename BusT>
+void BasicCPU<BusT>::ExecuteCachedInstruction() {
+    InvalidateWrittenCode();
+    if (!current_block || block_position >= current_block->instructions.size() ||
+        current_block->instructions[block_position].address != PC) {
+        current_block = block_cache.Lookup(PC, P & FLAG_M, P & FLAG_X, emulation_mode);
+        block_position = 0;
+
+        if (!current_block) {
+            ExecuteInstruction();
+            InvalidateWrittenCode();
+            return;
+        }
+    }
+
+    if (backend == CPUBackend::JIT && block_position == 0 && RunNativeBlock(*current_block, 1)) {
+        block_position = 1;
+    } else {
+        ExecuteDecoded(current_block->instructions[block_position++]);
+    }
+    InvalidateWrittenCode();
+}
+
+template <typename BusT>
+void BasicCPU<BusT>::ExecuteDecoded(const DecodedInstruction& instruction) {
+    PC++;
+    operand_predecoded = true;
+    predecoded_operand = instruction.operand;
+    ExecuteOpcode(instruction.opcode);
+    operand_predecoded = false;
+}
+
+// Runs predecoded blocks until the deadline, an interrupt, a halt or an idle loop, going from
+// each block to the next through its links. Blocks whose worst case fits before the deadline
+// don't check it after every instruction, and only those are run as native code with the JIT.
+template <typename BusT>
+void BasicCPU<BusT>::RunBlocks() {
+    // DMA and the other bus masters can write over code between runs
+    InvalidateWrittenCode();
+    BasicBlock* block = current_block;
+    size_t position = block_position;
+    if (block && position < block->instructions.size() && block->instructions[position].address != PC) {
+        block = nullptr;
+    }
+
+    operand_predecoded = true;
+    while (cycles < cycle_deadline && !IsIdle() && !InterruptPending()) {
+        if (!block || position == block->instructions.size()) {
+            block = block ? block_cache.Next(*block, PC, P & FLAG_M, P & FLAG_X, emulation_mode)
+                          : block_cache.Lookup(PC, P & FLAG_M, P & FLAG_X, emulation_mode);
+            position = 0;
+            if (!block) {
+                operand_predecoded = false;
+                ExecuteInstruction();
+                operand_predecoded = true;
+                InvalidateWrittenCode();
+                continue;
+            }
+        }
+
+        const size_t count = block->instructions.size();
+        const bool fits = block->max_cycles < cycle_deadline - cycles;
+        if (backend == CPUBackend::JIT && position == 0 && fits) {
+            position = RunNativeBlock(*block, count);
+            if (bus->HasCodeWrites()) [[unlikely]] {
+                block_cache.InvalidateWrittenCode();
+                block = nullptr;
+                continue;
+            }
+            if (position == count) continue;
+        }
+        do {
+            const DecodedInstruction& instruction = block->instructions[position++];
+            PC++;
+            predecoded_operand = instruction.operand;
+            ExecuteOpcode(instruction.opcode);
+
+            if (bus->HasCodeWrites()) [[unlikely]] {
+                block_cache.InvalidateWrittenCode();
+                block = nullptr;
+                break;
+            }
+        } while (position < count && !InterruptPending() && (fits || cycles < cycle_deadline));
+    }
+    operand_predecoded = false;
+
+    current_block = block;
+    block_position = position;
+}
+
+// Where compiled blocks find the registers: offsets from this, which are the same for every CPU
+template <typename BusT>
+JIT::Layout BasicCPU<BusT>::JITLayout() {
+    const auto offset = [this](const void* field) {
+        return static_cast<int32_t>(static_cast<const char*>(field) - reinterpret_cast<const char*>(this));
+    };
+    return {offset(&A), offset(&X), offset(&Y), offset(&D), offset(&PC), offset(&P), offset(&DB), offset(&PB),
+            offset(&flag_n), offset(&flag_z), offset(&flag_c), offset(&flag_v), offset(&cycles),
+            &JITRead8, &JITRead16, &JITWrite8, &JITWrite16, &JITCheckIdleLoop};
+}
+
+// Compiled blocks only touch WRAM and ROM themselves, where nothing depends on the cycle count.
+// Anything else sends them back to the interpreter.
+template <typename BusT>
+uint32_t BasicCPU<BusT>::JITRead8(void* cpu_ptr, const uint32_t address) {
+    const BasicCPU* cpu = static_cast<BasicCPU*>(cpu_ptr);
+    if (!cpu->bus->IsPlainMemory(address)) return JIT::kBail;
+    return cpu->bus->Read(address);
+}
+
+template <typename BusT>
+uint32_t BasicCPU<BusT>::JITRead16(void* cpu_ptr, const uint32_t address) {
+    const BasicCPU* cpu = static_cast<BasicCPU*>(cpu_ptr);
+    if (!cpu->bus->IsPlainMemory(address) || !cpu->bus->IsPlainMemory(address + 1)) return JIT::kBail;
+    return cpu->bus->Read(address) | cpu->bus->Read(address + 1) << 8;
+}
+
+template <typename BusT>
+uint32_t BasicCPU<BusT>::JITWrite8(void* cpu_ptr, const uint32_t address, const uint32_t value) {
+    BasicCPU* cpu = static_cast<BasicCPU*>(cpu_ptr);
+    if (!cpu->bus->IsPlainMemory(address)) return JIT::kBail;
+    if (cpu->jit_verify) [[unlikely]] cpu->jit_journal.emplace_back(address, cpu->bus->Read(address));
+    cpu->WriteByte(address, value);
+    return cpu->bus->HasCodeWrites() ? JIT::kCodeWritten : 0;
+}
+
+template <typename BusT>
+uint32_t BasicCPU<BusT>::JITWrite16(void* cpu_ptr, const uint32_t address, const uint32_t value) {
+    BasicCPU* cpu = static_cast<BasicCPU*>(cpu_ptr);
+    if (!cpu->bus->IsPlainMemory(address) || !cpu->bus->IsPlainMemory(address + 1)) return JIT::kBail;
+    if (cpu->jit_verify) [[unlikely]] {
+        cpu->jit_journal.emplace_back(address, cpu->bus->Read(address));
+        cpu->jit_journal.emplace_back(address + 1, cpu->bus->Read(address + 1));
+    }
+    cpu->WriteWord(address, value);
+    return cpu->bus->HasCodeWrites() ? JIT::kCodeWritten : 0;
+}
+
+template <typename BusT>
+void BasicCPU<BusT>::JITCheckIdleLoop(void* cpu_ptr) {
+    static_cast<BasicCPU*>(cpu_ptr)->CheckIdleLoop();
+}
+
+// Runs up to `limit` instructions of a block as native code, compiling it once it's hot.
+// Returns how many ran; 0 means the block has to be interpreted.
+template <typename BusT>
+uint32_t BasicCPU<BusT>::RunNativeBlock(BasicBlock& block, const uint32_t limit) {
+    // Traces and profiles see every instruction
+#ifdef BREADEDSNES_TRACE
+    if (tracer) return 0;
+#endif
+#ifdef BREADEDSNES_PROFILE
+    if (profiler) return 0;
+#endif
+
+    if (!block.native) {
+        if (block.jit_rejected || ++block.executions < jit_threshold) return 0;
+
+        // A threshold of 0 compiles everything, however short, so tests reach every translation
+        const size_t min_instructions = jit_threshold ? JIT::kMinInstructions : 1;
+        JIT::Result result = jit.Compile(block, P & FLAG_M, P & FLAG_X, min_instructions);
+        if (result == JIT::Result::OutOfSpace) {
+            // Start the code buffer over; other blocks get recompiled once they're hot again
+            jit.Reset();
+            block_cache.ClearNative();
+            result = jit.Compile(block, P & FLAG_M, P & FLAG_X, min_instructions);
+        }
+        if (result != JIT::Result::Compiled) {
+            block.jit_rejected = true;
+            return 0;
+        }
+    }
+
+    if (jit_verify) [[unlikely]] return RunVerifiedNativeBlock(block, limit);
+    return block.native(this, limit);
+}
+
+// Runs the block natively, then puts memory and registers back and runs the same instructions on
+// the interpreter. The interpreter's result is the one that stands.
+template <typename BusT>
+uint32_t BasicCPU<BusT>::RunVerifiedNativeBlock(BasicBlock& block, const uint32_t limit) {
+    const auto idle = [this] {
+        return std::make_tuple(idle_tracking, idle_state, idle_writes, idle_reads, idle_loop_cycles, memory_writes);
+    };
+    const State start = GetState();
+    const auto start_idle = idle();
+
+    jit_journal.clear();
+    const uint32_t executed = block.native(this, limit);
+    const State native = GetState();
+    const auto native_idle = idle();
+    std::vector<uint8_t> written;
+    for (const auto& [address, old_value] : jit_journal) written.push_back(bus->Read(address));
+
+    for (auto entry = jit_journal.rbegin(); entry != jit_journal.rend(); ++entry) {
+        bus->Write(entry->first, entry->second);
+    }
+    BasicBlock* const block_in_use = current_block;
+    SetState(start);
+    current_block = block_in_use;
+    std::tie(idle_tracking, idle_state, idle_writes, idle_reads, idle_loop_cycles, memory_writes) = start_idle;
+
+    const bool predecoded = operand_predecoded;
+    operand_predecoded = false;
+    for (uint32_t i = 0; i < executed; i++) {
+        ExecuteInstruction();
+    }
+    operand_predecoded = predecoded;
+
+    bool same = GetState() == native && idle() == native_idle;
+    for (size_t i = 0; i < written.size(); i++) {
+        same &= bus->Read(jit_journal[i].first) == written[i];
+    }
+    if (!same) {
+        std::cout << "JIT mismatch in block $" << std::hex << block.start << " after " << std::dec << executed
+                  << " instructions: native code ended at PC $" << std::hex << native.PC << std::dec << " after "
+                  << native.cycles << " cycles, the interpreter at $" << std::hex << PC << std::dec << " after "
+                  << cycles << std::endl;
+        jit_mismatches++;
+        block.native = nullptr;
+        block.jit_rejected = true;
+    }
+    return executed;
 }
 
 // CPU Helper Methods
-uint8_t CPU::ReadByte(const uint32_t address) {
+template <typename BusT>
+uint8_t BasicCPU<BusT>::ReadByte(const uint32_t address) {
     cycles++;
     return bus->Read(address);
 }
 
-uint16_t CPU::ReadWord(const uint32_t address) {
+template <typename BusT>
+uint16_t BasicCPU<BusT>::ReadWord(const uint32_t address) {
     const uint8_t low = ReadByte(address);
     const uint8_t high = ReadByte(address + 1);
     return (high << 8) | low;
 }
 
-void CPU::UpdateNZ8(const uint8_t value) {
-    P = (P & ~FLAG_N) | (value & 0x80);  // Set N flag if bit 7 is set
-    P = (P & ~FLAG_Z) | (value == 0 ? FLAG_Z : 0);  // Set Z flag if value is zero
+template <typename BusT>
+uint8_t BasicCPU<BusT>::FetchByte() {
+    cycles++;
+    if (operand_predecoded) {
+        const uint8_t value = predecoded_operand & 0xFF;
+        predecoded_operand >>= 8;
+        PC++;
+        return value;
+    }
+    return bus->Read(PC++);
+}
+
+template <typename BusT>
+uint16_t BasicCPU<BusT>::FetchWord() {
+    const uint8_t low = FetchByte();
+    const uint8_t high = FetchByte();
+    return (high << 8) | low;
+}
+
+template <typename BusT>
+uint32_t BasicCPU<BusT>::FetchLong() {
+    const uint16_t low = FetchWord();
+    const uint8_t bank = FetchByte();
+    return (bank << 16) | low;
+}
+
+template <typename BusT>
+void BasicCPU<BusT>::UpdateNZ8(const uint8_t value) {
+    flag_n = value << 8;    // N comes from bit 15
+    flag_z = value;
+}
+
+template <typename BusT>
+void BasicCPU<BusT>::UpdateNZ16(const uint16_t value) {
+    flag_n = value;
+    flag_z = value;
+}
+
+// Folds the lazily kept N/Z/V/C back into the status byte
+template <typename BusT>
+uint8_t BasicCPU<BusT>::GetP() const {
+    return (P & ~(FLAG_N | FLAG_Z | FLAG_V | FLAG_C)) |
+           ((flag_n & 0x8000) ? FLAG_N : 0) |
+           (flag_z == 0 ? FLAG_Z : 0) |
+           (flag_v ? FLAG_V : 0) |
+           (flag_c ? FLAG_C : 0);
 }
 
-void CPU::UpdateNZ16(const uint16_t value) {
-    P = (P & ~FLAG_N) | ((value & 0x8000) ? FLAG_N : 0);  // Set N flag if bit 15 is set
-    P = (P & ~FLAG_Z) | (value == 0 ? FLAG_Z : 0);  // Set Z flag if value is zero
+template <typename BusT>
+void BasicCPU<BusT>::SetP(const uint8_t value) {
+    P = value;
+    flag_n = (value & FLAG_N) ? 0x8000 : 0;
+    flag_z = (value & FLAG_Z) ? 0 : 1;
+    flag_v = value & FLAG_V;
+    flag_c = value & FLAG_C;
 }
 
 // Helper method to write bytes/words to memory
-void CPU::WriteByte(const uint32_t address, const uint8_t value) const {
+template <typename BusT>
+void BasicCPU<BusT>::WriteByte(const uint32_t address, const uint8_t value) {
+    memory_writes++;
     bus->Write(address, value);
 }
 
-void CPU::WriteWord(const uint32_t address, const uint16_t value) const {
-    bus->Write(address, value & 0xFF);         // Low byte
-    bus->Write(address + 1, (value >> 8) & 0xFF); // High byte
+template <typename BusT>
+void BasicCPU<BusT>::WriteWord(const uint32_t address, const uint16_t value) {
+    WriteByte(address, value & 0xFF);           // Low byte
+    WriteByte(address + 1, (value >> 8) & 0xFF);  // High byte
 }
 
 // Helper function to update flags after compare operation
-void CPU::UpdateCompareFlags8(const uint8_t reg_value, const uint8_t compare_value) {
+template <typename BusT>
+void BasicCPU<BusT>::UpdateCompareFlags8(const uint8_t reg_value, const uint8_t compare_value) {
     const uint16_t result = reg_value - compare_value;
 
-    // Set/clear flags
-    if (result & 0x100) {
-        P &= ~FLAG_C;
-    } else {
-        P |= FLAG_C;
-    }
-
-    if ((result & 0xFF) == 0) {
-        P |= FLAG_Z;
-    } else {
-        P &= ~FLAG_Z;
-    }
-
-    if (result & 0x80) {
-        P |= FLAG_N;
-    } else {
-        P &= ~FLAG_N;
-    }
+    flag_c = !(result & 0x100);
+    UpdateNZ8(result & 0xFF);
 }
 
-void CPU::UpdateCompareFlags16(const uint16_t reg_value, const uint16_t compare_value) {
+template <typename BusT>
+void BasicCPU<BusT>::UpdateCompareFlags16(const uint16_t reg_value, const uint16_t compare_value) {
     const uint32_t result = reg_value - compare_value;
 
-    // Set/clear flags
-    if (result & 0x10000) {
-        P &= ~FLAG_C;
-    } else {
-        P |= FLAG_C;
-    }
-
-    if ((result & 0xFFFF) == 0) {
-        P |= FLAG_Z;
-    } else {
-        P &= ~FLAG_Z;
-    }
-
-    if (result & 0x8000) {
-        P |= FLAG_N;
-    } else {
-        P &= ~FLAG_N;
-    }
+    flag_c = !(result & 0x10000);
+    UpdateNZ16(result & 0xFFFF);
 }
 
 // General Branching Code
-void CPU::DoBranch(const bool condition) {
-    const auto displacement = static_cast<int8_t>(ReadByte(PC));
-    PC++;
+template <typename BusT>
+void BasicCPU<BusT>::DoBranch(const bool condition, const int base_cycles) {
+    const auto displacement = static_cast<int8_t>(FetchByte());
+    cycles += base_cycles;
 
     if (condition) {
         const uint32_t old_pc = PC; // Save the current PC for page boundary check
@@ -112,36 +584,42 @@ void CPU::DoBranch(const bool condition) {
         cycles++;
 
         if ((old_pc & 0xFF00) != (PC & 0xFF00)) cycles++; // Add one cycle for crossing a page boundary
+        CheckIdleLoop();
     }
 }
 
 // Stack helper methods:
-void CPU::PushByte(const uint8_t value) {
+template <typename BusT>
+void BasicCPU<BusT>::PushByte(const uint8_t value) {
     WriteByte(SP, value);
     SP--;
     cycles++;
 }
 
-void CPU::PushWord(const uint16_t value) {
+template <typename BusT>
+void BasicCPU<BusT>::PushWord(const uint16_t value) {
     // Push high then low
     PushByte(value >> 8);
     PushByte(value & 0xFF);
 }
 
-uint8_t CPU::PopByte() {
+template <typename BusT>
+uint8_t BasicCPU<BusT>::PopByte() {
     SP++;
     cycles++;
     return ReadByte(SP);
 }
 
-uint16_t CPU::PopWord() {
+template <typename BusT>
+uint16_t BasicCPU<BusT>::PopWord() {
     // Pop low then high
     const uint8_t low = PopByte();
     const uint8_t high = PopByte();
     return (high << 8) | low;
 }
 
-void CPU::DoADC(const uint16_t value) {
+template <typename BusT>
+void BasicCPU<BusT>::DoADC(const uint16_t value) {
     uint32_t result;
 
     if (P & FLAG_M) {
@@ -151,15 +629,14 @@ void CPU::DoADC(const uint16_t value) {
 
         if (P & FLAG_D) {
             // Decimal mode
-            result = acc_low + val_low + (P & FLAG_C ? 1 : 0);
-            result = AdjustDecimal(result, false);
+            result = AddDecimal(acc_low, val_low, false);
         } else {
             // Binary mode
-            result = acc_low + val_low + (P & FLAG_C ? 1 : 0);
+            result = acc_low + val_low + (flag_c ? 1 : 0);
+            flag_v = (acc_low ^ result) & (val_low ^ result) & 0x80;
         }
 
-        P = (P & ~FLAG_C) | (result > 0xFF ? FLAG_C : 0);
-        P = (P & ~FLAG_V) | (((acc_low ^ result) & (val_low ^ result) & 0x80) ? FLAG_V : 0);
+        flag_c = result > 0xFF;
 
         A = (A & 0xFF00) | (result & 0xFF);
         UpdateNZ8(A & 0xFF);
@@ -168,40 +645,39 @@ void CPU::DoADC(const uint16_t value) {
         // 16-bit mode
         if (P & FLAG_D) {
             // Decimal mode
-            result = A + value + (P & FLAG_C ? 1 : 0);
-            result = AdjustDecimal(result, true);
+            result = AddDecimal(A, value, true);
         } else {
             // Binary mode
-            result = A + value + (P & FLAG_C ? 1 : 0);
+            result = A + value + (flag_c ? 1 : 0);
+            flag_v = (A ^ result) & (value ^ result) & 0x8000;
         }
 
-        P = (P & ~FLAG_C) | (result > 0xFFFF ? FLAG_C : 0);
-        P = (P & ~FLAG_V) | (((A ^ result) & (value ^ result) & 0x8000) ? FLAG_V : 0);
+        flag_c = result > 0xFFFF;
 
         A = result & 0xFFFF;
         UpdateNZ16(A);
     }
 }
 
-uint16_t CPU::AdjustDecimal(const uint16_t binary_result, const bool is_16bit) {
-    //TODO: Make sure this works? I'm not sure I understand.
-    if (is_16bit) {
-        // 16-bit decimal adjustment
-        uint16_t result = binary_result;
-        if ((result & 0x0F) > 0x09) result += 0x06;
-        if ((result & 0xF0) > 0x90) result += 0x60;
-        if ((result & 0x0F00) > 0x0900) result += 0x0600;
-        if ((result & 0xF000) > 0x9000) result += 0x6000;
-        return result;
+// Adds one digit at a time with the carry between digits, returning the carry out above the
+// result. V comes from the sum before the top digit is adjusted, the way the 65816 sets it.
+template <typename BusT>
+uint32_t BasicCPU<BusT>::AddDecimal(const uint16_t a, const uint16_t b, const bool is_16bit) {
+    const int width = is_16bit ? 16 : 8;
+    uint32_t result = 0;
+    uint32_t carry = flag_c ? 1 : 0;
+    for (int shift = 0; shift < width; shift += 4) {
+        uint32_t digit = ((a >> shift) & 0x0F) + ((b >> shift) & 0x0F) + carry;
+        if (shift == width - 4) flag_v = ~(a ^ b) & (a ^ (result | (digit << shift))) & (1u << (width - 1));
+        if (digit > 0x09) digit += 0x06;
+        carry = digit > 0x0F;
+        result |= (digit & 0x0F) << shift;
     }
-    // 8-bit decimal adjustment
-    uint16_t result = binary_result;
-    if ((result & 0x0F) > 0x09) result += 0x06;
-    if ((result & 0xF0) > 0x90) result += 0x60;
-    return result;
+    return result | (carry << width);
 }
 
-void CPU::LDA_Mem(const uint32_t address, const int base_cycles, const bool addDPExtraCycle = false, const bool addPageCrossCycle = false, const uint16_t base = 0, const uint16_t offset = 0) {
+template <typename BusT>
+void BasicCPU<BusT>::LDA_Mem(const uint32_t address, const int base_cycles, const bool addDPExtraCycle, const bool addPageCrossCycle, const uint16_t base, const uint16_t offset) {
     if (P & FLAG_M) {
         const uint8_t value = ReadByte(address);
         A = (A & 0xFF00) | value;
@@ -217,7 +693,8 @@ void CPU::LDA_Mem(const uint32_t address, const int base_cycles, const bool addD
     if (addPageCrossCycle && ((base & 0xFF00) != ((base + offset) & 0xFF00))) cycles++;
 }
 
-void CPU::LD_Index(uint32_t address, const bool isX, const int base_cycles, const bool addDPExtraCycle = false, const bool addPageCrossCycle = false, const uint16_t base = 0, const uint16_t offset = 0) {
+template <typename BusT>
+void BasicCPU<BusT>::LD_Index(uint32_t address, const bool isX, const int base_cycles, const bool addDPExtraCycle, const bool addPageCrossCycle, const uint16_t base, const uint16_t offset) {
     const bool is8Bit = P & FLAG_X;
     const uint16_t value = is8Bit ? ReadByte(address) : ReadWord(address);
 
@@ -234,108 +711,69 @@ void CPU::LD_Index(uint32_t address, const bool isX, const int base_cycles, cons
     if (addPageCrossCycle && ((base & 0xFF00) != ((base + offset) & 0xFF00))) cycles++;
 }
 
-void CPU::UpdateASLFlags8(const uint8_t original_value, const uint8_t result) {
-    if (original_value & 0x80) {
-        P |= FLAG_C;
-    } else {
-        P &= ~FLAG_C;
-    }
+template <typename BusT>
+void BasicCPU<BusT>::UpdateASLFlags8(const uint8_t original_value, const uint8_t result) {
+    flag_c = original_value & 0x80;
     UpdateNZ8(result);
 }
 
-void CPU::UpdateASLFlags16(const uint16_t original_value, const uint16_t result) {
-    if (original_value & 0x8000) {
-        P |= FLAG_C;
-    } else {
-        P &= ~FLAG_C;
-    }
+template <typename BusT>
+void BasicCPU<BusT>::UpdateASLFlags16(const uint16_t original_value, const uint16_t result) {
+    flag_c = original_value & 0x8000;
     UpdateNZ16(result);
 }
 
 // Helper function to update flags after BIT operation (non-immediate modes)
-void CPU::UpdateBITFlags8(uint8_t memory_value, uint8_t acc_value) {
+template <typename BusT>
+void BasicCPU<BusT>::UpdateBITFlags8(uint8_t memory_value, uint8_t acc_value) {
     // Z flag: set if (A & memory) == 0
-    if (const uint8_t result = acc_value & memory_value; result == 0) {
-        P |= FLAG_Z;
-    } else {
-        P &= ~FLAG_Z;
-    }
+    flag_z = acc_value & memory_value;
 
     // N flag: copy bit 7 of memory
-    if (memory_value & 0x80) {
-        P |= FLAG_N;
-    } else {
-        P &= ~FLAG_N;
-    }
+    flag_n = memory_value << 8;
 
     // V flag: copy bit 6 of memory
-    if (memory_value & 0x40) {
-        P |= FLAG_V;
-    } else {
-        P &= ~FLAG_V;
-    }
+    flag_v = memory_value & 0x40;
 }
 
-void CPU::UpdateBITFlags16(const uint16_t memory_value, const uint16_t acc_value) {
-    if (const uint16_t result = acc_value & memory_value; result == 0) {
-        P |= FLAG_Z;
-    } else {
-        P &= ~FLAG_Z;
-    }
+template <typename BusT>
+void BasicCPU<BusT>::UpdateBITFlags16(const uint16_t memory_value, const uint16_t acc_value) {
+    flag_z = acc_value & memory_value;
 
     // N flag: copy bit 15 of memory
-    if (memory_value & 0x8000) {
-        P |= FLAG_N;
-    } else {
-        P &= ~FLAG_N;
-    }
+    flag_n = memory_value;
 
     // V flag: copy bit 14 of memory
-    if (memory_value & 0x4000) {
-        P |= FLAG_V;
-    } else {
-        P &= ~FLAG_V;
-    }
+    flag_v = memory_value & 0x4000;
 }
 
 // Helper function for immediate mode BIT
-void CPU::UpdateBITImmediateFlags8(const uint8_t memory_value, const uint8_t acc_value) {
-    if (const uint8_t result = acc_value & memory_value; result == 0) {
-        P |= FLAG_Z;
-    } else {
-        P &= ~FLAG_Z;
-    }
+template <typename BusT>
+void BasicCPU<BusT>::UpdateBITImmediateFlags8(const uint8_t memory_value, const uint8_t acc_value) {
+    flag_z = acc_value & memory_value;
 }
 
-void CPU::UpdateBITImmediateFlags16(const uint16_t memory_value, const uint16_t acc_value) {
-    if (const uint16_t result = acc_value & memory_value; result == 0) {
-        P |= FLAG_Z;
-    } else {
-        P &= ~FLAG_Z;
-    }
+template <typename BusT>
+void BasicCPU<BusT>::UpdateBITImmediateFlags16(const uint16_t memory_value, const uint16_t acc_value) {
+    flag_z = acc_value & memory_value;
 }
 
-void CPU::UpdateLSRFlags8(const uint8_t original_value, const uint8_t result) {
+template <typename BusT>
+void BasicCPU<BusT>::UpdateLSRFlags8(const uint8_t original_value, const uint8_t result) {
     // Set carry flag if bit 0 was set
-    if (original_value & 0x01) {
-        P |= FLAG_C;
-    } else {
-        P &= ~FLAG_C;
-    }
+    flag_c = original_value & 0x01;
     UpdateNZ8(result);
 }
 
-void CPU::UpdateLSRFlags16(const uint16_t original_value, const uint16_t result) {
+template <typename BusT>
+void BasicCPU<BusT>::UpdateLSRFlags16(const uint16_t original_value, const uint16_t result) {
     // Set carry flag if bit 0 was set
-    if (original_value & 0x0001) {
-        P |= FLAG_C;
-    } else {
-        P &= ~FLAG_C;
-    }
+    flag_c = original_value & 0x0001;
     UpdateNZ16(result);
 }
 
-void CPU::ORA_Mem(const uint32_t address, const int base_cycles, const bool addDPExtraCycle = false, const bool addPageCrossCycle = false, const uint16_t base_address = 0, const uint16_t offset = 0) {
+template <typename BusT>
+void BasicCPU<BusT>::ORA_Mem(const uint32_t address, const int base_cycles, const bool addDPExtraCycle, const bool addPageCrossCycle, const uint16_t base_address, const uint16_t offset) {
     if (P & FLAG_M) {
         const uint8_t operand = ReadByte(address);
         A = (A & 0xFF00) | ((A & 0xFF) | operand);
@@ -354,39 +792,34 @@ void CPU::ORA_Mem(const uint32_t address, const int base_cycles, const bool addD
 }
 
 // ROL/ROR helper methods
-uint8_t CPU::ROL8(uint8_t value) {
-    const bool old_carry = (P & FLAG_C) != 0;
+template <typename BusT>
+uint8_t BasicCPU<BusT>::ROL8(uint8_t value) {
+    const bool old_carry = flag_c;
     const bool new_carry = (value & 0x80) != 0;
 
     value = (value << 1) | (old_carry ? 1 : 0);
 
-    if (new_carry) {
-        P |= FLAG_C;
-    } else {
-        P &= ~FLAG_C;
-    }
+    flag_c = new_carry;
 
     UpdateNZ8(value);
     return value;
 }
 
-uint16_t CPU::ROL16(uint16_t value) {
-    const bool old_carry = (P & FLAG_C) != 0;
+template <typename BusT>
+uint16_t BasicCPU<BusT>::ROL16(uint16_t value) {
+    const bool old_carry = flag_c;
     const bool new_carry = (value & 0x8000) != 0;
 
     value = (value << 1) | (old_carry ? 1 : 0);
 
-    if (new_carry) {
-        P |= FLAG_C;
-    } else {
-        P &= ~FLAG_C;
-    }
+    flag_c = new_carry;
 
     UpdateNZ16(value);
     return value;
 }
 
-void CPU::ROL_AtAddress(const uint32_t address, const int base_cycles_8bit, const int base_cycles_16bit) {
+template <typename BusT>
+void BasicCPU<BusT>::ROL_AtAddress(const uint32_t address, const int base_cycles_8bit, const int base_cycles_16bit) {
     if (P & FLAG_M) {
         uint8_t value = ReadByte(address);
         value = ROL8(value);
@@ -400,39 +833,34 @@ void CPU::ROL_AtAddress(const uint32_t address, const int base_cycles_8bit, cons
     }
 }
 
-uint8_t CPU::ROR8(uint8_t value) {
-    const bool old_carry = (P & FLAG_C) != 0;
+template <typename BusT>
+uint8_t BasicCPU<BusT>::ROR8(uint8_t value) {
+    const bool old_carry = flag_c;
     const bool new_carry = (value & 0x01) != 0;
 
     value = (value >> 1) | (old_carry ? 0x80 : 0);
 
-    if (new_carry) {
-        P |= FLAG_C;
-    } else {
-        P &= ~FLAG_C;
-    }
+    flag_c = new_carry;
 
     UpdateNZ8(value);
     return value;
 }
 
-uint16_t CPU::ROR16(uint16_t value) {
-    const bool old_carry = (P & FLAG_C) != 0;
+template <typename BusT>
+uint16_t BasicCPU<BusT>::ROR16(uint16_t value) {
+    const bool old_carry = flag_c;
     const bool new_carry = (value & 0x0001) != 0;
 
     value = (value >> 1) | (old_carry ? 0x8000 : 0);
 
-    if (new_carry) {
-        P |= FLAG_C;
-    } else {
-        P &= ~FLAG_C;
-    }
+    flag_c = new_carry;
 
     UpdateNZ16(value);
     return value;
 }
 
-void CPU::ROR_AtAddress(const uint32_t address, const int base_cycles_8bit, const int base_cycles_16bit) {
+template <typename BusT>
+void BasicCPU<BusT>::ROR_AtAddress(const uint32_t address, const int base_cycles_8bit, const int base_cycles_16bit) {
     if (P & FLAG_M) {
         uint8_t value = ReadByte(address);
         value = ROR8(value);
@@ -446,60 +874,49 @@ void CPU::ROR_AtAddress(const uint32_t address, const int base_cycles_8bit, cons
     }
 }
 
-void CPU::SBC8(const uint8_t operand) {
+template <typename BusT>
+void BasicCPU<BusT>::SBC8(const uint8_t operand) {
     const uint8_t acc = A & 0xFF;
 
     if (P & FLAG_D) {
         // Decimal mode
-        const bool carry_in = (P & FLAG_C) != 0;
+        const bool carry_in = flag_c;
         const uint8_t result = SBC8_Decimal(acc, operand, carry_in);
         A = (A & 0xFF00) | result;
     } else {
         // Binary mode
-        const uint16_t carry_in = (P & FLAG_C) ? 0 : 1;  // Note: Inverted carry
+        const uint16_t carry_in = flag_c ? 0 : 1;  // Note: Inverted carry
         const uint16_t result = acc - operand - carry_in;
 
-        P &= ~(FLAG_C | FLAG_V | FLAG_N | FLAG_Z);
-
-        if (result <= 0xFF) {
-            P |= FLAG_C;
-        }
-
-        if (((acc ^ operand) & (acc ^ result) & 0x80) != 0) {
-            P |= FLAG_V;
-        }
+        flag_c = result <= 0xFF;
+        flag_v = ((acc ^ operand) & (acc ^ result) & 0x80) != 0;
 
         A = (A & 0xFF00) | (result & 0xFF);
         UpdateNZ8(result & 0xFF);
     }
 }
 
-void CPU::SBC16(const uint16_t operand) {
+template <typename BusT>
+void BasicCPU<BusT>::SBC16(const uint16_t operand) {
     if (P & FLAG_D) {
         // Decimal mode
-        const bool carry_in = (P & FLAG_C) != 0;
+        const bool carry_in = flag_c;
         A = SBC16_Decimal(A, operand, carry_in);
     } else {
         // Binary mode
-        const uint32_t carry_in = (P & FLAG_C) ? 0 : 1;
+        const uint32_t carry_in = flag_c ? 0 : 1;
         const uint32_t result = A - operand - carry_in;
 
-        P &= ~(FLAG_C | FLAG_V | FLAG_N | FLAG_Z);
-
-        if (result <= 0xFFFF) {
-            P |= FLAG_C;
-        }
-
-        if (((A ^ operand) & (A ^ result) & 0x8000) != 0) {
-            P |= FLAG_V;
-        }
+        flag_c = result <= 0xFFFF;
+        flag_v = ((A ^ operand) & (A ^ result) & 0x8000) != 0;
 
         A = result & 0xFFFF;
         UpdateNZ16(A);
     }
 }
 
-uint8_t CPU::SBC8_Decimal(const uint8_t a, const uint8_t operand, const bool carry) {
+template <typename BusT>
+uint8_t BasicCPU<BusT>::SBC8_Decimal(const uint8_t a, const uint8_t operand, const bool carry) {
     uint16_t result = a - operand - (carry ? 0 : 1);
 
     // Adjust for decimal mode
@@ -510,11 +927,7 @@ uint8_t CPU::SBC8_Decimal(const uint8_t a, const uint8_t operand, const bool car
         result -= 0x60;
     }
 
-    P &= ~(FLAG_C | FLAG_N | FLAG_Z);
-
-    if (result <= 0xFF) {
-        P |= FLAG_C;
-    }
+    flag_c = result <= 0xFF;
 
     const uint8_t final_result = result & 0xFF;
     UpdateNZ8(final_result);
@@ -522,7 +935,8 @@ uint8_t CPU::SBC8_Decimal(const uint8_t a, const uint8_t operand, const bool car
     return final_result;
 }
 
-uint16_t CPU::SBC16_Decimal(const uint16_t a, const uint16_t operand, const bool carry) {
+template <typename BusT>
+uint16_t BasicCPU<BusT>::SBC16_Decimal(const uint16_t a, const uint16_t operand, const bool carry) {
     uint32_t result = a - operand - (carry ? 0 : 1);
 
     // Adjust low nibble
@@ -545,11 +959,7 @@ uint16_t CPU::SBC16_Decimal(const uint16_t a, const uint16_t operand, const bool
         result -= 0x6000;
     }
 
-    P &= ~(FLAG_C | FLAG_N | FLAG_Z);
-
-    if (result <= 0xFFFF) {
-        P |= FLAG_C;
-    }
+    flag_c = result <= 0xFFFF;
 
     const uint16_t final_result = result & 0xFFFF;
     UpdateNZ16(final_result);
@@ -557,7 +967,8 @@ uint16_t CPU::SBC16_Decimal(const uint16_t a, const uint16_t operand, const bool
     return final_result;
 }
 
-void CPU::SBC_FromAddress(const uint32_t address, const int base_cycles_8bit, const int base_cycles_16bit) {
+template <typename BusT>
+void BasicCPU<BusT>::SBC_FromAddress(const uint32_t address, const int base_cycles_8bit, const int base_cycles_16bit) {
     if (P & FLAG_M) {
         const uint8_t operand = ReadByte(address);
         SBC8(operand);
@@ -569,14 +980,16 @@ void CPU::SBC_FromAddress(const uint32_t address, const int base_cycles_8bit, co
     }
 }
 
-void CPU::SBC_FromAddress_PageCross(const uint32_t address, const uint16_t base_address, const uint16_t offset, const int base_cycles_8bit, const int base_cycles_16bit) {
+template <typename BusT>
+void BasicCPU<BusT>::SBC_FromAddress_PageCross(const uint32_t address, const uint16_t base_address, const uint16_t offset, const int base_cycles_8bit, const int base_cycles_16bit) {
     SBC_FromAddress(address, base_cycles_8bit, base_cycles_16bit);
     if ((base_address & 0xFF00) != ((base_address + offset) & 0xFF00)) {
         cycles++;
     }
 }
 
-void CPU::STZ_ToAddress(const uint32_t address, const int base_cycles_8bit, const int base_cycles_16bit) {
+template <typename BusT>
+void BasicCPU<BusT>::STZ_ToAddress(const uint32_t address, const int base_cycles_8bit, const int base_cycles_16bit) {
     if (P & FLAG_M) {
         WriteByte(address, 0x00);
         cycles += base_cycles_8bit;
@@ -586,7 +999,8 @@ void CPU::STZ_ToAddress(const uint32_t address, const int base_cycles_8bit, cons
     }
 }
 
-void CPU::WriteRegisterToAddress(const uint32_t address, const uint16_t value, const bool isMemoryFlag, const int baseCycles) {
+template <typename BusT>
+void BasicCPU<BusT>::WriteRegisterToAddress(const uint32_t address, const uint16_t value, const bool isMemoryFlag, const int baseCycles) {
     if (isMemoryFlag) {
         WriteByte(address, value & 0xFF);
         cycles += baseCycles;
@@ -596,13 +1010,53 @@ void CPU::WriteRegisterToAddress(const uint32_t address, const uint16_t value, c
     }
 }
 
-void CPU::WriteWithDirectPagePenalty(const uint32_t address, const uint16_t value, const bool isMemoryFlag, const int baseCycles) {
+template <typename BusT>
+void BasicCPU<BusT>::WriteWithDirectPagePenalty(const uint32_t address, const uint16_t value, const bool isMemoryFlag, const int baseCycles) {
     WriteRegisterToAddress(address, value, isMemoryFlag, baseCycles);
     if (D & 0xFF) cycles++;
 }
 
-void CPU::ExecuteInstruction() {
-    switch (const uint8_t opcode = bus->Read(PC++)) {
+template <typename BusT>
+void BasicCPU<BusT>::ExecuteInstruction() {
+    ExecuteOpcode(bus->Read(PC++));
+}
+
+#ifdef BREADEDSNES_TRACE
+// PC already points past the opcode here
+template <typename BusT>
+void BasicCPU<BusT>::TraceInstruction(const uint8_t opcode) {
+    TraceRecord record{};
+    record.cycles = cycles;
+    record.pc = (PC - 1) & 0xFFFFFF;
+    record.opcode = opcode;
+    record.length = InstructionLength(opcode, P & FLAG_M, P & FLAG_X);
+    for (uint32_t i = 0; i + 1 < record.length; i++) {
+        // Don't trigger I/O side effects just to log an operand
+        if (bus->IsPlainMemory(PC + i)) record.operand[i] = bus->Read(PC + i);
+    }
+    record.a = A;
+    record.x = X;
+    record.y = Y;
+    record.sp = SP;
+    record.d = D;
+    record.p = GetP();
+    record.db = DB;
+    record.flags = emulation_mode ? kTraceEmulation : 0;
+    tracer->Record(record);
+}
+#endif
+
+template <typename BusT>
+void BasicCPU<BusT>::ExecuteOpcode(const uint8_t opcode) {
+#ifdef BREADEDSNES_TRACE
+    if (tracer) [[unlikely]] TraceInstruction(opcode);
+#endif
+#ifdef BREADEDSNES_PROFILE
+    const uint32_t start_pc = (PC - 1) & 0xFFFFFF;
+    const uint64_t start_cycles = cycles;
+#endif
+
+    switch (opcode) {
         // ADC - Add with Carry
         case 0x69: ADC_Immediate(); break;              // ADC #$nn/#$nnnn
         case 0x6D: ADC_Absolute(); break;               // ADC $nnnn
@@ -943,80 +1397,90 @@ void CPU::ExecuteInstruction() {
             std::cout << "Unknown opcode: 0x" << std::hex << static_cast<int>(opcode) << std::endl;
             break;
     }
+
+#ifdef BREADEDSNES_PROFILE
+    if (profiler) [[unlikely]] profiler->RecordInstruction(opcode, start_pc, cycles - start_cycles);
+#endif
 }
 
-void CPU::NOP() {
+template <typename BusT>
+void BasicCPU<BusT>::NOP() {
     // No operation
 }
 
 // Load Accumulator Instructions
-void CPU::LDA_Immediate() {
+template <typename BusT>
+void BasicCPU<BusT>::LDA_Immediate() {
     if (P & FLAG_M) {
         // 8-bit accumulator mode
-        const uint8_t value = ReadByte(PC++);
+        const uint8_t value = FetchByte();
         A = (A & 0xFF00) | value;  // Keep high byte, update low byte
         UpdateNZ8(value);
         cycles += 2;
     } else {
         // 16-bit accumulator mode
-        A = ReadWord(PC);
-        PC += 2;
+        A = FetchWord();
         UpdateNZ16(A);
         cycles += 3;
     }
 }
 
-void CPU::LDA_Absolute() {
-    const uint16_t address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::LDA_Absolute() {
+    const uint16_t address = FetchWord();
 
     LDA_Mem(address, 4);
 }
 
-void CPU::LDA_AbsoluteX() {
-    const uint16_t base = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::LDA_AbsoluteX() {
+    const uint16_t base = FetchWord();
 
     LDA_Mem(base + X, 4, false, true, base, X);
 }
 
-void CPU::LDA_AbsoluteY() {
-    const uint16_t base = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::LDA_AbsoluteY() {
+    const uint16_t base = FetchWord();
 
     LDA_Mem(base + Y, 4, false, true, base, Y);
 }
 
-void CPU::LDA_DirectPage() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::LDA_DirectPage() {
+    const uint8_t offset = FetchByte();
     LDA_Mem(D + offset, 3, true);
 }
 
-void CPU::LDA_DirectPageX() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::LDA_DirectPageX() {
+    const uint8_t offset = FetchByte();
     const uint16_t x_offset = (P & FLAG_X) ? (X & 0xFF) : X;
 
     LDA_Mem(D + offset + x_offset, 4, true);
 }
 
-void CPU::LDA_IndirectDirectPage() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::LDA_IndirectDirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t ptr = D + offset;
     const uint16_t address = ReadWord(ptr);
 
     LDA_Mem(address, 5, true);
 }
 
-void CPU::LDA_IndirectDirectPageY() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::LDA_IndirectDirectPageY() {
+    const uint8_t offset = FetchByte();
     const uint32_t ptr = D + offset;
     const uint16_t base = ReadWord(ptr);
 
     LDA_Mem(base + Y, 5, true, true, base, Y);
 }
 
-void CPU::LDA_DirectPageIndirectX() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::LDA_DirectPageIndirectX() {
+    const uint8_t offset = FetchByte();
     const uint16_t x_offset = (P & FLAG_X) ? (X & 0xFF) : X;
     const uint32_t ptr = D + offset + x_offset;
     const uint16_t address = ReadWord(ptr);
@@ -1024,107 +1488,117 @@ void CPU::LDA_DirectPageIndirectX() {
     LDA_Mem(address, 6, true);
 }
 
-void CPU::LDA_Long() {
-    const uint32_t address = ReadByte(PC++) | (ReadByte(PC++) << 8) | (ReadByte(PC++) << 16);
+template <typename BusT>
+void BasicCPU<BusT>::LDA_Long() {
+    const uint16_t address_low = FetchWord();
+    const uint8_t address_bank = FetchByte();
+    const uint32_t address = (address_bank << 16) | address_low;
 
     LDA_Mem(address, 5);
 }
 
-void CPU::LDA_LongX() {
-    const uint32_t base = ReadByte(PC++) | (ReadByte(PC++) << 8) | (ReadByte(PC++) << 16);
+template <typename BusT>
+void BasicCPU<BusT>::LDA_LongX() {
+    const uint16_t base_low = FetchWord();
+    const uint8_t base_bank = FetchByte();
+    const uint32_t base = (base_bank << 16) | base_low;
 
     LDA_Mem(base + X, 5);
 }
 
 // Load X Register Instructions
-void CPU::LDX_Immediate() {
+template <typename BusT>
+void BasicCPU<BusT>::LDX_Immediate() {
     if (P & FLAG_X) {
         // 8-bit index mode
-        X = ReadByte(PC++);
+        X = FetchByte();
         UpdateNZ8(X & 0xFF);
         cycles += 2;
     } else {
         // 16-bit index mode
-        X = ReadWord(PC);
-        PC += 2;
+        X = FetchWord();
         UpdateNZ16(X);
         cycles += 3;
     }
 }
 
-void CPU::LDX_Absolute() {
-    const uint16_t addr = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::LDX_Absolute() {
+    const uint16_t addr = FetchWord();
 
     LD_Index(addr, true, 4);
 }
 
-void CPU::LDX_AbsoluteY() {
-    const uint16_t base = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::LDX_AbsoluteY() {
+    const uint16_t base = FetchWord();
 
     LD_Index(base + Y, true, 4, false, true, base, Y);
 }
 
-void CPU::LDX_DirectPage() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::LDX_DirectPage() {
+    const uint8_t offset = FetchByte();
     LD_Index(D + offset, true, 3, true);
 }
 
-void CPU::LDX_DirectPageY() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::LDX_DirectPageY() {
+    const uint8_t offset = FetchByte();
     const uint16_t y_offset = (P & FLAG_X) ? (Y & 0xFF) : Y;
 
     LD_Index(D + offset + y_offset, true, 4, true);
 }
 
 // Load Y Register Instructions
-void CPU::LDY_Immediate() {
+template <typename BusT>
+void BasicCPU<BusT>::LDY_Immediate() {
     if (P & FLAG_X) {
         // 8-bit index mode
-        Y = ReadByte(PC++);
+        Y = FetchByte();
         UpdateNZ8(Y & 0xFF);
         cycles += 2;
     } else {
         // 16-bit index mode
-        Y = ReadWord(PC);
-        PC += 2;
+        Y = FetchWord();
         UpdateNZ16(Y);
         cycles += 3;
     }
 }
 
-void CPU::LDY_Absolute() {
-    const uint16_t addr = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::LDY_Absolute() {
+    const uint16_t addr = FetchWord();
 
     LD_Index(addr, false, 4);
 }
 
-void CPU::LDY_AbsoluteX() {
-    const uint16_t base = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::LDY_AbsoluteX() {
+    const uint16_t base = FetchWord();
 
     LD_Index(base + X, false, 4, false, true, base, X);
 }
 
-void CPU::LDY_DirectPage() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::LDY_DirectPage() {
+    const uint8_t offset = FetchByte();
 
     LD_Index(D + offset, false, 3, true);
 }
 
-void CPU::LDY_DirectPageX() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::LDY_DirectPageX() {
+    const uint8_t offset = FetchByte();
     const uint16_t x_offset = (P & FLAG_X) ? (X & 0xFF) : X;
 
     LD_Index(D + offset + x_offset, false, 4, true);
 }
 
 //Store operations implementation
-void CPU::STA_Absolute() {
-    const uint32_t address = ReadWord(PC + 1) | (DB << 16);
-    PC += 3;
+template <typename BusT>
+void BasicCPU<BusT>::STA_Absolute() {
+    const uint32_t address = FetchWord() | (DB << 16);
 
     if (P & FLAG_M) { // 8-bit mode
         WriteByte(address, A & 0xFF);
@@ -1135,94 +1609,92 @@ void CPU::STA_Absolute() {
     }
 }
 
-void CPU::STA_AbsoluteX() {
-    const uint32_t base = ReadWord(PC + 1) | (DB << 16);
+template <typename BusT>
+void BasicCPU<BusT>::STA_AbsoluteX() {
+    const uint32_t base = FetchWord() | (DB << 16);
     const uint32_t address = base + X;
-    PC += 3;
 
     WriteRegisterToAddress(address, A, P & FLAG_M, 5);
 }
 
-void CPU::STA_AbsoluteY() {
-    const uint32_t base = ReadWord(PC + 1) | (DB << 16);
+template <typename BusT>
+void BasicCPU<BusT>::STA_AbsoluteY() {
+    const uint32_t base = FetchWord() | (DB << 16);
     const uint32_t address = base + Y;
-    PC += 3;
 
     WriteRegisterToAddress(address, A, P & FLAG_M, 5);
 }
 
-void CPU::STA_DirectPage() {
-    const uint8_t offset = ReadByte(PC + 1);
+template <typename BusT>
+void BasicCPU<BusT>::STA_DirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = (D + offset) & 0xFFFF;
-    PC += 2;
 
     WriteWithDirectPagePenalty(address, A, P & FLAG_M, 3);
 }
 
-void CPU::STA_DirectPageX() {
-    const uint8_t offset = ReadByte(PC + 1);
+template <typename BusT>
+void BasicCPU<BusT>::STA_DirectPageX() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = (D + offset + X) & 0xFFFF;
-    PC += 2;
 
     WriteWithDirectPagePenalty(address, A, P & FLAG_M, 4);
 }
 
-void CPU::STA_IndirectDirectPage() {
-    const uint8_t offset = ReadByte(PC + 1);
+template <typename BusT>
+void BasicCPU<BusT>::STA_IndirectDirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer = (D + offset) & 0xFFFF;
     const uint32_t address = ReadWord(pointer) | (DB << 16);
-    PC += 2;
 
     WriteWithDirectPagePenalty(address, A, P & FLAG_M, 5);
 }
 
-void CPU::STA_IndirectDirectPageY() {
-    const uint8_t offset = ReadByte(PC + 1);
+template <typename BusT>
+void BasicCPU<BusT>::STA_IndirectDirectPageY() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer = (D + offset) & 0xFFFF;
     const uint32_t base = ReadWord(pointer) | (DB << 16);
     const uint32_t address = base + Y;
-    PC += 2;
 
     WriteWithDirectPagePenalty(address, A, P & FLAG_M, 6);
 }
 
-void CPU::STA_DirectPageIndirectX() {
-    const uint8_t offset = ReadByte(PC + 1);
+template <typename BusT>
+void BasicCPU<BusT>::STA_DirectPageIndirectX() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer = (D + offset + X) & 0xFFFF;
     const uint32_t address = ReadWord(pointer) | (DB << 16);
-    PC += 2;
 
     WriteWithDirectPagePenalty(address, A, P & FLAG_M, 7);
 }
 
-void CPU::STA_Long() {
-    const uint32_t address = ReadByte(PC + 1) |
-                       (ReadByte(PC + 2) << 8) |
-                       (ReadByte(PC + 3) << 16);
-    PC += 4;
+template <typename BusT>
+void BasicCPU<BusT>::STA_Long() {
+    const uint32_t address = FetchLong();
 
     WriteRegisterToAddress(address, A, P & FLAG_M, 5);
 }
 
-void CPU::STA_LongX() {
-    const uint32_t base = ReadByte(PC + 1) |
-                    (ReadByte(PC + 2) << 8) |
-                    (ReadByte(PC + 3) << 16);
+template <typename BusT>
+void BasicCPU<BusT>::STA_LongX() {
+    const uint32_t base = FetchLong();
     const uint32_t address = base + X;
-    PC += 4;
 
     WriteRegisterToAddress(address, A, P & FLAG_M, 6);
 }
 
-void CPU::STA_StackRelative() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::STA_StackRelative() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = SP + offset;
 
     WriteRegisterToAddress(address, A, P & FLAG_M, 4);
 }
 
-void CPU::STA_DirectPageIndirectLong() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::STA_DirectPageIndirectLong() {
+    const uint8_t offset = FetchByte();
     const uint32_t indirect_addr = D + offset;
     const uint32_t target_address = ReadByte(indirect_addr) |
                              (ReadByte(indirect_addr + 1) << 8) |
@@ -1231,8 +1703,9 @@ void CPU::STA_DirectPageIndirectLong() {
     WriteWithDirectPagePenalty(target_address, A, P & FLAG_M, 6);
 }
 
-void CPU::STA_StackRelativeIndirectY() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::STA_StackRelativeIndirectY() {
+    const uint8_t offset = FetchByte();
     const uint32_t indirect_addr = SP + offset;
     const uint16_t base_address = ReadWord(indirect_addr);
     const uint16_t y_offset = (P & FLAG_X) ? (Y & 0xFF) : Y;
@@ -1241,8 +1714,9 @@ void CPU::STA_StackRelativeIndirectY() {
     WriteRegisterToAddress(target_address, A, P & FLAG_M, 7);
 }
 
-void CPU::STA_DirectPageIndirectLongY() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::STA_DirectPageIndirectLongY() {
+    const uint8_t offset = FetchByte();
     const uint32_t indirect_addr = D + offset;
     const uint32_t base_address = ReadByte(indirect_addr) |
                            (ReadByte(indirect_addr + 1) << 8) |
@@ -1255,9 +1729,9 @@ void CPU::STA_DirectPageIndirectLongY() {
 }
 
 // STX - Store X Register
-void CPU::STX_Absolute() {
-    const uint32_t address = ReadWord(PC + 1) | (DB << 16);
-    PC += 3;
+template <typename BusT>
+void BasicCPU<BusT>::STX_Absolute() {
+    const uint32_t address = FetchWord() | (DB << 16);
 
     if (P & FLAG_X) { // 8-bit mode
         WriteByte(address, X & 0xFF);
@@ -1268,10 +1742,10 @@ void CPU::STX_Absolute() {
     }
 }
 
-void CPU::STX_DirectPage() {
-    const uint8_t offset = ReadByte(PC + 1);
+template <typename BusT>
+void BasicCPU<BusT>::STX_DirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = (D + offset) & 0xFFFF;
-    PC += 2;
 
     if (P & FLAG_X) { // 8-bit mode
         WriteByte(address, X & 0xFF);
@@ -1284,10 +1758,10 @@ void CPU::STX_DirectPage() {
     }
 }
 
-void CPU::STX_DirectPageY() {
-    const uint8_t offset = ReadByte(PC + 1);
+template <typename BusT>
+void BasicCPU<BusT>::STX_DirectPageY() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = (D + offset + Y) & 0xFFFF;
-    PC += 2;
 
     if (P & FLAG_X) { // 8-bit mode
         WriteByte(address, X & 0xFF);
@@ -1301,9 +1775,9 @@ void CPU::STX_DirectPageY() {
 }
 
 // STY - Store Y Register
-void CPU::STY_Absolute() {
-    const uint32_t address = ReadWord(PC + 1) | (DB << 16);
-    PC += 3;
+template <typename BusT>
+void BasicCPU<BusT>::STY_Absolute() {
+    const uint32_t address = FetchWord() | (DB << 16);
 
     if (P & FLAG_X) { // 8-bit mode
         WriteByte(address, Y & 0xFF);
@@ -1314,10 +1788,10 @@ void CPU::STY_Absolute() {
     }
 }
 
-void CPU::STY_DirectPage() {
-    const uint8_t offset = ReadByte(PC + 1);
+template <typename BusT>
+void BasicCPU<BusT>::STY_DirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = (D + offset) & 0xFFFF;
-    PC += 2;
 
     if (P & FLAG_X) { // 8-bit mode
         WriteByte(address, Y & 0xFF);
@@ -1330,10 +1804,10 @@ void CPU::STY_DirectPage() {
     }
 }
 
-void CPU::STY_DirectPageX() {
-    const uint8_t offset = ReadByte(PC + 1);
+template <typename BusT>
+void BasicCPU<BusT>::STY_DirectPageX() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = (D + offset + X) & 0xFFFF;
-    PC += 2;
 
     if (P & FLAG_X) { // 8-bit mode
         WriteByte(address, Y & 0xFF);
@@ -1348,7 +1822,8 @@ void CPU::STY_DirectPageX() {
 
 // INC - Increment Memory
 // Important to note: PC doesn't increment in accumulator mode I think
-void CPU::INC_Accumulator() {
+template <typename BusT>
+void BasicCPU<BusT>::INC_Accumulator() {
     if (P & FLAG_M) { // 8-bit mode
         A = (A & 0xFF00) | ((A + 1) & 0xFF);
         UpdateNZ8(A & 0xFF);
@@ -1360,9 +1835,9 @@ void CPU::INC_Accumulator() {
     }
 }
 
-void CPU::INC_Absolute() {
-    const uint32_t address = ReadWord(PC + 1) | (DB << 16);
-    PC += 3;
+template <typename BusT>
+void BasicCPU<BusT>::INC_Absolute() {
+    const uint32_t address = FetchWord() | (DB << 16);
 
     if (P & FLAG_M) { // 8-bit mode
         uint8_t value = ReadByte(address);
@@ -1379,10 +1854,10 @@ void CPU::INC_Absolute() {
     }
 }
 
-void CPU::INC_AbsoluteX() {
-    const uint32_t base = ReadWord(PC + 1) | (DB << 16);
+template <typename BusT>
+void BasicCPU<BusT>::INC_AbsoluteX() {
+    const uint32_t base = FetchWord() | (DB << 16);
     const uint32_t address = base + X;
-    PC += 3;
 
     if (P & FLAG_M) { // 8-bit mode
         uint8_t value = ReadByte(address);
@@ -1399,10 +1874,10 @@ void CPU::INC_AbsoluteX() {
     }
 }
 
-void CPU::INC_DirectPage() {
-    const uint8_t offset = ReadByte(PC + 1);
+template <typename BusT>
+void BasicCPU<BusT>::INC_DirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = (D + offset) & 0xFFFF;
-    PC += 2;
 
     if (P & FLAG_M) { // 8-bit mode
         uint8_t value = ReadByte(address);
@@ -1421,10 +1896,10 @@ void CPU::INC_DirectPage() {
     }
 }
 
-void CPU::INC_DirectPageX() {
-    const uint8_t offset = ReadByte(PC + 1);
+template <typename BusT>
+void BasicCPU<BusT>::INC_DirectPageX() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = (D + offset + X) & 0xFFFF;
-    PC += 2;
 
     if (P & FLAG_M) { // 8-bit mode
         uint8_t value = ReadByte(address);
@@ -1444,7 +1919,8 @@ void CPU::INC_DirectPageX() {
 }
 
 // DEC - Decrement Memory
-void CPU::DEC_Accumulator() {
+template <typename BusT>
+void BasicCPU<BusT>::DEC_Accumulator() {
     if (P & FLAG_M) { // 8-bit mode
         A = (A & 0xFF00) | ((A - 1) & 0xFF);
         UpdateNZ8(A & 0xFF);
@@ -1456,9 +1932,9 @@ void CPU::DEC_Accumulator() {
     }
 }
 
-void CPU::DEC_Absolute() {
-    const uint32_t address = ReadWord(PC + 1) | (DB << 16);
-    PC += 3;
+template <typename BusT>
+void BasicCPU<BusT>::DEC_Absolute() {
+    const uint32_t address = FetchWord() | (DB << 16);
 
     if (P & FLAG_M) { // 8-bit mode
         uint8_t value = ReadByte(address);
@@ -1475,10 +1951,10 @@ void CPU::DEC_Absolute() {
     }
 }
 
-void CPU::DEC_AbsoluteX() {
-    const uint32_t base = ReadWord(PC + 1) | (DB << 16);
+template <typename BusT>
+void BasicCPU<BusT>::DEC_AbsoluteX() {
+    const uint32_t base = FetchWord() | (DB << 16);
     const uint32_t address = base + X;
-    PC += 3;
 
     if (P & FLAG_M) { // 8-bit mode
         uint8_t value = ReadByte(address);
@@ -1495,10 +1971,10 @@ void CPU::DEC_AbsoluteX() {
     }
 }
 
-void CPU::DEC_DirectPage() {
-    const uint8_t offset = ReadByte(PC + 1);
+template <typename BusT>
+void BasicCPU<BusT>::DEC_DirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = (D + offset) & 0xFFFF;
-    PC += 2;
 
     if (P & FLAG_M) { // 8-bit mode
         uint8_t value = ReadByte(address);
@@ -1517,10 +1993,10 @@ void CPU::DEC_DirectPage() {
     }
 }
 
-void CPU::DEC_DirectPageX() {
-    const uint8_t offset = ReadByte(PC + 1);
+template <typename BusT>
+void BasicCPU<BusT>::DEC_DirectPageX() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = (D + offset + X) & 0xFFFF;
-    PC += 2;
 
     if (P & FLAG_M) { // 8-bit mode
         uint8_t value = ReadByte(address);
@@ -1540,7 +2016,8 @@ void CPU::DEC_DirectPageX() {
 }
 
 // INX - Increment X Register
-void CPU::INX() {
+template <typename BusT>
+void BasicCPU<BusT>::INX() {
     if (P & FLAG_X) { // 8-bit mode
         X = (X & 0xFF00) | ((X + 1) & 0xFF);
         UpdateNZ8(X & 0xFF);
@@ -1552,7 +2029,8 @@ void CPU::INX() {
 }
 
 // INY - Increment Y Register
-void CPU::INY() {
+template <typename BusT>
+void BasicCPU<BusT>::INY() {
     if (P & FLAG_X) { // 8-bit mode
         Y = (Y & 0xFF00) | ((Y + 1) & 0xFF);
         UpdateNZ8(Y & 0xFF);
@@ -1564,7 +2042,8 @@ void CPU::INY() {
 }
 
 // DEX - Decrement X Register
-void CPU::DEX() {
+template <typename BusT>
+void BasicCPU<BusT>::DEX() {
     if (P & FLAG_X) { // 8-bit mode
         X = (X & 0xFF00) | ((X - 1) & 0xFF);
         UpdateNZ8(X & 0xFF);
@@ -1576,7 +2055,8 @@ void CPU::DEX() {
 }
 
 // DEY - Decrement Y Register
-void CPU::DEY() {
+template <typename BusT>
+void BasicCPU<BusT>::DEY() {
     if (P & FLAG_X) { // 8-bit mode
         Y = (Y & 0xFF00) | ((Y - 1) & 0xFF);
         UpdateNZ8(Y & 0xFF);
@@ -1588,23 +2068,22 @@ void CPU::DEY() {
 }
 
 // CMP - Compare Accumulator
-void CPU::CMP_Immediate() {
+template <typename BusT>
+void BasicCPU<BusT>::CMP_Immediate() {
     if (P & FLAG_M) { // 8-bit mode
-        const uint8_t operand = ReadByte(PC + 1);
+        const uint8_t operand = FetchByte();
         UpdateCompareFlags8(A & 0xFF, operand);
-        PC += 2;
         cycles += 2;
     } else { // 16-bit mode
-        const uint16_t operand = ReadWord(PC + 1);
+        const uint16_t operand = FetchWord();
         UpdateCompareFlags16(A, operand);
-        PC += 3;
         cycles += 3;
     }
 }
 
-void CPU::CMP_Absolute() {
-    const uint32_t address = ReadWord(PC + 1) | (DB << 16);
-    PC += 3;
+template <typename BusT>
+void BasicCPU<BusT>::CMP_Absolute() {
+    const uint32_t address = FetchWord() | (DB << 16);
 
     if (P & FLAG_M) { // 8-bit mode
         const uint8_t operand = ReadByte(address);
@@ -1617,10 +2096,10 @@ void CPU::CMP_Absolute() {
     }
 }
 
-void CPU::CMP_AbsoluteX() {
-    const uint32_t base = ReadWord(PC + 1) | (DB << 16);
+template <typename BusT>
+void BasicCPU<BusT>::CMP_AbsoluteX() {
+    const uint32_t base = FetchWord() | (DB << 16);
     const uint32_t address = base + X;
-    PC += 3;
 
     if (P & FLAG_M) { // 8-bit mode
         const uint8_t operand = ReadByte(address);
@@ -1637,10 +2116,10 @@ void CPU::CMP_AbsoluteX() {
     }
 }
 
-void CPU::CMP_AbsoluteY() {
-    const uint32_t base = ReadWord(PC + 1) | (DB << 16);
+template <typename BusT>
+void BasicCPU<BusT>::CMP_AbsoluteY() {
+    const uint32_t base = FetchWord() | (DB << 16);
     const uint32_t address = base + Y;
-    PC += 3;
 
     if (P & FLAG_M) { // 8-bit mode
         const uint8_t operand = ReadByte(address);
@@ -1657,10 +2136,10 @@ void CPU::CMP_AbsoluteY() {
     }
 }
 
-void CPU::CMP_DirectPage() {
-    const uint8_t offset = ReadByte(PC + 1);
+template <typename BusT>
+void BasicCPU<BusT>::CMP_DirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = (D + offset) & 0xFFFF;
-    PC += 2;
 
     if (P & FLAG_M) { // 8-bit mode
         const uint8_t operand = ReadByte(address);
@@ -1675,10 +2154,10 @@ void CPU::CMP_DirectPage() {
     }
 }
 
-void CPU::CMP_DirectPageX() {
-    const uint8_t offset = ReadByte(PC + 1);
+template <typename BusT>
+void BasicCPU<BusT>::CMP_DirectPageX() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = (D + offset + X) & 0xFFFF;
-    PC += 2;
 
     if (P & FLAG_M) { // 8-bit mode
         const uint8_t operand = ReadByte(address);
@@ -1693,11 +2172,11 @@ void CPU::CMP_DirectPageX() {
     }
 }
 
-void CPU::CMP_IndirectDirectPage() {
-    const uint8_t offset = ReadByte(PC + 1);
+template <typename BusT>
+void BasicCPU<BusT>::CMP_IndirectDirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer = (D + offset) & 0xFFFF;
     const uint32_t address = ReadWord(pointer) | (DB << 16);
-    PC += 2;
 
     if (P & FLAG_M) { // 8-bit mode
         uint8_t operand = ReadByte(address);
@@ -1712,12 +2191,12 @@ void CPU::CMP_IndirectDirectPage() {
     }
 }
 
-void CPU::CMP_IndirectDirectPageY() {
-    const uint8_t offset = ReadByte(PC + 1);
+template <typename BusT>
+void BasicCPU<BusT>::CMP_IndirectDirectPageY() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer = (D + offset) & 0xFFFF;
     const uint32_t base = ReadWord(pointer) | (DB << 16);
     const uint32_t address = base + Y;
-    PC += 2;
 
     if (P & FLAG_M) { // 8-bit mode
         const uint8_t operand = ReadByte(address);
@@ -1736,11 +2215,11 @@ void CPU::CMP_IndirectDirectPageY() {
     }
 }
 
-void CPU::CMP_DirectPageIndirectX() {
-    const uint8_t offset = ReadByte(PC + 1);
+template <typename BusT>
+void BasicCPU<BusT>::CMP_DirectPageIndirectX() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer = (D + offset + X) & 0xFFFF;
     const uint32_t address = ReadWord(pointer) | (DB << 16);
-    PC += 2;
 
     if (P & FLAG_M) { // 8-bit mode
         const uint8_t operand = ReadByte(address);
@@ -1755,9 +2234,9 @@ void CPU::CMP_DirectPageIndirectX() {
     }
 }
 
-void CPU::CMP_Long() {
-    const uint32_t address = ReadByte(PC + 1) | (ReadByte(PC + 2) << 8) | (ReadByte(PC + 3) << 16);
-    PC += 4;
+template <typename BusT>
+void BasicCPU<BusT>::CMP_Long() {
+    const uint32_t address = FetchLong();
 
     if (P & FLAG_M) { // 8-bit mode
         const uint8_t operand = ReadByte(address);
@@ -1770,10 +2249,10 @@ void CPU::CMP_Long() {
     }
 }
 
-void CPU::CMP_LongX() {
-    const uint32_t base = ReadByte(PC + 1) | (ReadByte(PC + 2) << 8) | (ReadByte(PC + 3) << 16);
+template <typename BusT>
+void BasicCPU<BusT>::CMP_LongX() {
+    const uint32_t base = FetchLong();
     const uint32_t address = base + X;
-    PC += 4;
 
     if (P & FLAG_M) { // 8-bit mode
         const uint8_t operand = ReadByte(address);
@@ -1787,23 +2266,22 @@ void CPU::CMP_LongX() {
 }
 
 // CPX - Compare X Register
-void CPU::CPX_Immediate() {
+template <typename BusT>
+void BasicCPU<BusT>::CPX_Immediate() {
     if (P & FLAG_X) { // 8-bit mode
-        const uint8_t operand = ReadByte(PC + 1);
+        const uint8_t operand = FetchByte();
         UpdateCompareFlags8(X & 0xFF, operand);
-        PC += 2;
         cycles += 2;
     } else { // 16-bit mode
-        const uint16_t operand = ReadWord(PC + 1);
+        const uint16_t operand = FetchWord();
         UpdateCompareFlags16(X, operand);
-        PC += 3;
         cycles += 3;
     }
 }
 
-void CPU::CPX_Absolute() {
-    const uint32_t address = ReadWord(PC + 1) | (DB << 16);
-    PC += 3;
+template <typename BusT>
+void BasicCPU<BusT>::CPX_Absolute() {
+    const uint32_t address = FetchWord() | (DB << 16);
 
     if (P & FLAG_X) { // 8-bit mode
         const uint8_t operand = ReadByte(address);
@@ -1816,10 +2294,10 @@ void CPU::CPX_Absolute() {
     }
 }
 
-void CPU::CPX_DirectPage() {
-    const uint8_t offset = ReadByte(PC + 1);
+template <typename BusT>
+void BasicCPU<BusT>::CPX_DirectPage() {
+    const uint8_t offset = FetchByte();
     const int32_t address = (D + offset) & 0xFFFF;
-    PC += 2;
 
     if (P & FLAG_X) { // 8-bit mode
         const uint8_t operand = ReadByte(address);
@@ -1835,23 +2313,22 @@ void CPU::CPX_DirectPage() {
 }
 
 // CPY - Compare Y Register
-void CPU::CPY_Immediate() {
+template <typename BusT>
+void BasicCPU<BusT>::CPY_Immediate() {
     if (P & FLAG_X) { // 8-bit mode
-        const uint8_t operand = ReadByte(PC + 1);
+        const uint8_t operand = FetchByte();
         UpdateCompareFlags8(Y & 0xFF, operand);
-        PC += 2;
         cycles += 2;
     } else { // 16-bit mode
-        const uint16_t operand = ReadWord(PC + 1);
+        const uint16_t operand = FetchWord();
         UpdateCompareFlags16(Y, operand);
-        PC += 3;
         cycles += 3;
     }
 }
 
-void CPU::CPY_Absolute() {
-    const uint32_t address = ReadWord(PC + 1) | (DB << 16);
-    PC += 3;
+template <typename BusT>
+void BasicCPU<BusT>::CPY_Absolute() {
+    const uint32_t address = FetchWord() | (DB << 16);
 
     if (P & FLAG_X) { // 8-bit mode
         const uint8_t operand = ReadByte(address);
@@ -1864,10 +2341,10 @@ void CPU::CPY_Absolute() {
     }
 }
 
-void CPU::CPY_DirectPage() {
-    const uint8_t offset = ReadByte(PC + 1);
+template <typename BusT>
+void BasicCPU<BusT>::CPY_DirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = (D + offset) & 0xFFFF;
-    PC += 2;
 
     if (P & FLAG_X) { // 8-bit mode
         const uint8_t operand = ReadByte(address);
@@ -1882,18 +2359,19 @@ void CPU::CPY_DirectPage() {
     }
 }
 
-void CPU::JMP_Absolute() {
-    const uint16_t address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::JMP_Absolute() {
+    const uint16_t address = FetchWord();
 
     PC = (static_cast<uint32_t>(PB) << 16) | address;
 
     cycles += 3;
+    CheckIdleLoop();
 }
 
-void CPU::JMP_AbsoluteIndirect() {
-    const uint16_t indirect_addr = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::JMP_AbsoluteIndirect() {
+    const uint16_t indirect_addr = FetchWord();
 
     const uint32_t full_indirect_addr = (static_cast<uint32_t>(DB) << 16) | indirect_addr;
     const uint16_t target_addr = ReadWord(full_indirect_addr);
@@ -1903,11 +2381,10 @@ void CPU::JMP_AbsoluteIndirect() {
     cycles += 5;
 }
 
-void CPU::JMP_AbsoluteLong() {
-    const uint16_t addr_low = ReadWord(PC);
-    PC += 2;
-    const uint8_t addr_high = ReadByte(PC);
-    PC++;
+template <typename BusT>
+void BasicCPU<BusT>::JMP_AbsoluteLong() {
+    const uint16_t addr_low = FetchWord();
+    const uint8_t addr_high = FetchByte();
 
     const uint32_t target_addr = (static_cast<uint32_t>(addr_high) << 16) | addr_low;
 
@@ -1915,11 +2392,12 @@ void CPU::JMP_AbsoluteLong() {
     PC = target_addr;
 
     cycles += 4;
+    CheckIdleLoop();
 }
 
-void CPU::JMP_AbsoluteIndirectX() {
-    const uint16_t base_addr = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::JMP_AbsoluteIndirectX() {
+    const uint16_t base_addr = FetchWord();
 
     const uint32_t indirect_addr = (static_cast<uint32_t>(PB) << 16) | (base_addr + X);
 
@@ -1930,33 +2408,39 @@ void CPU::JMP_AbsoluteIndirectX() {
     cycles += 6;
 }
 
-void CPU::BEQ_Relative() {
-    DoBranch(P & FLAG_Z);
+template <typename BusT>
+void BasicCPU<BusT>::BEQ_Relative() {
+    DoBranch(flag_z == 0);
 }
 
-void CPU::BNE_Relative() {
-    DoBranch(!(P & FLAG_Z));
+template <typename BusT>
+void BasicCPU<BusT>::BNE_Relative() {
+    DoBranch(flag_z != 0);
 }
 
-void CPU::BCC_Relative() {
-    DoBranch(!(P & FLAG_C));
+template <typename BusT>
+void BasicCPU<BusT>::BCC_Relative() {
+    DoBranch(!flag_c);
 }
 
-void CPU::BCS_Relative() {
-    DoBranch(P & FLAG_C);
+template <typename BusT>
+void BasicCPU<BusT>::BCS_Relative() {
+    DoBranch(flag_c);
 }
 
-void CPU::BMI_Relative() {
-    DoBranch(P & FLAG_N);
+template <typename BusT>
+void BasicCPU<BusT>::BMI_Relative() {
+    DoBranch(flag_n & 0x8000);
 }
 
-void CPU::BPL_Relative() {
-    DoBranch(!(P & FLAG_N));
+template <typename BusT>
+void BasicCPU<BusT>::BPL_Relative() {
+    DoBranch(!(flag_n & 0x8000));
 }
 
-void CPU::JSR_Absolute() {
-    const uint16_t target_addr = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::JSR_Absolute() {
+    const uint16_t target_addr = FetchWord();
 
     const uint16_t return_addr = (PC - 1) & 0xFFFF;
     PushWord(return_addr);
@@ -1966,11 +2450,10 @@ void CPU::JSR_Absolute() {
     cycles += 6;
 }
 
-void CPU::JSR_AbsoluteLong() {
-    const uint16_t addr_low = ReadWord(PC);
-    PC += 2;
-    const uint8_t addr_high = ReadByte(PC);
-    PC++;
+template <typename BusT>
+void BasicCPU<BusT>::JSR_AbsoluteLong() {
+    const uint16_t addr_low = FetchWord();
+    const uint8_t addr_high = FetchByte();
 
     PushByte(PB);
 
@@ -1983,9 +2466,9 @@ void CPU::JSR_AbsoluteLong() {
     cycles += 8;
 }
 
-void CPU::JSR_AbsoluteIndirectX() {
-    const uint16_t base_addr = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::JSR_AbsoluteIndirectX() {
+    const uint16_t base_addr = FetchWord();
 
     const uint32_t indirect_addr = (static_cast<uint32_t>(PB) << 16) | ((base_addr + X) & 0xFFFF);
 
@@ -1999,7 +2482,8 @@ void CPU::JSR_AbsoluteIndirectX() {
     cycles += 8;
 }
 
-void CPU::RTS() {
+template <typename BusT>
+void BasicCPU<BusT>::RTS() {
     const uint16_t return_addr = PopWord();
 
     PC = (static_cast<uint32_t>(PB) << 16) | ((return_addr + 1) & 0xFFFF);
@@ -2007,7 +2491,8 @@ void CPU::RTS() {
     cycles += 6;
 }
 
-void CPU::RTL() {
+template <typename BusT>
+void BasicCPU<BusT>::RTL() {
     const uint16_t return_addr = PopWord();
 
     PB = PopByte();
@@ -2017,7 +2502,8 @@ void CPU::RTL() {
     cycles += 6;
 }
 
-void CPU::PHA() {
+template <typename BusT>
+void BasicCPU<BusT>::PHA() {
     if (P & FLAG_M) {
         // 8-bit mode: push low byte of accumulator
         PushByte(A & 0xFF);
@@ -2029,7 +2515,8 @@ void CPU::PHA() {
     }
 }
 
-void CPU::PLA() {
+template <typename BusT>
+void BasicCPU<BusT>::PLA() {
     if (P & FLAG_M) {
         // 8-bit mode: pull into low byte, clear high byte
         A = PopByte();
@@ -2043,7 +2530,8 @@ void CPU::PLA() {
     }
 }
 
-void CPU::PHX() {
+template <typename BusT>
+void BasicCPU<BusT>::PHX() {
     if (P & FLAG_X) {
         // 8-bit mode: push low byte of X
         PushByte(X & 0xFF);
@@ -2055,7 +2543,8 @@ void CPU::PHX() {
     }
 }
 
-void CPU::PLX() {
+template <typename BusT>
+void BasicCPU<BusT>::PLX() {
     if (P & FLAG_X) {
         // 8-bit mode: pull into low byte, clear high byte
         X = PopByte();
@@ -2069,7 +2558,8 @@ void CPU::PLX() {
     }
 }
 
-void CPU::PHY() {
+template <typename BusT>
+void BasicCPU<BusT>::PHY() {
     if (P & FLAG_X) {
         // 8-bit mode: push low byte of Y
         PushByte(Y & 0xFF);
@@ -2081,7 +2571,8 @@ void CPU::PHY() {
     }
 }
 
-void CPU::PLY() {
+template <typename BusT>
+void BasicCPU<BusT>::PLY() {
     if (P & FLAG_X) {
         // 8-bit mode: pull into low byte, clear high byte
         Y = PopByte();
@@ -2095,62 +2586,68 @@ void CPU::PLY() {
     }
 }
 
-void CPU::PHP() {
-    PushByte(P);
+template <typename BusT>
+void BasicCPU<BusT>::PHP() {
+    PushByte(GetP());
     cycles += 3;
 }
 
-void CPU::PLP() {
-    P = PopByte();
+template <typename BusT>
+void BasicCPU<BusT>::PLP() {
+    SetP(PopByte());
     cycles += 4;
 }
 
-void CPU::PHB() {
+template <typename BusT>
+void BasicCPU<BusT>::PHB() {
     PushByte(DB);
     cycles += 3;
 }
 
-void CPU::PLB() {
+template <typename BusT>
+void BasicCPU<BusT>::PLB() {
     DB = PopByte();
     UpdateNZ8(DB);
     cycles += 4;
 }
 
-void CPU::PHD() {
+template <typename BusT>
+void BasicCPU<BusT>::PHD() {
     PushWord(D);
     cycles += 4;
 }
 
-void CPU::PLD() {
+template <typename BusT>
+void BasicCPU<BusT>::PLD() {
     D = PopWord();
     UpdateNZ16(D);
     cycles += 5;
 }
 
-void CPU::PHK() {
+template <typename BusT>
+void BasicCPU<BusT>::PHK() {
     PushByte(PB);
     cycles += 3;
 }
 
-void CPU::ADC_Immediate() {
+template <typename BusT>
+void BasicCPU<BusT>::ADC_Immediate() {
     if (P & FLAG_M) {
         // 8-bit immediate
-        const uint8_t value = ReadByte(PC);
-        PC++;
+        const uint8_t value = FetchByte();
         DoADC(value);
         cycles += 2;
     } else {
         // 16-bit immediate
-        const uint16_t value = ReadWord(PC);
-        PC += 2;
+        const uint16_t value = FetchWord();
         DoADC(value);
         cycles += 3;
     }
 }
 
-void CPU::ADC_Absolute() {
-    const uint16_t address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::ADC_Absolute() {
+    const uint16_t address = FetchWord();
 
     const uint32_t full_address = (static_cast<uint32_t>(DB) << 16) | address;
 
@@ -2165,9 +2662,9 @@ void CPU::ADC_Absolute() {
     }
 }
 
-void CPU::ADC_AbsoluteX() {
-    const uint16_t base_address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::ADC_AbsoluteX() {
+    const uint16_t base_address = FetchWord();
 
     const uint32_t full_address = (static_cast<uint32_t>(DB) << 16) | ((base_address + X) & 0xFFFF);
 
@@ -2188,9 +2685,9 @@ void CPU::ADC_AbsoluteX() {
     }
 }
 
-void CPU::ADC_AbsoluteY() {
-    const uint16_t base_address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::ADC_AbsoluteY() {
+    const uint16_t base_address = FetchWord();
 
     const uint32_t full_address = (static_cast<uint32_t>(DB) << 16) | ((base_address + Y) & 0xFFFF);
 
@@ -2211,9 +2708,9 @@ void CPU::ADC_AbsoluteY() {
     }
 }
 
-void CPU::ADC_DirectPage() {
-    const uint8_t offset = ReadByte(PC);
-    PC++;
+template <typename BusT>
+void BasicCPU<BusT>::ADC_DirectPage() {
+    const uint8_t offset = FetchByte();
 
     const uint32_t address = D + offset;
 
@@ -2230,9 +2727,9 @@ void CPU::ADC_DirectPage() {
     }
 }
 
-void CPU::ADC_DirectPageX() {
-    const uint8_t offset = ReadByte(PC);
-    PC++;
+template <typename BusT>
+void BasicCPU<BusT>::ADC_DirectPageX() {
+    const uint8_t offset = FetchByte();
 
     const uint32_t address = D + offset + X;
 
@@ -2249,9 +2746,9 @@ void CPU::ADC_DirectPageX() {
     }
 }
 
-void CPU::ADC_IndirectDirectPage() {
-    const uint8_t offset = ReadByte(PC);
-    PC++;
+template <typename BusT>
+void BasicCPU<BusT>::ADC_IndirectDirectPage() {
+    const uint8_t offset = FetchByte();
 
     const uint32_t pointer_address = D + offset;
     const uint16_t target_address = ReadWord(pointer_address);
@@ -2270,9 +2767,9 @@ void CPU::ADC_IndirectDirectPage() {
     }
 }
 
-void CPU::ADC_IndirectDirectPageY() {
-    const uint8_t offset = ReadByte(PC);
-    PC++;
+template <typename BusT>
+void BasicCPU<BusT>::ADC_IndirectDirectPageY() {
+    const uint8_t offset = FetchByte();
 
     const uint32_t pointer_address = D + offset;
     const uint16_t base_address = ReadWord(pointer_address);
@@ -2297,9 +2794,9 @@ void CPU::ADC_IndirectDirectPageY() {
     }
 }
 
-void CPU::ADC_DirectPageIndirectX() {
-    const uint8_t offset = ReadByte(PC);
-    PC++;
+template <typename BusT>
+void BasicCPU<BusT>::ADC_DirectPageIndirectX() {
+    const uint8_t offset = FetchByte();
 
     const uint32_t pointer_address = D + offset + X;
     const uint16_t target_address = ReadWord(pointer_address);
@@ -2318,11 +2815,10 @@ void CPU::ADC_DirectPageIndirectX() {
     }
 }
 
-void CPU::ADC_AbsoluteLong() {
-    const uint16_t addr_low = ReadWord(PC);
-    PC += 2;
-    const uint8_t addr_high = ReadByte(PC);
-    PC++;
+template <typename BusT>
+void BasicCPU<BusT>::ADC_AbsoluteLong() {
+    const uint16_t addr_low = FetchWord();
+    const uint8_t addr_high = FetchByte();
 
     const uint32_t full_address = (static_cast<uint32_t>(addr_high) << 16) | addr_low;
 
@@ -2337,11 +2833,10 @@ void CPU::ADC_AbsoluteLong() {
     }
 }
 
-void CPU::ADC_AbsoluteLongX() {
-    const uint16_t addr_low = ReadWord(PC);
-    PC += 2;
-    const uint8_t addr_high = ReadByte(PC);
-    PC++;
+template <typename BusT>
+void BasicCPU<BusT>::ADC_AbsoluteLongX() {
+    const uint16_t addr_low = FetchWord();
+    const uint8_t addr_high = FetchByte();
 
     const uint32_t base_address = (static_cast<uint32_t>(addr_high) << 16) | addr_low;
     const uint32_t full_address = base_address + X;
@@ -2357,9 +2852,9 @@ void CPU::ADC_AbsoluteLongX() {
     }
 }
 
-void CPU::ADC_DirectPageIndirectLong() {
-    const uint8_t offset = ReadByte(PC);
-    PC++;
+template <typename BusT>
+void BasicCPU<BusT>::ADC_DirectPageIndirectLong() {
+    const uint8_t offset = FetchByte();
 
     const uint32_t pointer_address = D + offset;
     const uint16_t addr_low = ReadWord(pointer_address);
@@ -2379,9 +2874,9 @@ void CPU::ADC_DirectPageIndirectLong() {
     }
 }
 
-void CPU::ADC_DirectPageIndirectLongY() {
-    const uint8_t offset = ReadByte(PC);
-    PC++;
+template <typename BusT>
+void BasicCPU<BusT>::ADC_DirectPageIndirectLongY() {
+    const uint8_t offset = FetchByte();
 
     const uint32_t pointer_address = D + offset;
     const uint16_t addr_low = ReadWord(pointer_address);
@@ -2402,9 +2897,9 @@ void CPU::ADC_DirectPageIndirectLongY() {
     }
 }
 
-void CPU::ADC_StackRelative() {
-    const uint8_t offset = ReadByte(PC);
-    PC++;
+template <typename BusT>
+void BasicCPU<BusT>::ADC_StackRelative() {
+    const uint8_t offset = FetchByte();
 
     const uint32_t address = SP + offset;
 
@@ -2419,9 +2914,9 @@ void CPU::ADC_StackRelative() {
     }
 }
 
-void CPU::ADC_StackRelativeIndirectY() {
-    const uint8_t offset = ReadByte(PC);
-    PC++;
+template <typename BusT>
+void BasicCPU<BusT>::ADC_StackRelativeIndirectY() {
+    const uint8_t offset = FetchByte();
 
     const uint32_t pointer_address = SP + offset;
     const uint16_t base_address = ReadWord(pointer_address);
@@ -2438,24 +2933,24 @@ void CPU::ADC_StackRelativeIndirectY() {
     }
 }
 
-void CPU::AND_Immediate() {
+template <typename BusT>
+void BasicCPU<BusT>::AND_Immediate() {
     if (P & FLAG_M) { // 8-bit mode
-        const uint8_t operand = ReadByte(PC++);
+        const uint8_t operand = FetchByte();
         A = (A & 0xFF00) | ((A & 0xFF) & operand);
         UpdateNZ8(A & 0xFF);
         cycles += 2;
     } else { // 16-bit mode
-        const uint16_t operand = ReadWord(PC);
-        PC += 2;
+        const uint16_t operand = FetchWord();
         A &= operand;
         UpdateNZ16(A);
         cycles += 3;
     }
 }
 
-void CPU::AND_Absolute() {
-    const uint16_t address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::AND_Absolute() {
+    const uint16_t address = FetchWord();
     const uint32_t full_address = (DB << 16) | address;
 
     if (P & FLAG_M) { // 8-bit mode
@@ -2471,9 +2966,9 @@ void CPU::AND_Absolute() {
     }
 }
 
-void CPU::AND_AbsoluteX() {
-    const uint16_t base_address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::AND_AbsoluteX() {
+    const uint16_t base_address = FetchWord();
     const uint32_t full_address = (DB << 16) | (base_address + X);
 
     if (P & FLAG_M) { // 8-bit mode
@@ -2495,9 +2990,9 @@ void CPU::AND_AbsoluteX() {
     }
 }
 
-void CPU::AND_AbsoluteY() {
-    const uint16_t base_address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::AND_AbsoluteY() {
+    const uint16_t base_address = FetchWord();
     const uint32_t full_address = (DB << 16) | (base_address + Y);
 
     if (P & FLAG_M) { // 8-bit mode
@@ -2519,8 +3014,9 @@ void CPU::AND_AbsoluteY() {
     }
 }
 
-void CPU::AND_DirectPage() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::AND_DirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = D + offset;
 
     if (P & FLAG_M) { // 8-bit mode
@@ -2538,8 +3034,9 @@ void CPU::AND_DirectPage() {
     }
 }
 
-void CPU::AND_DirectPageX() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::AND_DirectPageX() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = D + offset + X;
 
     if (P & FLAG_M) { // 8-bit mode
@@ -2557,8 +3054,9 @@ void CPU::AND_DirectPageX() {
     }
 }
 
-void CPU::AND_IndirectDirectPage() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::AND_IndirectDirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer_address = D + offset;
     const uint16_t indirect_address = ReadWord(pointer_address);
     const uint32_t full_address = (DB << 16) | indirect_address;
@@ -2578,8 +3076,9 @@ void CPU::AND_IndirectDirectPage() {
     }
 }
 
-void CPU::AND_IndirectDirectPageLong() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::AND_IndirectDirectPageLong() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer_address = D + offset;
     const uint32_t full_address = ReadByte(pointer_address) |
                            (ReadByte(pointer_address + 1) << 8) |
@@ -2600,8 +3099,9 @@ void CPU::AND_IndirectDirectPageLong() {
     }
 }
 
-void CPU::AND_IndexedIndirectDirectPageX() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::AND_IndexedIndirectDirectPageX() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer_address = D + offset + X;
     const uint16_t indirect_address = ReadWord(pointer_address);
     const uint32_t full_address = (DB << 16) | indirect_address;
@@ -2621,8 +3121,9 @@ void CPU::AND_IndexedIndirectDirectPageX() {
     }
 }
 
-void CPU::AND_IndirectDirectPageY() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::AND_IndirectDirectPageY() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer_address = D + offset;
     const uint16_t base_address = ReadWord(pointer_address);
     const uint32_t full_address = (DB << 16) | (base_address + Y);
@@ -2648,8 +3149,9 @@ void CPU::AND_IndirectDirectPageY() {
     }
 }
 
-void CPU::AND_IndirectDirectPageLongY() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::AND_IndirectDirectPageLongY() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer_address = D + offset;
     const uint32_t base_address = ReadByte(pointer_address) |
                            (ReadByte(pointer_address + 1) << 8) |
@@ -2671,9 +3173,9 @@ void CPU::AND_IndirectDirectPageLongY() {
     }
 }
 
-void CPU::AND_AbsoluteLong() {
-    const uint32_t address = ReadByte(PC) | (ReadByte(PC + 1) << 8) | (ReadByte(PC + 2) << 16);
-    PC += 3;
+template <typename BusT>
+void BasicCPU<BusT>::AND_AbsoluteLong() {
+    const uint32_t address = FetchLong();
 
     if (P & FLAG_M) { // 8-bit mode
         const uint8_t operand = ReadByte(address);
@@ -2688,9 +3190,9 @@ void CPU::AND_AbsoluteLong() {
     }
 }
 
-void CPU::AND_AbsoluteLongX() {
-    const uint32_t base_address = ReadByte(PC) | (ReadByte(PC + 1) << 8) | (ReadByte(PC + 2) << 16);
-    PC += 3;
+template <typename BusT>
+void BasicCPU<BusT>::AND_AbsoluteLongX() {
+    const uint32_t base_address = FetchLong();
     const uint32_t full_address = base_address + X;
 
     if (P & FLAG_M) { // 8-bit mode
@@ -2706,8 +3208,9 @@ void CPU::AND_AbsoluteLongX() {
     }
 }
 
-void CPU::AND_StackRelative() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::AND_StackRelative() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = SP + offset;
 
     if (P & FLAG_M) { // 8-bit mode
@@ -2723,8 +3226,9 @@ void CPU::AND_StackRelative() {
     }
 }
 
-void CPU::AND_StackRelativeIndirectY() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::AND_StackRelativeIndirectY() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer_address = SP + offset;
     const uint16_t base_address = ReadWord(pointer_address);
     const uint32_t full_address = (DB << 16) | (base_address + Y);
@@ -2742,7 +3246,8 @@ void CPU::AND_StackRelativeIndirectY() {
     }
 }
 
-void CPU::ASL_Accumulator() {
+template <typename BusT>
+void BasicCPU<BusT>::ASL_Accumulator() {
     if (P & FLAG_M) { // 8-bit mode
         const uint8_t original = A & 0xFF;
         const uint8_t result = original << 1;
@@ -2758,9 +3263,9 @@ void CPU::ASL_Accumulator() {
     }
 }
 
-void CPU::ASL_Absolute() {
-    const uint16_t address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::ASL_Absolute() {
+    const uint16_t address = FetchWord();
     const uint32_t full_address = (DB << 16) | address;
 
     if (P & FLAG_M) { // 8-bit mode
@@ -2778,9 +3283,9 @@ void CPU::ASL_Absolute() {
     }
 }
 
-void CPU::ASL_AbsoluteX() {
-    const uint16_t base_address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::ASL_AbsoluteX() {
+    const uint16_t base_address = FetchWord();
     const uint32_t full_address = (DB << 16) | (base_address + X);
 
     if (P & FLAG_M) { // 8-bit mode
@@ -2798,8 +3303,9 @@ void CPU::ASL_AbsoluteX() {
     }
 }
 
-void CPU::ASL_DirectPage() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::ASL_DirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = D + offset;
 
     if (P & FLAG_M) { // 8-bit mode
@@ -2819,8 +3325,9 @@ void CPU::ASL_DirectPage() {
     }
 }
 
-void CPU::ASL_DirectPageX() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::ASL_DirectPageX() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = D + offset + X;
 
     if (P & FLAG_M) { // 8-bit mode
@@ -2840,22 +3347,22 @@ void CPU::ASL_DirectPageX() {
     }
 }
 
-void CPU::BIT_Immediate() {
+template <typename BusT>
+void BasicCPU<BusT>::BIT_Immediate() {
     if (P & FLAG_M) { // 8-bit mode
-        const uint8_t operand = ReadByte(PC++);
+        const uint8_t operand = FetchByte();
         UpdateBITImmediateFlags8(operand, A & 0xFF);
         cycles += 2;
     } else { // 16-bit mode
-        const uint16_t operand = ReadWord(PC);
-        PC += 2;
+        const uint16_t operand = FetchWord();
         UpdateBITImmediateFlags16(operand, A);
         cycles += 3;
     }
 }
 
-void CPU::BIT_Absolute() {
-    const uint16_t address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::BIT_Absolute() {
+    const uint16_t address = FetchWord();
     const uint32_t full_address = (DB << 16) | address;
 
     if (P & FLAG_M) { // 8-bit mode
@@ -2869,9 +3376,9 @@ void CPU::BIT_Absolute() {
     }
 }
 
-void CPU::BIT_AbsoluteX() {
-    const uint16_t base_address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::BIT_AbsoluteX() {
+    const uint16_t base_address = FetchWord();
     const uint32_t full_address = (DB << 16) | (base_address + X);
 
     if (P & FLAG_M) { // 8-bit mode
@@ -2891,8 +3398,9 @@ void CPU::BIT_AbsoluteX() {
     }
 }
 
-void CPU::BIT_DirectPage() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::BIT_DirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = D + offset;
 
     if (P & FLAG_M) { // 8-bit mode
@@ -2908,8 +3416,9 @@ void CPU::BIT_DirectPage() {
     }
 }
 
-void CPU::BIT_DirectPageX() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::BIT_DirectPageX() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = D + offset + X;
 
     if (P & FLAG_M) { // 8-bit mode
@@ -2925,33 +3434,35 @@ void CPU::BIT_DirectPageX() {
     }
 }
 
-void CPU::BRA_Relative() {
-    DoBranch(true);
-    cycles += 2;
+template <typename BusT>
+void BasicCPU<BusT>::BRA_Relative() {
+    DoBranch(true, 2);
 }
 
-void CPU::BRL_RelativeLong() {
-    const int16_t offset = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::BRL_RelativeLong() {
+    const int16_t offset = FetchWord();
 
     const uint16_t current_pc = PC & 0xFFFF;
     const uint16_t new_pc = current_pc + offset;
     PC = (PC & 0xFF0000) | new_pc;
 
     cycles += 4;
+    CheckIdleLoop();
 }
 
-void CPU::BVC_Relative() {
-    DoBranch(!(P & FLAG_V));
-    cycles += 2;
+template <typename BusT>
+void BasicCPU<BusT>::BVC_Relative() {
+    DoBranch(!flag_v, 2);
 }
 
-void CPU::BVS_Relative() {
-    DoBranch(P & FLAG_V);
-    cycles += 2;
+template <typename BusT>
+void BasicCPU<BusT>::BVS_Relative() {
+    DoBranch(flag_v, 2);
 }
 
-void CPU::BRK() {
+template <typename BusT>
+void BasicCPU<BusT>::BRK() {
     PC++;
 
     if (!emulation_mode) {
@@ -2959,7 +3470,7 @@ void CPU::BRK() {
 
         PushWord(PC);
 
-        PushByte(P | 0x10);
+        PushByte(GetP() | 0x10);
 
         P |= FLAG_I;
 
@@ -2974,7 +3485,7 @@ void CPU::BRK() {
     } else {    //Emulation mode
         PushWord(PC);
 
-        PushByte(P | 0x30);
+        PushByte(GetP() | 0x30);
 
         P |= FLAG_I;
 
@@ -2987,28 +3498,33 @@ void CPU::BRK() {
     }
 }
 
-void CPU::CLC() {
-    P &= ~FLAG_C;
+template <typename BusT>
+void BasicCPU<BusT>::CLC() {
+    flag_c = false;
     cycles += 2;
 }
 
-void CPU::CLD() {
+template <typename BusT>
+void BasicCPU<BusT>::CLD() {
     P &= ~FLAG_D;
     cycles += 2;
 }
 
-void CPU::CLI() {
+template <typename BusT>
+void BasicCPU<BusT>::CLI() {
     P &= ~FLAG_I;
     cycles += 2;
 }
 
-void CPU::CLV() {
-    P &= ~FLAG_V;
+template <typename BusT>
+void BasicCPU<BusT>::CLV() {
+    flag_v = false;
     cycles += 2;
 }
 
-void CPU::CMP_StackRelative() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::CMP_StackRelative() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = SP + offset;
 
     if (P & FLAG_M) { // 8-bit mode
@@ -3022,8 +3538,9 @@ void CPU::CMP_StackRelative() {
     }
 }
 
-void CPU::CMP_IndirectDirectPageLong() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::CMP_IndirectDirectPageLong() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer_address = D + offset;
 
     const uint32_t full_address = ReadByte(pointer_address) |
@@ -3043,8 +3560,9 @@ void CPU::CMP_IndirectDirectPageLong() {
     }
 }
 
-void CPU::CMP_StackRelativeIndirectY() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::CMP_StackRelativeIndirectY() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer_address = SP + offset;
 
     const uint16_t base_address = ReadWord(pointer_address);
@@ -3062,8 +3580,9 @@ void CPU::CMP_StackRelativeIndirectY() {
     }
 }
 
-void CPU::CMP_IndirectDirectPageLongY() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::CMP_IndirectDirectPageLongY() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer_address = D + offset;
 
     const uint32_t base_address = ReadByte(pointer_address) |
@@ -3085,24 +3604,24 @@ void CPU::CMP_IndirectDirectPageLongY() {
     }
 }
 
-void CPU::EOR_Immediate() {
+template <typename BusT>
+void BasicCPU<BusT>::EOR_Immediate() {
     if (P & FLAG_M) { // 8-bit mode
-        const uint8_t operand = ReadByte(PC++);
+        const uint8_t operand = FetchByte();
         A = (A & 0xFF00) | ((A & 0xFF) ^ operand);
         UpdateNZ8(A & 0xFF);
         cycles += 2;
     } else { // 16-bit mode
-        const uint16_t operand = ReadWord(PC);
-        PC += 2;
+        const uint16_t operand = FetchWord();
         A ^= operand;
         UpdateNZ16(A);
         cycles += 3;
     }
 }
 
-void CPU::EOR_Absolute() {
-    const uint16_t address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::EOR_Absolute() {
+    const uint16_t address = FetchWord();
     const uint32_t full_address = (DB << 16) | address;
 
     if (P & FLAG_M) { // 8-bit mode
@@ -3118,9 +3637,9 @@ void CPU::EOR_Absolute() {
     }
 }
 
-void CPU::EOR_AbsoluteX() {
-    const uint16_t base_address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::EOR_AbsoluteX() {
+    const uint16_t base_address = FetchWord();
     const uint32_t full_address = (DB << 16) | (base_address + X);
 
     if (P & FLAG_M) { // 8-bit mode
@@ -3142,9 +3661,9 @@ void CPU::EOR_AbsoluteX() {
     }
 }
 
-void CPU::EOR_AbsoluteY() {
-    const uint16_t base_address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::EOR_AbsoluteY() {
+    const uint16_t base_address = FetchWord();
     const uint32_t full_address = (DB << 16) | (base_address + Y);
 
     if (P & FLAG_M) { // 8-bit mode
@@ -3166,8 +3685,9 @@ void CPU::EOR_AbsoluteY() {
     }
 }
 
-void CPU::EOR_DirectPage() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::EOR_DirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = D + offset;
 
     if (P & FLAG_M) { // 8-bit mode
@@ -3185,8 +3705,9 @@ void CPU::EOR_DirectPage() {
     }
 }
 
-void CPU::EOR_DirectPageX() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::EOR_DirectPageX() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = D + offset + X;
 
     if (P & FLAG_M) { // 8-bit mode
@@ -3204,8 +3725,9 @@ void CPU::EOR_DirectPageX() {
     }
 }
 
-void CPU::EOR_IndirectDirectPage() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::EOR_IndirectDirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer_address = D + offset;
     const uint16_t indirect_address = ReadWord(pointer_address);
     const uint32_t full_address = (DB << 16) | indirect_address;
@@ -3225,8 +3747,9 @@ void CPU::EOR_IndirectDirectPage() {
     }
 }
 
-void CPU::EOR_IndirectDirectPageLong() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::EOR_IndirectDirectPageLong() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer_address = D + offset;
     const uint32_t full_address = ReadByte(pointer_address) |
                            (ReadByte(pointer_address + 1) << 8) |
@@ -3247,8 +3770,9 @@ void CPU::EOR_IndirectDirectPageLong() {
     }
 }
 
-void CPU::EOR_IndexedIndirectDirectPageX() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::EOR_IndexedIndirectDirectPageX() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer_address = D + offset + X;
     const uint16_t indirect_address = ReadWord(pointer_address);
     const uint32_t full_address = (DB << 16) | indirect_address;
@@ -3268,8 +3792,9 @@ void CPU::EOR_IndexedIndirectDirectPageX() {
     }
 }
 
-void CPU::EOR_IndirectDirectPageY() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::EOR_IndirectDirectPageY() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer_address = D + offset;
     const uint16_t base_address = ReadWord(pointer_address);
     const uint32_t full_address = (DB << 16) | (base_address + Y);
@@ -3295,8 +3820,9 @@ void CPU::EOR_IndirectDirectPageY() {
     }
 }
 
-void CPU::EOR_IndirectDirectPageLongY() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::EOR_IndirectDirectPageLongY() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer_address = D + offset;
     const uint32_t base_address = ReadByte(pointer_address) |
                            (ReadByte(pointer_address + 1) << 8) |
@@ -3318,9 +3844,9 @@ void CPU::EOR_IndirectDirectPageLongY() {
     }
 }
 
-void CPU::EOR_AbsoluteLong() {
-    const uint32_t address = ReadByte(PC) | (ReadByte(PC + 1) << 8) | (ReadByte(PC + 2) << 16);
-    PC += 3;
+template <typename BusT>
+void BasicCPU<BusT>::EOR_AbsoluteLong() {
+    const uint32_t address = FetchLong();
 
     if (P & FLAG_M) { // 8-bit mode
         const uint8_t operand = ReadByte(address);
@@ -3335,9 +3861,9 @@ void CPU::EOR_AbsoluteLong() {
     }
 }
 
-void CPU::EOR_AbsoluteLongX() {
-    const uint32_t base_address = ReadByte(PC) | (ReadByte(PC + 1) << 8) | (ReadByte(PC + 2) << 16);
-    PC += 3;
+template <typename BusT>
+void BasicCPU<BusT>::EOR_AbsoluteLongX() {
+    const uint32_t base_address = FetchLong();
     const uint32_t full_address = base_address + X;
 
     if (P & FLAG_M) { // 8-bit mode
@@ -3353,8 +3879,9 @@ void CPU::EOR_AbsoluteLongX() {
     }
 }
 
-void CPU::EOR_StackRelative() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::EOR_StackRelative() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = SP + offset;
 
     if (P & FLAG_M) { // 8-bit mode
@@ -3370,8 +3897,9 @@ void CPU::EOR_StackRelative() {
     }
 }
 
-void CPU::EOR_StackRelativeIndirectY() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::EOR_StackRelativeIndirectY() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer_address = SP + offset;
     const uint16_t base_address = ReadWord(pointer_address);
     const uint32_t full_address = (DB << 16) | (base_address + Y);
@@ -3389,9 +3917,9 @@ void CPU::EOR_StackRelativeIndirectY() {
     }
 }
 
-void CPU::JMP_AbsoluteIndirectLong() {
-    const uint16_t pointer_address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::JMP_AbsoluteIndirectLong() {
+    const uint16_t pointer_address = FetchWord();
 
     const uint32_t target_address = ReadByte(pointer_address) |
                              (ReadByte(pointer_address + 1) << 8) |
@@ -3403,8 +3931,9 @@ void CPU::JMP_AbsoluteIndirectLong() {
     cycles += 6;
 }
 
-void CPU::LDA_StackRelative() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::LDA_StackRelative() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = SP + offset;
 
     if (P & FLAG_M) { // 8-bit mode
@@ -3420,8 +3949,9 @@ void CPU::LDA_StackRelative() {
     }
 }
 
-void CPU::LDA_IndirectDirectPageLong() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::LDA_IndirectDirectPageLong() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer_address = D + offset;
 
     const uint32_t full_address = ReadByte(pointer_address) |
@@ -3443,8 +3973,9 @@ void CPU::LDA_IndirectDirectPageLong() {
     }
 }
 
-void CPU::LDA_StackRelativeIndirectY() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::LDA_StackRelativeIndirectY() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer_address = SP + offset;
 
     const uint16_t base_address = ReadWord(pointer_address);
@@ -3464,8 +3995,9 @@ void CPU::LDA_StackRelativeIndirectY() {
     }
 }
 
-void CPU::LDA_IndirectDirectPageLongY() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::LDA_IndirectDirectPageLongY() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer_address = D + offset;
 
     const uint32_t base_address = ReadByte(pointer_address) |
@@ -3489,7 +4021,8 @@ void CPU::LDA_IndirectDirectPageLongY() {
     }
 }
 
-void CPU::LSR_Accumulator() {
+template <typename BusT>
+void BasicCPU<BusT>::LSR_Accumulator() {
     if (P & FLAG_M) { // 8-bit mode
         const uint8_t original = A & 0xFF;
         const uint8_t result = original >> 1;
@@ -3505,9 +4038,9 @@ void CPU::LSR_Accumulator() {
     }
 }
 
-void CPU::LSR_Absolute() {
-    const uint16_t address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::LSR_Absolute() {
+    const uint16_t address = FetchWord();
     const uint32_t full_address = (DB << 16) | address;
 
     if (P & FLAG_M) { // 8-bit mode
@@ -3525,9 +4058,9 @@ void CPU::LSR_Absolute() {
     }
 }
 
-void CPU::LSR_AbsoluteX() {
-    const uint16_t base_address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::LSR_AbsoluteX() {
+    const uint16_t base_address = FetchWord();
     const uint32_t full_address = (DB << 16) | (base_address + X);
 
     if (P & FLAG_M) { // 8-bit mode
@@ -3545,8 +4078,9 @@ void CPU::LSR_AbsoluteX() {
     }
 }
 
-void CPU::LSR_DirectPage() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::LSR_DirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = D + offset;
 
     if (P & FLAG_M) { // 8-bit mode
@@ -3566,8 +4100,9 @@ void CPU::LSR_DirectPage() {
     }
 }
 
-void CPU::LSR_DirectPageX() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::LSR_DirectPageX() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = D + offset + X;
 
     if (P & FLAG_M) { // 8-bit mode
@@ -3587,85 +4122,92 @@ void CPU::LSR_DirectPageX() {
     }
 }
 
-void CPU::ORA_Immediate() {
+template <typename BusT>
+void BasicCPU<BusT>::ORA_Immediate() {
     if (P & FLAG_M) { // 8-bit mode
-        const uint8_t operand = ReadByte(PC++);
+        const uint8_t operand = FetchByte();
         A = (A & 0xFF00) | ((A & 0xFF) | operand);
         UpdateNZ8(A & 0xFF);
         cycles += 2;
     } else { // 16-bit mode
-        const uint16_t operand = ReadWord(PC);
-        PC += 2;
+        const uint16_t operand = FetchWord();
         A |= operand;
         UpdateNZ16(A);
         cycles += 3;
     }
 }
 
-void CPU::ORA_Absolute() {
-    const uint16_t address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::ORA_Absolute() {
+    const uint16_t address = FetchWord();
 
     ORA_Mem((DB << 16) | address, 4);
 }
 
-void CPU::ORA_AbsoluteX() {
-    const uint16_t base = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::ORA_AbsoluteX() {
+    const uint16_t base = FetchWord();
 
     ORA_Mem((DB << 16) | (base + X), 4, false, true, base, X);
 }
 
-void CPU::ORA_AbsoluteY() {
-    const uint16_t base = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::ORA_AbsoluteY() {
+    const uint16_t base = FetchWord();
     ORA_Mem((DB << 16) | (base + Y), 4, false, true, base, Y);
 }
 
-void CPU::ORA_DirectPage() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::ORA_DirectPage() {
+    const uint8_t offset = FetchByte();
     ORA_Mem(D + offset, 3, true);
 }
 
-void CPU::ORA_DirectPageX() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::ORA_DirectPageX() {
+    const uint8_t offset = FetchByte();
     ORA_Mem(D + offset + X, 4, true);
 }
 
-void CPU::ORA_IndirectDirectPage() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::ORA_IndirectDirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t addr = D + offset;
     const uint16_t indirect = ReadWord(addr);
 
     ORA_Mem((DB << 16) | indirect, 5, true);
 }
 
-void CPU::ORA_IndirectDirectPageLong() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::ORA_IndirectDirectPageLong() {
+    const uint8_t offset = FetchByte();
     const uint32_t addr = D + offset;
     const uint32_t long_addr = ReadByte(addr) | (ReadByte(addr + 1) << 8) | (ReadByte(addr + 2) << 16);
 
     ORA_Mem(long_addr, 6, true);
 }
 
-void CPU::ORA_IndexedIndirectDirectPageX() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::ORA_IndexedIndirectDirectPageX() {
+    const uint8_t offset = FetchByte();
     const uint32_t addr = D + offset + X;
     const uint16_t indirect = ReadWord(addr);
 
     ORA_Mem((DB << 16) | indirect, 6, true);
 }
 
-void CPU::ORA_IndirectDirectPageY() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::ORA_IndirectDirectPageY() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer_addr = D + offset;
     const uint16_t base = ReadWord(pointer_addr);
 
     ORA_Mem((DB << 16) | (base + Y), 5, true, true, base, Y);
 }
 
-void CPU::ORA_IndirectDirectPageLongY() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::ORA_IndirectDirectPageLongY() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer = D + offset;
     const uint32_t base = ReadByte(pointer) |
                     (ReadByte(pointer + 1) << 8) |
@@ -3674,85 +4216,100 @@ void CPU::ORA_IndirectDirectPageLongY() {
     ORA_Mem(base + Y, 6, true);
 }
 
-void CPU::ORA_AbsoluteLong() {
-    const uint32_t addr = ReadByte(PC) | (ReadByte(PC + 1) << 8) | (ReadByte(PC + 2) << 16);
-    PC += 3;
+template <typename BusT>
+void BasicCPU<BusT>::ORA_AbsoluteLong() {
+    const uint32_t addr = FetchLong();
 
     ORA_Mem(addr, 5);
 }
 
-void CPU::ORA_AbsoluteLongX() {
-    const uint32_t base = ReadByte(PC) | (ReadByte(PC + 1) << 8) | (ReadByte(PC + 2) << 16);
-    PC += 3;
+template <typename BusT>
+void BasicCPU<BusT>::ORA_AbsoluteLongX() {
+    const uint32_t base = FetchLong();
 
     ORA_Mem(base + X, 5);
 }
 
-void CPU::ORA_StackRelative() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::ORA_StackRelative() {
+    const uint8_t offset = FetchByte();
     ORA_Mem(SP + offset, 4);
 }
 
-void CPU::ORA_StackRelativeIndirectY() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::ORA_StackRelativeIndirectY() {
+    const uint8_t offset = FetchByte();
     const uint32_t pointer = SP + offset;
     const uint16_t base = ReadWord(pointer);
     ORA_Mem((DB << 16) | (base + Y), 7);
 }
 
-void CPU::MVN() {
-    const uint8_t dest_bank = ReadByte(PC++);
-    const uint8_t src_bank = ReadByte(PC++);
-
-    const uint32_t src_address = (src_bank << 16) | X;
-    const uint32_t dest_address = (dest_bank << 16) | Y;
-
-    const uint8_t data = ReadByte(src_address);
-    WriteByte(dest_address, data);
-
-    X++;
-    Y++;
-
-    A--;
-
-    if (A != 0xFFFF) {
-        // Make sure that operation has successfully completed
-        // If not, stay on this instruction
-        PC -= 3;
-    }
-
-    DB = dest_bank;
-
-    cycles += 7;
+template <typename BusT>
+void BasicCPU<BusT>::MVN() {
+    DoBlockMove(false);
 }
 
-void CPU::MVP() {
-    const uint8_t dest_bank = ReadByte(PC++);
-    const uint8_t src_bank = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::MVP() {
+    DoBlockMove(true);
+}
 
+// One MVN/MVP step. The instruction re-executes (PC rewinds onto it) until A wraps to $FFFF.
+// When both ranges are plain memory, as many bytes as fit before the cycle deadline are
+// moved in one go; each byte still costs 7 cycles.
+template <typename BusT>
+void BasicCPU<BusT>::DoBlockMove(const bool decrement) {
+    const uint8_t dest_bank = bus->Read(PC++);
+    const uint8_t src_bank = bus->Read(PC++);
     const uint32_t src_address = (src_bank << 16) | X;
     const uint32_t dest_address = (dest_bank << 16) | Y;
 
-    const uint8_t data = ReadByte(src_address);
-    WriteByte(dest_address, data);
+    // Stay inside both banks (and inside the first page with 8-bit index registers) and stop at the deadline
+    const uint32_t index_end = (P & FLAG_X) ? 0x100u : 0x10000u;
+    uint32_t count = decrement ? std::min(X, Y) + 1u : index_end - std::max(X, Y);
+    count = std::min<uint32_t>(count, A + 1u);
+    if (const uint64_t budget = cycle_deadline > cycles ? (cycle_deadline - cycles) / 7 : 0; budget < count) {
+        count = std::max<uint64_t>(budget, 1);
+    }
+
+    // Per-byte semantics matter if the move overwrites the instruction itself
+    const int64_t dest_offset = BusT::WRAMOffset(decrement ? dest_address - (count - 1) : dest_address);
+    const int64_t opcode_offset = BusT::WRAMOffset(PC - 3);
+    const bool overwrites_self = dest_offset >= 0 && opcode_offset >= 0 &&
+                                 opcode_offset + 2 >= dest_offset && opcode_offset < dest_offset + count;
 
-    X--;
-    Y--;
+    if (count == 1 || overwrites_self || !bus->CopyBlock(dest_address, src_address, count, decrement)) {
+        count = 1;
+        WriteByte(dest_address, bus->Read(src_address));
+    } else {
+        memory_writes += count;
+    }
 
-    A--;
+    if (decrement) {
+        X -= count;
+        Y -= count;
+    } else {
+        X += count;
+        Y += count;
+    }
+    if (P & FLAG_X) {
+        X &= 0xFF;
+        Y &= 0xFF;
+    }
+    A -= count;
 
     if (A != 0xFFFF) {
-        // Make sure that operation has successfully completed
-        // If not, stay on this instruction
+        // Not finished yet, stay on this instruction
         PC -= 3;
     }
 
     DB = dest_bank;
 
-    cycles += 7;
+    cycles += 7 * count;
 }
 
-void CPU::ROL_Accumulator() {
+template <typename BusT>
+void BasicCPU<BusT>::ROL_Accumulator() {
     if (P & FLAG_M) {
         // 8-bit mode
         uint8_t low_byte = A & 0xFF;
@@ -3765,38 +4322,41 @@ void CPU::ROL_Accumulator() {
     cycles += 2;
 }
 
-void CPU::ROL_Absolute() {
-    const uint16_t address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::ROL_Absolute() {
+    const uint16_t address = FetchWord();
 
     ROL_AtAddress((DB << 16) | address, 6, 7);
 }
 
-void CPU::ROL_AbsoluteX() {
-    const uint16_t base_address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::ROL_AbsoluteX() {
+    const uint16_t base_address = FetchWord();
     const uint32_t address = (DB << 16) | (base_address + X);
 
     ROL_AtAddress(address, 7, 8);
 }
 
-void CPU::ROL_DirectPage() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::ROL_DirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = D + offset;
 
     ROL_AtAddress(address, 5, 6);
     if (D & 0xFF) cycles++;
 }
 
-void CPU::ROL_DirectPageX() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::ROL_DirectPageX() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = D + offset + (P & FLAG_X ? (X & 0xFF) : X);
 
     ROL_AtAddress(address, 6, 7);
     if (D & 0xFF) cycles++;
 }
 
-void CPU::ROR_Accumulator() {
+template <typename BusT>
+void BasicCPU<BusT>::ROR_Accumulator() {
     if (P & FLAG_M) {
         // 8-bit mode
         uint8_t low_byte = A & 0xFF;
@@ -3809,47 +4369,50 @@ void CPU::ROR_Accumulator() {
     cycles += 2;
 }
 
-void CPU::ROR_Absolute() {
-    const uint16_t address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::ROR_Absolute() {
+    const uint16_t address = FetchWord();
 
     ROR_AtAddress((DB << 16) | address, 6, 7);
 }
 
-void CPU::ROR_AbsoluteX() {
-    const uint16_t base_address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::ROR_AbsoluteX() {
+    const uint16_t base_address = FetchWord();
     const uint32_t address = (DB << 16) | (base_address + X);
 
     ROR_AtAddress(address, 7, 8);
 }
 
-void CPU::ROR_DirectPage() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::ROR_DirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = D + offset;
 
     ROR_AtAddress(address, 5, 6);
     if (D & 0xFF) cycles++;
 }
 
-void CPU::ROR_DirectPageX() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::ROR_DirectPageX() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = D + offset + (P & FLAG_X ? (X & 0xFF) : X);
 
     ROR_AtAddress(address, 6, 7);
     if (D & 0xFF) cycles++;
 }
 
-void CPU::PEA() {
-    const uint16_t address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::PEA() {
+    const uint16_t address = FetchWord();
 
     PushWord(address);
     cycles += 5;
 }
 
-void CPU::PEI() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::PEI() {
+    const uint8_t offset = FetchByte();
     const uint32_t indirect_addr = D + offset;
 
     const uint16_t effective_addr = ReadWord(indirect_addr);
@@ -3860,9 +4423,9 @@ void CPU::PEI() {
     if (D & 0xFF) cycles++;
 }
 
-void CPU::PER() {
-    const auto displacement = static_cast<int16_t>(ReadWord(PC));
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::PER() {
+    const auto displacement = static_cast<int16_t>(FetchWord());
 
     const auto effective_addr = static_cast<uint16_t>(PC + displacement);
 
@@ -3870,22 +4433,26 @@ void CPU::PER() {
     cycles += 6;
 }
 
-void CPU::REP() {
-    const uint8_t mask = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::REP() {
+    const uint8_t mask = FetchByte();
 
-    P &= ~mask;
+    // M/X/D/I are the usual targets; only refold the lazy flags when they are touched
+    if (mask & (FLAG_N | FLAG_Z | FLAG_V | FLAG_C)) SetP(GetP() & ~mask);
+    else P &= ~mask;
 
     cycles += 3;
 }
 
-void CPU::RTI() {
+template <typename BusT>
+void BasicCPU<BusT>::RTI() {
     if (emulation_mode) {
-        P = PopByte();
+        SetP(PopByte());
         PC = PopWord();
         cycles += 7;
     } else {
         // Native mode
-        P = PopByte();
+        SetP(PopByte());
         const uint16_t pc_addr = PopWord();
         PB = PopByte();
         PC = (static_cast<uint32_t>(PB) << 16) | pc_addr;
@@ -3893,63 +4460,71 @@ void CPU::RTI() {
     }
 }
 
-void CPU::SBC_Immediate() {
+template <typename BusT>
+void BasicCPU<BusT>::SBC_Immediate() {
     if (P & FLAG_M) {
-        SBC8(ReadByte(PC++));
+        SBC8(FetchByte());
         cycles += 2;
     } else {
-        SBC16(ReadWord(PC));
-        PC += 2;
+        SBC16(FetchWord());
         cycles += 3;
     }
 }
 
-void CPU::SBC_Absolute() {
-    const uint16_t address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::SBC_Absolute() {
+    const uint16_t address = FetchWord();
     SBC_FromAddress((DB << 16) | address, 4, 5);
 }
 
-void CPU::SBC_AbsoluteLong() {
-    const uint32_t address = ReadByte(PC++) | (ReadByte(PC++) << 8) | (ReadByte(PC++) << 16);
+template <typename BusT>
+void BasicCPU<BusT>::SBC_AbsoluteLong() {
+    const uint16_t address_low = FetchWord();
+    const uint8_t address_bank = FetchByte();
+    const uint32_t address = (address_bank << 16) | address_low;
     SBC_FromAddress(address, 5, 6);
 }
 
-void CPU::SBC_AbsoluteX() {
-    const uint16_t base_address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::SBC_AbsoluteX() {
+    const uint16_t base_address = FetchWord();
     const uint16_t x_offset = (P & FLAG_X) ? (X & 0xFF) : X;
     const uint32_t address = (DB << 16) | (base_address + x_offset);
 
     SBC_FromAddress_PageCross(address, base_address, x_offset, 4, 5);
 }
 
-void CPU::SBC_AbsoluteLongX() {
-    const uint32_t base_address = ReadByte(PC++) | (ReadByte(PC++) << 8) | (ReadByte(PC++) << 16);
+template <typename BusT>
+void BasicCPU<BusT>::SBC_AbsoluteLongX() {
+    const uint16_t base_address_low = FetchWord();
+    const uint8_t base_address_bank = FetchByte();
+    const uint32_t base_address = (base_address_bank << 16) | base_address_low;
     const uint16_t x_offset = (P & FLAG_X) ? (X & 0xFF) : X;
 
     SBC_FromAddress(base_address + x_offset, 5, 6);
 }
 
-void CPU::SBC_AbsoluteY() {
-    const uint16_t base_address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::SBC_AbsoluteY() {
+    const uint16_t base_address = FetchWord();
     const uint16_t y_offset = (P & FLAG_X) ? (Y & 0xFF) : Y;
     const uint32_t address = (DB << 16) | (base_address + y_offset);
 
     SBC_FromAddress_PageCross(address, base_address, y_offset, 4, 5);
 }
 
-void CPU::SBC_DirectPage() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::SBC_DirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = D + offset;
 
     SBC_FromAddress(address, 3, 4);
     if (D & 0xFF) cycles++;
 }
 
-void CPU::SBC_DirectPageX() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::SBC_DirectPageX() {
+    const uint8_t offset = FetchByte();
     const uint16_t x_offset = (P & FLAG_X) ? (X & 0xFF) : X;
     const uint32_t address = D + offset + x_offset;
 
@@ -3957,8 +4532,9 @@ void CPU::SBC_DirectPageX() {
     if (D & 0xFF) cycles++;
 }
 
-void CPU::SBC_DirectPageIndirect() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::SBC_DirectPageIndirect() {
+    const uint8_t offset = FetchByte();
     const uint32_t indirect_addr = D + offset;
     const uint16_t address = ReadWord(indirect_addr);
     const uint32_t final_address = (DB << 16) | address;
@@ -3967,8 +4543,9 @@ void CPU::SBC_DirectPageIndirect() {
     if (D & 0xFF) cycles++;
 }
 
-void CPU::SBC_DirectPageIndirectLong() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::SBC_DirectPageIndirectLong() {
+    const uint8_t offset = FetchByte();
     const uint32_t indirect_addr = D + offset;
     const uint32_t address = ReadByte(indirect_addr)
                            | (ReadByte(indirect_addr + 1) << 8)
@@ -3978,8 +4555,9 @@ void CPU::SBC_DirectPageIndirectLong() {
     if (D & 0xFF) cycles++;
 }
 
-void CPU::SBC_DirectPageIndirectY() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::SBC_DirectPageIndirectY() {
+    const uint8_t offset = FetchByte();
     const uint32_t indirect_addr = D + offset;
     const uint16_t base_address = ReadWord(indirect_addr);
     const uint16_t y_offset = (P & FLAG_X) ? (Y & 0xFF) : Y;
@@ -3989,8 +4567,9 @@ void CPU::SBC_DirectPageIndirectY() {
     if (D & 0xFF) cycles++;
 }
 
-void CPU::SBC_DirectPageIndirectLongY() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::SBC_DirectPageIndirectLongY() {
+    const uint8_t offset = FetchByte();
     const uint32_t indirect_addr = D + offset;
     const uint32_t base_address = ReadByte(indirect_addr)
                                 | (ReadByte(indirect_addr + 1) << 8)
@@ -4001,8 +4580,9 @@ void CPU::SBC_DirectPageIndirectLongY() {
     if (D & 0xFF) cycles++;
 }
 
-void CPU::SBC_DirectPageIndirectX() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::SBC_DirectPageIndirectX() {
+    const uint8_t offset = FetchByte();
     const uint16_t x_offset = (P & FLAG_X) ? (X & 0xFF) : X;
     const uint32_t indirect_addr = D + offset + x_offset;
     const uint16_t address = ReadWord(indirect_addr);
@@ -4012,15 +4592,17 @@ void CPU::SBC_DirectPageIndirectX() {
     if (D & 0xFF) cycles++;
 }
 
-void CPU::SBC_StackRelative() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::SBC_StackRelative() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = SP + offset;
 
     SBC_FromAddress(address, 4, 5);
 }
 
-void CPU::SBC_StackRelativeIndirectY() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::SBC_StackRelativeIndirectY() {
+    const uint8_t offset = FetchByte();
     const uint32_t indirect_addr = SP + offset;
     const uint16_t base_address = ReadWord(indirect_addr);
     const uint16_t y_offset = (P & FLAG_X) ? (Y & 0xFF) : Y;
@@ -4029,64 +4611,71 @@ void CPU::SBC_StackRelativeIndirectY() {
     SBC_FromAddress(address, 7, 8);
 }
 
-void CPU::SEC() {
-    P |= FLAG_C;
+template <typename BusT>
+void BasicCPU<BusT>::SEC() {
+    flag_c = true;
     cycles += 2;
 }
 
-void CPU::SED() {
+template <typename BusT>
+void BasicCPU<BusT>::SED() {
     P |= FLAG_D;
     cycles += 2;
 }
 
-void CPU::SEI() {
+template <typename BusT>
+void BasicCPU<BusT>::SEI() {
     // This prevents IRQ interrupts from being processed
     P |= FLAG_I;
     cycles += 2;
 }
 
-void CPU::SEP() {
-    const uint8_t mask = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::SEP() {
+    const uint8_t mask = FetchByte();
 
-    P |= mask;
+    if (mask & (FLAG_N | FLAG_Z | FLAG_V | FLAG_C)) SetP(GetP() | mask);
+    else P |= mask;
 
     cycles += 3;
 }
 
-void CPU::STP() {
+template <typename BusT>
+void BasicCPU<BusT>::STP() {
+    // Only a reset resumes the processor
     stopped = true;
     cycles += 3;
-
-    // TODO: Implement way to resume processor?
 }
 
-void CPU::STZ_Absolute() {
-    const uint16_t address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::STZ_Absolute() {
+    const uint16_t address = FetchWord();
     const uint32_t full_address = (DB << 16) | address;
 
     STZ_ToAddress(full_address, 4, 5);
 }
 
-void CPU::STZ_AbsoluteX() {
-    const uint16_t base_address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::STZ_AbsoluteX() {
+    const uint16_t base_address = FetchWord();
     const uint16_t x_offset = (P & FLAG_X) ? (X & 0xFF) : X;
     const uint32_t address = (DB << 16) | (base_address + x_offset);
 
     STZ_ToAddress(address, 5, 6);
 }
 
-void CPU::STZ_DirectPage() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::STZ_DirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = D + offset;
 
     STZ_ToAddress(address, 3, 4);
     if (D & 0xFF) cycles++;
 }
 
-void CPU::STZ_DirectPageX() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::STZ_DirectPageX() {
+    const uint8_t offset = FetchByte();
     const uint16_t x_offset = (P & FLAG_X) ? (X & 0xFF) : X;
     const uint32_t address = D + offset + x_offset;
     STZ_ToAddress(address, 4, 5);
@@ -4094,7 +4683,8 @@ void CPU::STZ_DirectPageX() {
     if (D & 0xFF) cycles++;
 }
 
-void CPU::TAX() {
+template <typename BusT>
+void BasicCPU<BusT>::TAX() {
     if (P & FLAG_X) {
         // 8-bit
         X = (X & 0xFF00) | (A & 0x00FF);
@@ -4107,7 +4697,8 @@ void CPU::TAX() {
     cycles += 2;
 }
 
-void CPU::TAY() {
+template <typename BusT>
+void BasicCPU<BusT>::TAY() {
     if (P & FLAG_X) {
         // 8-bit
         Y = (Y & 0xFF00) | (A & 0x00FF);
@@ -4120,30 +4711,35 @@ void CPU::TAY() {
     cycles += 2;
 }
 
-void CPU::TCD() {
+template <typename BusT>
+void BasicCPU<BusT>::TCD() {
     D = A;
     UpdateNZ16(D);
     cycles += 2;
 }
 
-void CPU::TCS() {
+template <typename BusT>
+void BasicCPU<BusT>::TCS() {
     SP = A;
     cycles += 2;
 }
 
-void CPU::TDC() {
+template <typename BusT>
+void BasicCPU<BusT>::TDC() {
     A = D;
     UpdateNZ16(A);
     cycles += 2;
 }
 
-void CPU::TSC() {
+template <typename BusT>
+void BasicCPU<BusT>::TSC() {
     A = SP;
     UpdateNZ16(A);
     cycles += 2;
 }
 
-void CPU::TSX() {
+template <typename BusT>
+void BasicCPU<BusT>::TSX() {
     if (P & FLAG_X) {
         // 8-bit
         X = (X & 0xFF00) | (SP & 0x00FF);
@@ -4156,7 +4752,8 @@ void CPU::TSX() {
     cycles += 2;
 }
 
-void CPU::TXA() {
+template <typename BusT>
+void BasicCPU<BusT>::TXA() {
     if (P & FLAG_M) {
         // 8-bit accumulator
         A = (A & 0xFF00) | (X & 0x00FF);
@@ -4175,7 +4772,8 @@ void CPU::TXA() {
     cycles += 2;
 }
 
-void CPU::TXS() {
+template <typename BusT>
+void BasicCPU<BusT>::TXS() {
     if (P & FLAG_X) {
         // 8-bit
         SP = 0x0100 | (X & 0x00FF);
@@ -4186,7 +4784,8 @@ void CPU::TXS() {
     cycles += 2;
 }
 
-void CPU::TXY() {
+template <typename BusT>
+void BasicCPU<BusT>::TXY() {
     if (P & FLAG_X) {
         // 8-bit
         Y = (Y & 0xFF00) | (X & 0x00FF);
@@ -4199,7 +4798,8 @@ void CPU::TXY() {
     cycles += 2;
 }
 
-void CPU::TYA() {
+template <typename BusT>
+void BasicCPU<BusT>::TYA() {
     if (P & FLAG_M) {
         // 8-bit accumulator
         A = (A & 0xFF00) | (Y & 0x00FF);
@@ -4217,7 +4817,8 @@ void CPU::TYA() {
     cycles += 2;
 }
 
-void CPU::TYX() {
+template <typename BusT>
+void BasicCPU<BusT>::TYX() {
     if (P & FLAG_X) {
         // 8-bit index registers
         X = (X & 0xFF00) | (Y & 0x00FF);
@@ -4231,19 +4832,16 @@ void CPU::TYX() {
 }
 
 
-void CPU::TRB_DirectPage() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::TRB_DirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = D + offset;
 
     if (P & FLAG_M) {
         // 8-bit mode
         uint8_t memory_value = ReadByte(address);
 
-        if (const uint8_t test_result = memory_value & (A & 0xFF); test_result == 0) {
-            P |= FLAG_Z;
-        } else {
-            P &= ~FLAG_Z;
-        }
+        flag_z = memory_value & (A & 0xFF);
 
         memory_value &= ~(A & 0xFF);
         WriteByte(address, memory_value);
@@ -4252,11 +4850,7 @@ void CPU::TRB_DirectPage() {
         // 16-bit mode
         uint16_t memory_value = ReadWord(address);
 
-        if (const uint16_t test_result = memory_value & A; test_result == 0) {
-            P |= FLAG_Z;
-        } else {
-            P &= ~FLAG_Z;
-        }
+        flag_z = memory_value & A;
 
         memory_value &= ~A;
         WriteWord(address, memory_value);
@@ -4266,20 +4860,16 @@ void CPU::TRB_DirectPage() {
     if (D & 0xFF) cycles++;
 }
 
-void CPU::TRB_Absolute() {
-    const uint16_t address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::TRB_Absolute() {
+    const uint16_t address = FetchWord();
     const uint32_t full_address = (DB << 16) | address;
 
     if (P & FLAG_M) {
         // 8-bit mode
         uint8_t memory_value = ReadByte(full_address);
 
-        if (const uint8_t test_result = memory_value & (A & 0xFF); test_result == 0) {
-            P |= FLAG_Z;
-        } else {
-            P &= ~FLAG_Z;
-        }
+        flag_z = memory_value & (A & 0xFF);
 
         memory_value &= ~(A & 0xFF);
         WriteByte(full_address, memory_value);
@@ -4288,11 +4878,7 @@ void CPU::TRB_Absolute() {
         // 16-bit mode
         uint16_t memory_value = ReadWord(full_address);
 
-        if (const uint16_t test_result = memory_value & A; test_result == 0) {
-            P |= FLAG_Z;
-        } else {
-            P &= ~FLAG_Z;
-        }
+        flag_z = memory_value & A;
 
         memory_value &= ~A;
         WriteWord(full_address, memory_value);
@@ -4300,19 +4886,16 @@ void CPU::TRB_Absolute() {
     }
 }
 
-void CPU::TSB_DirectPage() {
-    const uint8_t offset = ReadByte(PC++);
+template <typename BusT>
+void BasicCPU<BusT>::TSB_DirectPage() {
+    const uint8_t offset = FetchByte();
     const uint32_t address = D + offset;
 
     if (P & FLAG_M) {
         // 8-bit mode
         uint8_t memory_value = ReadByte(address);
 
-        if (const uint8_t test_result = memory_value & (A & 0xFF); test_result == 0) {
-            P |= FLAG_Z;
-        } else {
-            P &= ~FLAG_Z;
-        }
+        flag_z = memory_value & (A & 0xFF);
 
         memory_value |= (A & 0xFF);
         WriteByte(address, memory_value);
@@ -4321,11 +4904,7 @@ void CPU::TSB_DirectPage() {
         // 16-bit mode
         uint16_t memory_value = ReadWord(address);
 
-        if (const uint16_t test_result = memory_value & A; test_result == 0) {
-            P |= FLAG_Z;
-        } else {
-            P &= ~FLAG_Z;
-        }
+        flag_z = memory_value & A;
 
         memory_value |= A;
         WriteWord(address, memory_value);
@@ -4335,20 +4914,16 @@ void CPU::TSB_DirectPage() {
     if (D & 0xFF) cycles++;
 }
 
-void CPU::TSB_Absolute() {
-    const uint16_t address = ReadWord(PC);
-    PC += 2;
+template <typename BusT>
+void BasicCPU<BusT>::TSB_Absolute() {
+    const uint16_t address = FetchWord();
     const uint32_t full_address = (DB << 16) | address;
 
     if (P & FLAG_M) {
         // 8-bit mode
         uint8_t memory_value = ReadByte(full_address);
 
-        if (const uint8_t test_result = memory_value & (A & 0xFF); test_result == 0) {
-            P |= FLAG_Z;
-        } else {
-            P &= ~FLAG_Z;
-        }
+        flag_z = memory_value & (A & 0xFF);
 
         memory_value |= (A & 0xFF);
         WriteByte(full_address, memory_value);
@@ -4357,11 +4932,7 @@ void CPU::TSB_Absolute() {
         // 16-bit mode
         uint16_t memory_value = ReadWord(full_address);
 
-        if (const uint16_t test_result = memory_value & A; test_result == 0) {
-            P |= FLAG_Z;
-        } else {
-            P &= ~FLAG_Z;
-        }
+        flag_z = memory_value & A;
 
         memory_value |= A;
         WriteWord(full_address, memory_value);
@@ -4369,19 +4940,23 @@ void CPU::TSB_Absolute() {
     }
 }
 
-void CPU::WAI() {
-    // TODO: Implement checking for interrupts (IRQ, NMI, RESET)
-    waiting_for_interrupt = true;
+template <typename BusT>
+void BasicCPU<BusT>::WAI() {
+    // Sleeps until RaiseNMI() or SetIRQLine(), unless one of them already happened: an IRQ that
+    // is still asserted wakes the CPU straight away, even with interrupts disabled
+    waiting_for_interrupt = !irq_line && !nmi_pending;
     cycles += 3;
 }
 
-void CPU::WDM() {
+template <typename BusT>
+void BasicCPU<BusT>::WDM() {
     // I don't think this does anything. Just here for completeness
     PC++;
     cycles += 2;
 }
 
-void CPU::XBA() {
+template <typename BusT>
+void BasicCPU<BusT>::XBA() {
     const uint8_t temp = A & 0xFF;
     A = (A >> 8) | ((temp) << 8);
 
@@ -4389,11 +4964,11 @@ void CPU::XBA() {
     cycles += 3;
 }
 
-void CPU::XCE() {
-    const bool old_carry = (P & FLAG_C) != 0;
+template <typename BusT>
+void BasicCPU<BusT>::XCE() {
+    const bool old_carry = flag_c;
 
-    if (emulation_mode) P |= FLAG_C;
-    else P &= ~FLAG_C;
+    flag_c = emulation_mode;
 
     emulation_mode = old_carry;
 
@@ -4402,4 +4977,7 @@ void CPU::XCE() {
         P |= (FLAG_M | FLAG_X);
         SP = (SP & 0x00FF) | 0x0100;
     }
-}
\ No newline at end of file
+}
+
+template class BasicCPU<Bus>;
+template class BasicCPU<FlatBus>;
@@ -4,25 +4,102 @@
 
 #ifndef CPU_H
 #define CPU_H
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "block_cache.h"
 #include "bus.h"
+#include "jit.h"
+#include "save_state.h"
+
+class Profiler;
+class TraceWriter;
+
+// How the CPU executes code
+enum class CPUBackend {
+    Interpreter,    // Fetch and decode every instruction
+    BlockCache,     // Run out of predecoded basic blocks
+    JIT             // Block cache, with hot blocks compiled to x86-64
+};
 
-// 65816 CPU implementation
-class CPU {
+// 65816 CPU implementation, parameterized on the memory bus so tests and benchmarks can run it
+// against a FlatBus. Member functions are defined in cpu.cpp and instantiated there for Bus and FlatBus.
+template <typename BusT>
+class alignas(64) BasicCPU {
     // Registers
     uint16_t A;     // Accumulator
     uint16_t X, Y;  // Index registers
     uint16_t SP;    // Stack pointer
     uint32_t PC;    // Program counter (24-bit)
-    uint8_t P;      // Processor status
+    uint8_t P;      // Processor status (N/Z/V/C are kept in the flag_* fields below)
     uint8_t DB;     // Data bank
     uint8_t PB;     // Program bank
     uint16_t D;     // Direct page
 
-    Bus* bus;
+    // Lazily evaluated status flags, folded back into P by GetP().
+    // N is bit 15 of flag_n (8-bit results are stored shifted up), Z is set when flag_z == 0
+    uint16_t flag_n = 0;
+    uint16_t flag_z = 1;
+    bool flag_c = false;
+    bool flag_v = false;
+
+    BusT* bus;
     uint64_t cycles;
     bool emulation_mode = true;
     bool stopped = false;
     bool waiting_for_interrupt = false;
+    uint64_t cycle_deadline = UINT64_MAX;   // Next sync point; bulk operations stop here
+
+    // Interrupt lines
+    bool nmi_pending = false;   // Edge triggered, latched until serviced
+    bool irq_line = false;      // Level triggered, masked by the I flag
+
+    // Predecoded basic blocks
+    BlockCache<BusT> block_cache;
+    BasicBlock* current_block = nullptr;
+    size_t block_position = 0;
+    CPUBackend backend = CPUBackend::BlockCache;
+
+    // Operand bytes of the predecoded instruction being run, handed out by the Fetch helpers
+    // instead of reading them from the bus again
+    bool operand_predecoded = false;
+    uint32_t predecoded_operand = 0;
+
+    void ExecuteCachedInstruction();
+    void ExecuteDecoded(const DecodedInstruction& instruction);
+    void RunBlocks();
+    [[nodiscard]] bool InterruptPending() const { return nmi_pending || (irq_line && !(P & FLAG_I)); }
+    void ExecuteOpcode(uint8_t opcode);
+    void CheckIdleLoop();
+    void ServiceInterrupt(uint16_t native_vector, uint16_t emulation_vector);
+    void InvalidateWrittenCode();
+
+    // JIT
+    uint32_t jit_threshold = 16;    // Block executions before compiling
+    JIT jit{JITLayout()};
+    bool jit_verify = false;
+    std::vector<std::pair<uint32_t, uint8_t>> jit_journal;  // Address and old value of each byte written natively
+    uint64_t jit_mismatches = 0;
+
+    JIT::Layout JITLayout();
+    // Memory accessors and idle loop check for compiled blocks, see JIT::Layout
+    static uint32_t JITRead8(void* cpu, uint32_t address);
+    static uint32_t JITRead16(void* cpu, uint32_t address);
+    static uint32_t JITWrite8(void* cpu, uint32_t address, uint32_t value);
+    static uint32_t JITWrite16(void* cpu, uint32_t address, uint32_t value);
+    static void JITCheckIdleLoop(void* cpu);
+
+#ifdef BREADEDSNES_TRACE
+    TraceWriter* tracer = nullptr;
+    void TraceInstruction(uint8_t opcode);
+#endif
+#ifdef BREADEDSNES_PROFILE
+    Profiler* profiler = nullptr;
+#endif
+
+    uint32_t RunNativeBlock(BasicBlock& block, uint32_t limit);
+    uint32_t RunVerifiedNativeBlock(BasicBlock& block, uint32_t limit);
 
     // Status flags
     enum Flags {
@@ -41,19 +118,25 @@ class CPU {
     // Addressing mode helpers
     uint8_t ReadByte(uint32_t address);
     uint16_t ReadWord(uint32_t address);
+    // Operand bytes at PC, which they step past. One cycle per byte, like ReadByte.
+    uint8_t FetchByte();
+    uint16_t FetchWord();
+    uint32_t FetchLong();
     void UpdateNZ8(uint8_t value);
     void UpdateNZ16(uint16_t value);
+    [[nodiscard]] uint8_t GetP() const;
+    void SetP(uint8_t value);
 
     // Memory write helpers
-    void WriteByte(uint32_t address, uint8_t value) const;
-    void WriteWord(uint32_t address, uint16_t value) const;
+    void WriteByte(uint32_t address, uint8_t value);
+    void WriteWord(uint32_t address, uint16_t value);
 
     // Helper methods for compare operations
     void UpdateCompareFlags8(uint8_t reg_value, uint8_t compare_value);
     void UpdateCompareFlags16(uint16_t reg_value, uint16_t compare_value);
 
     // Branching helper method
-    void DoBranch(bool condition);
+    void DoBranch(bool condition, int base_cycles = 0);
 
     // Helper methods for stack operations
     void PushByte(uint8_t value);
@@ -64,20 +147,22 @@ class CPU {
     // Helper method for ADC instructions
     void DoADC(uint16_t value);
 
-    // Helper method to check for decimal mode adjustment
-    static uint16_t AdjustDecimal(uint16_t binary_result, bool is_16bit);
+    // Shared MVN/MVP implementation
+    void DoBlockMove(bool decrement);
+
+    // Decimal mode ADC: sets V and returns the sum with the carry out above it
+    uint32_t AddDecimal(uint16_t a, uint16_t b, bool is_16bit);
 
     // Helpers for LD* Instructions
-    void LDA_Mem(uint32_t address, int base_cycles, bool addDPExtraCycle, bool addPageCrossCycle, uint16_t base,
-                 uint16_t offset);
+    void LDA_Mem(uint32_t address, int base_cycles, bool addDPExtraCycle = false, bool addPageCrossCycle = false,
+                 uint16_t base = 0, uint16_t offset = 0);
 
-    void LD_Index(uint32_t address, bool isX, int base_cycles, bool addDPExtraCycle, bool addPageCrossCycle,
-                  uint16_t base,
-                  uint16_t offset);
+    void LD_Index(uint32_t address, bool isX, int base_cycles, bool addDPExtraCycle = false,
+                  bool addPageCrossCycle = false, uint16_t base = 0, uint16_t offset = 0);
 
     // General ORA Logic
-    void ORA_Mem(uint32_t address, int base_cycles, bool addDPExtraCycle, bool addPageCrossCycle, uint16_t base_address,
-             uint16_t offset);
+    void ORA_Mem(uint32_t address, int base_cycles, bool addDPExtraCycle = false, bool addPageCrossCycle = false,
+                 uint16_t base_address = 0, uint16_t offset = 0);
 
     //Helper Methods for Rotate Right/Left
     uint8_t ROL8(uint8_t value);
@@ -118,14 +203,72 @@ class CPU {
     void UpdateLSRFlags16(uint16_t original_value, uint16_t result);
 
 public:
-    explicit CPU(Bus* memory_bus) : bus(memory_bus) {
+    // Register file and execution state
+    struct State {
+        uint16_t A, X, Y, SP, D;
+        uint32_t PC;
+        uint8_t P, DB, PB;
+        bool emulation_mode, stopped, waiting_for_interrupt;
+        uint64_t cycles;
+
+        bool operator==(const State&) const = default;
+    };
+
+    explicit BasicCPU(BusT* memory_bus) : bus(memory_bus), block_cache(memory_bus) {
         Reset();
     }
 
     void Reset();
     void Step();
+    // Steps until the cycle deadline, a halt, or an idle loop the system can skip
+    void Run();
     void ExecuteInstruction();
+
+    void SetBackend(CPUBackend new_backend);
+    [[nodiscard]] CPUBackend GetBackend() const { return backend; }
+
+    // Block executions before the JIT compiles a block, 0 to compile every block on first sight
+    void SetJITThreshold(const uint32_t executions) { jit_threshold = executions; }
+    // Re-runs every compiled block on the interpreter, from the same state with the block's writes
+    // undone, and compares registers, cycles and memory. Blocks that disagree go back to the
+    // interpreter and are counted in GetJITMismatches.
+    void SetJITVerification(const bool enabled) { jit_verify = enabled; }
+    [[nodiscard]] uint64_t GetJITMismatches() const { return jit_mismatches; }
+
+#ifdef BREADEDSNES_TRACE
+    // Records every executed instruction while set; nullptr stops tracing
+    void SetTracer(TraceWriter* writer) { tracer = writer; }
+#endif
+#ifdef BREADEDSNES_PROFILE
+    // Counts executions and cycles while set; nullptr stops profiling
+    void SetProfiler(Profiler* target) { profiler = target; }
+#endif
+
+    [[nodiscard]] State GetState() const;
+    void SetState(const State& state);
+    // Registers plus a pending NMI. The IRQ line is restored by whatever drives it. Loading drops
+    // every predecoded block, since memory may no longer match them.
+    void SaveState(StateWriter& writer) const;
+    void LoadState(StateReader& reader);
     [[nodiscard]] uint64_t GetCycles() const { return cycles; }
+    void SetCycleDeadline(uint64_t deadline) { cycle_deadline = deadline; }
+
+    // True while the CPU can't make progress on its own: halted by WAI/STP,
+    // or spinning in an idle loop that only an interrupt or the PPU can end
+    [[nodiscard]] bool IsIdle() const { return stopped || waiting_for_interrupt || idle_loop_cycles; }
+
+    // Cycles per iteration of the idle loop the CPU is in, 0 if it isn't in one
+    [[nodiscard]] uint64_t GetIdleLoopCycles() const { return idle_loop_cycles; }
+    // Lets time pass without executing anything. Idle loops are skipped in whole iterations that
+    // end by the deadline, so the CPU is where it would have been after running them; Run takes it
+    // the rest of the way, stopping mid-loop just like without the skip.
+    void SkipIdleCycles(uint64_t count);
+
+    // Interrupt inputs. Either one releases WAI, even when IRQs are masked.
+    void RaiseNMI();
+    void SetIRQLine(bool asserted);
+    // Sets the IRQ line from a save state, without SetIRQLine's wake-up
+    void RestoreIRQLine(const bool asserted) { irq_line = asserted; }
 
     // Instruction implementations
     // TODO: Implement remaining instructions
@@ -421,6 +564,26 @@ public:
     void WDM(); // Reserved for future expansion - whatever that means
     void XBA();
     void XCE();
+
+private:
+    // Idle loop detection, the same on every backend. Each taken branch or jump compares the
+    // registers with the last one's: a short loop that comes back to the same place with the same
+    // registers, having written nothing and read only memory and status registers, will keep
+    // spinning until something outside the CPU changes.
+    static constexpr uint64_t kMaxIdleLoopCycles = 64;
+    bool idle_tracking = false;
+    State idle_state{};             // At the last taken branch or jump
+    uint64_t idle_writes = 0;       // memory_writes at that point
+    uint64_t idle_reads = 0;        // The bus's side effect reads at that point
+    uint64_t idle_loop_cycles = 0;  // Cycles per iteration, 0 if not idling
+    uint64_t memory_writes = 0;     // Bytes written by the CPU
 };
 
+class FlatBus;
+extern template class BasicCPU<Bus>;
+extern template class BasicCPU<FlatBus>;
+
+// The SNES CPU
+using CPU = BasicCPU<Bus>;
+
 #endif //CPU_H
@@ -0,0 +1,75 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#ifndef DIRTY_PAGES_H
+#define DIRTY_PAGES_H
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// Per-page dirty bitmap for a block of emulated memory.
+// Write paths mark pages; snapshot/rewind/netplay code walks the dirty pages,
+// copies them, then clears the map.
+template <std::size_t MemorySize, std::size_t PageSize = 0x100>
+class DirtyPageMap {
+    static_assert(MemorySize % PageSize == 0, "Memory size must be a whole number of pages");
+    static_assert((MemorySize / PageSize) % 64 == 0, "Page count must fill whole bitmap words");
+
+public:
+    static constexpr std::size_t kPageSize = PageSize;
+    static constexpr std::size_t kPageCount = MemorySize / PageSize;
+
+    void Mark(const uint32_t address) {
+        const std::size_t page = (address % MemorySize) / PageSize;
+        words[page / 64] |= uint64_t{1} << (page % 64);
+    }
+
+    // Marks every page touched by [address, address + length), which must not wrap
+    void MarkRange(const uint32_t address, const uint32_t length) {
+        const std::size_t last = (address % MemorySize + length - 1) / PageSize;
+        for (std::size_t page = (address % MemorySize) / PageSize; page <= last; page++) {
+            words[page / 64] |= uint64_t{1} << (page % 64);
+        }
+    }
+
+    void MarkAll() { words.fill(~uint64_t{0}); }
+    void Clear() { words.fill(0); }
+
+    void ClearPage(const std::size_t page) {
+        words[page / 64] &= ~(uint64_t{1} << (page % 64));
+    }
+
+    [[nodiscard]] bool IsDirty(const std::size_t page) const {
+        return (words[page / 64] >> (page % 64)) & 1;
+    }
+
+    [[nodiscard]] bool IsDirtyAddress(const uint32_t address) const {
+        return IsDirty((address % MemorySize) / PageSize);
+    }
+
+    [[nodiscard]] bool Any() const {
+        for (const uint64_t word : words) {
+            if (word) return true;
+        }
+        return false;
+    }
+
+    // Calls fn(page_index) for every dirty page, lowest page first
+    template <typename Fn>
+    void ForEachDirty(Fn&& fn) const {
+        for (std::size_t w = 0; w < words.size(); w++) {
+            uint64_t word = words[w];
+            while (word) {
+                fn(w * 64 + std::countr_zero(word));
+                word &= word - 1;
+            }
+        }
+    }
+
+private:
+    std::array<uint64_t, kPageCount / 64> words{};
+};
+
+#endif //DIRTY_PAGES_H
@@ -0,0 +1,40 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#ifndef FLAT_BUS_H
+#define FLAT_BUS_H
+#include <cstdint>
+#include <vector>
+
+// 16MB of plain RAM with no mirrors, I/O or wait states, for running BasicCPU<FlatBus> in
+// conformance tests and microbenchmarks. Has the same interface as Bus.
+//
+// Code writes aren't tracked, so a block-cache CPU has to be told (SetBackend clears its cache)
+// after code in memory is rewritten behind its back.
+class FlatBus {
+    std::vector<uint8_t> memory = std::vector<uint8_t>(0x1000000, 0);
+
+public:
+    uint8_t Read(const uint32_t address) const { return memory[address & 0xFFFFFF]; }
+    void Write(const uint32_t address, const uint8_t value) { memory[address & 0xFFFFFF] = value; }
+
+    [[nodiscard]] uint8_t* GetMemory() { return memory.data(); }
+    // Same range as the SNES's WRAM, for JIT verification
+    [[nodiscard]] const uint8_t* GetWRAM() const { return memory.data() + 0x7E0000; }
+
+    [[nodiscard]] bool IsPlainMemory(uint32_t) const { return true; }
+    [[nodiscard]] uint64_t GetSideEffectReads() const { return 0; }
+    // Nothing here is WRAM in the Bus sense: no code pages or self-overwrite checks
+    static int32_t WRAMOffset(uint32_t) { return -1; }
+
+    // MVN/MVP fall back to single bytes
+    bool CopyBlock(uint32_t, uint32_t, uint32_t, bool) { return false; }
+
+    void MarkCodePage(uint32_t) {}
+    [[nodiscard]] bool HasCodeWrites() const { return false; }
+    template <typename Fn>
+    void TakeWrittenCodePages(Fn&&) {}
+};
+
+#endif //FLAT_BUS_H
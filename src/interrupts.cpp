@@ -0,0 +1,171 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#include "interrupts.h"
+
+#include "cpu.h"
+#include "ppu.h"
+
+InterruptController::InterruptController(CPU* cpu, Scheduler* scheduler, std::function<uint64_t()> clock)
+    : cpu(cpu), scheduler(scheduler), clock(std::move(clock)) {
+    timer_event = scheduler->Register([this](uint64_t) { OnTimer(); });
+    auto_joypad_event = scheduler->Register([this](uint64_t) { auto_joypad_busy = false; });
+}
+
+void InterruptController::Reset() {
+    nmitimen = 0;
+    htime = 0x1FF;
+    vtime = 0x1FF;
+    nmi_flag = false;
+    hblank_polled = false;
+    vblank = false;
+    auto_joypad_busy = false;
+    SetTimerFlag(false);
+    scheduler->Cancel(timer_event);
+    scheduler->Cancel(auto_joypad_event);
+}
+
+void InterruptController::SaveState(StateWriter& writer) const {
+    writer.Write(nmitimen);
+    writer.Write(htime);
+    writer.Write(vtime);
+    writer.Write(nmi_flag);
+    writer.Write(timer_flag);
+    writer.Write(vblank);
+    writer.Write(auto_joypad_busy);
+    writer.Write(scheduler->PendingTime(timer_event));
+    writer.Write(scheduler->PendingTime(auto_joypad_event));
+}
+
+void InterruptController::LoadState(StateReader& reader) {
+    bool timer = false;
+    uint64_t timer_time = Scheduler::kNever, auto_joypad_time = Scheduler::kNever;
+    reader.Read(nmitimen);
+    reader.Read(htime);
+    reader.Read(vtime);
+    reader.Read(nmi_flag);
+    reader.Read(timer);
+    reader.Read(vblank);
+    reader.Read(auto_joypad_busy);
+    reader.Read(timer_time);
+    reader.Read(auto_joypad_time);
+    hblank_polled = false;
+
+    // The CPU's own state already says whether it was waiting, so don't let the line wake it
+    timer_flag = timer;
+    cpu->RestoreIRQLine(timer);
+    scheduler->Restore(timer_event, timer_time);
+    scheduler->Restore(auto_joypad_event, auto_joypad_time);
+}
+
+uint8_t InterruptController::Read(const uint16_t address) {
+    switch (address) {
+        case 0x4210: {
+            // RDNMI, low bits are the CPU version
+            const uint8_t value = (nmi_flag ? 0x80 : 0x00) | 0x02;
+            nmi_flag = false;
+            return value;
+        }
+        case 0x4211: {
+            // TIMEUP, reading it acknowledges the IRQ
+            const uint8_t value = timer_flag ? 0x80 : 0x00;
+            SetTimerFlag(false);
+            return value;
+        }
+        case 0x4212: {
+            // HVBJOY
+            hblank_polled = true;
+            const uint64_t h = clock() / PPU::kMasterCyclesPerDot % PPU::kDotsPerScanline;
+            return (vblank ? 0x80 : 0x00) |
+                   (h >= PPU::kHBlankStartDot || h < PPU::kHBlankEndDot ? 0x40 : 0x00) |
+                   (auto_joypad_busy ? 0x01 : 0x00);
+        }
+        default:
+            return 0x00;
+    }
+}
+
+void InterruptController::Write(const uint16_t address, const uint8_t value) {
+    switch (address) {
+        case 0x4200: {
+            // Enabling NMI in the middle of VBlank fires it straight away
+            const bool nmi_enabled = (value & 0x80) && !(nmitimen & 0x80);
+            nmitimen = value;
+            if (nmi_enabled && nmi_flag) cpu->RaiseNMI();
+            if (!(value & 0x30)) SetTimerFlag(false);
+            break;
+        }
+        case 0x4207: htime = (htime & 0x100) | value; break;
+        case 0x4208: htime = (htime & 0x0FF) | ((value & 0x01) << 8); break;
+        case 0x4209: vtime = (vtime & 0x100) | value; break;
+        case 0x420A: vtime = (vtime & 0x0FF) | ((value & 0x01) << 8); break;
+        default: return;
+    }
+    ScheduleTimer();
+}
+
+void InterruptController::OnVBlankStart() {
+    vblank = true;
+    nmi_flag = true;
+    if (nmitimen & 0x80) cpu->RaiseNMI();
+}
+
+void InterruptController::OnAutoJoypadRead(const uint64_t time) {
+    auto_joypad_busy = true;
+    scheduler->Schedule(auto_joypad_event, time + kAutoJoypadMasterCycles);
+}
+
+void InterruptController::OnFrameEnd() {
+    vblank = false;
+    nmi_flag = false;
+}
+
+void InterruptController::OnTimer() {
+    SetTimerFlag(true);
+    ScheduleTimer();
+}
+
+void InterruptController::SetTimerFlag(const bool value) {
+    timer_flag = value;
+    cpu->SetIRQLine(value);
+}
+
+// Queues the next H/V counter match after the current time, per NMITIMEN bits 4-5
+void InterruptController::ScheduleTimer() {
+    const bool h_enabled = nmitimen & 0x10;
+    const bool v_enabled = nmitimen & 0x20;
+    if ((!h_enabled && !v_enabled) ||
+        (h_enabled && htime >= PPU::kDotsPerScanline) ||
+        (v_enabled && vtime >= PPU::kScanlinesPerFrame)) {
+        scheduler->Cancel(timer_event);
+        return;
+    }
+
+    const uint64_t now = clock() / PPU::kMasterCyclesPerDot;
+    const uint64_t frame_start = now - now % PPU::kDotsPerFrame;
+    const uint64_t h = h_enabled ? htime : 0;
+
+    uint64_t target;
+    if (v_enabled) {
+        target = frame_start + vtime * PPU::kDotsPerScanline + h;
+        if (target <= now) target += PPU::kDotsPerFrame;
+    } else {
+        // H only: every line
+        target = now - now % PPU::kDotsPerScanline + h;
+        if (target <= now) target += PPU::kDotsPerScanline;
+    }
+    scheduler->Schedule(timer_event, target * PPU::kMasterCyclesPerDot);
+}
+
+uint64_t InterruptController::NextHBlankEdge(const uint64_t now) {
+    const uint64_t dot = now / PPU::kMasterCyclesPerDot;
+    const uint64_t line_start = dot - dot % PPU::kDotsPerScanline;
+    const uint64_t h = dot % PPU::kDotsPerScanline;
+
+    uint64_t edge;
+    if (h < PPU::kHBlankEndDot) edge = line_start + PPU::kHBlankEndDot;
+    else if (h < PPU::kHBlankStartDot) edge = line_start + PPU::kHBlankStartDot;
+    else edge = line_start + PPU::kDotsPerScanline + PPU::kHBlankEndDot;
+    return edge * PPU::kMasterCyclesPerDot;
+}
@@ -0,0 +1,67 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#ifndef INTERRUPTS_H
+#define INTERRUPTS_H
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include "save_state.h"
+#include "scheduler.h"
+
+class Bus;
+template <typename BusT> class BasicCPU;
+using CPU = BasicCPU<Bus>;
+
+// NMI/IRQ side of the CPU's I/O registers: $4200 (NMITIMEN), $4207-$420A (HTIME/VTIME),
+// $4210 (RDNMI), $4211 (TIMEUP) and $4212 (HVBJOY)
+class InterruptController {
+    CPU* cpu;
+    Scheduler* scheduler;
+    Scheduler::EventId timer_event;
+    Scheduler::EventId auto_joypad_event;
+    std::function<uint64_t()> clock;    // Current master-clock time
+
+    uint8_t nmitimen = 0;
+    uint16_t htime = 0x1FF;
+    uint16_t vtime = 0x1FF;
+    bool nmi_flag = false;      // RDNMI bit 7, set at VBlank and cleared by reading
+    bool timer_flag = false;    // TIMEUP bit 7, drives the IRQ line until read
+    bool vblank = false;        // HVBJOY bit 7. VBlank starts at line 225 or 240 depending on overscan.
+    bool auto_joypad_busy = false;  // HVBJOY bit 0
+    bool hblank_polled = false;
+
+    void ScheduleTimer();
+    void SetTimerFlag(bool value);
+    void OnTimer();
+
+public:
+    InterruptController(CPU* cpu, Scheduler* scheduler, std::function<uint64_t()> clock);
+
+    void Reset();
+    // Includes when the timer and auto-joypad events are due
+    void SaveState(StateWriter& writer) const;
+    void LoadState(StateReader& reader);
+
+    uint8_t Read(uint16_t address);
+    void Write(uint16_t address, uint8_t value);
+
+    // Called by System from the scanline event
+    void OnVBlankStart();
+    void OnFrameEnd();
+
+    // Auto-joypad read, NMITIMEN bit 0. HVBJOY bit 0 stays set for as long as the hardware takes
+    // to clock in the pads.
+    static constexpr uint64_t kAutoJoypadMasterCycles = 4224;
+    [[nodiscard]] bool IsAutoJoypadEnabled() const { return nmitimen & 0x01; }
+    void OnAutoJoypadRead(uint64_t time);
+
+    // True once since the last call if HVBJOY was read. Its H-blank bit changes twice a line
+    // without an event, so idle loops polling it can only be skipped up to the next edge.
+    bool TakeHBlankPolled() { return std::exchange(hblank_polled, false); }
+    [[nodiscard]] static uint64_t NextHBlankEdge(uint64_t now);
+};
+
+#endif //INTERRUPTS_H
@@ -0,0 +1,781 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#include "jit.h"
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#ifdef BREADEDSNES_JIT_X86_64
+#include <sys/mman.h>
+#endif
+
+JIT::~JIT() {
+#ifdef BREADEDSNES_JIT_X86_64
+    if (code) munmap(code, kCodeBufferSize);
+#endif
+}
+
+bool JIT::IsSupported() {
+#ifdef BREADEDSNES_JIT_X86_64
+    return true;
+#else
+    return false;
+#endif
+}
+
+#ifdef BREADEDSNES_JIT_X86_64
+
+namespace {
+    // Host registers. rbx holds the CPU, r12d the instruction limit, r13 the direct page penalty
+    // (1 if D's low byte isn't 0) and r14d a value kept across a call.
+    enum Reg : uint8_t { kEAX = 0, kECX = 1, kEDX = 2, kESI = 6 };
+
+    // Condition codes, as encoded in Jcc and SETcc
+    enum Cond : uint8_t {
+        kOverflow = 0x0, kCarry = 0x2, kNotCarry = 0x3, kZero = 0x4, kNotZero = 0x5, kBelowOrEqual = 0x6,
+        kSign = 0x8
+    };
+
+    // ALU operations, as encoded in the reg field of the immediate forms
+    enum Alu : uint8_t { kAdd = 0, kOr = 1, kAdc = 2, kSbb = 3, kAnd = 4, kSub = 5, kXor = 6, kCmp = 7 };
+
+    // Just enough of an x86-64 assembler for the translator. Memory operands are always [rbx + disp].
+    class Emitter {
+        std::vector<uint8_t> bytes;
+
+        void Field(const uint8_t reg, const int32_t disp) {
+            if (disp >= -128 && disp < 128) {
+                Bytes({static_cast<uint8_t>(0x43 | (reg & 7) << 3), static_cast<uint8_t>(disp)});
+            } else {
+                Byte(0x83 | (reg & 7) << 3);
+                Imm32(disp);
+            }
+        }
+
+        static uint8_t Direct(const uint8_t reg, const uint8_t rm) { return 0xC0 | (reg & 7) << 3 | (rm & 7); }
+
+    public:
+        void Byte(const uint8_t value) { bytes.push_back(value); }
+
+        void Bytes(const std::initializer_list<uint8_t> values) {
+            for (const uint8_t value : values) Byte(value);
+        }
+
+        void Imm32(const uint32_t value) {
+            for (int i = 0; i < 4; i++) Byte((value >> (8 * i)) & 0xFF);
+        }
+
+        void Imm64(const uint64_t value) {
+            for (int i = 0; i < 8; i++) Byte((value >> (8 * i)) & 0xFF);
+        }
+
+        // movzx reg, byte/word [field]
+        void LoadByte(const Reg reg, const int32_t field) { Bytes({0x0F, 0xB6}); Field(reg, field); }
+        void LoadWord(const Reg reg, const int32_t field) { Bytes({0x0F, 0xB7}); Field(reg, field); }
+        // mov byte/word [field], reg
+        void StoreByte(const int32_t field, const Reg reg) { Byte(0x88); Field(reg, field); }
+        void StoreWord(const int32_t field, const Reg reg) { Bytes({0x66, 0x89}); Field(reg, field); }
+        void StoreDword(const int32_t field, const Reg reg) { Byte(0x89); Field(reg, field); }
+
+        void StoreByteImm(const int32_t field, const uint8_t value) { Byte(0xC6); Field(0, field); Byte(value); }
+        void StoreDwordImm(const int32_t field, const uint32_t value) { Byte(0xC7); Field(0, field); Imm32(value); }
+
+        // op byte/word [field], imm8
+        void ByteImm(const Alu op, const int32_t field, const uint8_t value) {
+            Byte(0x80);
+            Field(op, field);
+            Byte(value);
+        }
+        void WordImm(const Alu op, const int32_t field, const uint8_t value) {
+            Bytes({0x66, 0x83});
+            Field(op, field);
+            Byte(value);
+        }
+        void TestByte(const int32_t field, const uint8_t value) { Byte(0xF6); Field(0, field); Byte(value); }
+        void Set(const Cond cond, const int32_t field) {
+            Bytes({0x0F, static_cast<uint8_t>(0x90 | cond)});
+            Field(0, field);
+        }
+
+        // inc/dec byte/word [field]
+        void StepMemory(const bool decrement, const bool wide, const int32_t field) {
+            if (wide) Byte(0x66);
+            Byte(wide ? 0xFF : 0xFE);
+            Field(decrement, field);
+        }
+
+        // add qword [field], imm32 / r13
+        void AddQword(const int32_t field, const uint32_t value) {
+            if (value < 0x80) {
+                Bytes({0x48, 0x83});
+                Field(0, field);
+                Byte(value);
+            } else {
+                Bytes({0x48, 0x81});
+                Field(0, field);
+                Imm32(value);
+            }
+        }
+        void AddR13(const int32_t field) { Bytes({0x4C, 0x01}); Field(5, field); }
+
+        // op dst, src on the low 8, 16 or all 32 bits
+        void Op8(const Alu op, const Reg dst, const Reg src) {
+            Bytes({static_cast<uint8_t>(op << 3), Direct(src, dst)});
+        }
+        void Op16(const Alu op, const Reg dst, const Reg src) { Byte(0x66); Op32(op, dst, src); }
+        void Op32(const Alu op, const Reg dst, const Reg src) {
+            Bytes({static_cast<uint8_t>(op << 3 | 1), Direct(src, dst)});
+        }
+        void OpImm(const Alu op, const Reg reg, const uint32_t value) { Bytes({0x81, Direct(op, reg)}); Imm32(value); }
+        void TestImm(const Reg reg, const uint32_t value) { Bytes({0xF7, Direct(0, reg)}); Imm32(value); }
+        void TestSelf(const Reg reg) { Bytes({0x85, Direct(reg, reg)}); }
+
+        void MovImm(const Reg reg, const uint32_t value) { Byte(0xB8 | reg); Imm32(value); }
+        void Mov(const Reg dst, const Reg src) { Bytes({0x89, Direct(src, dst)}); }
+        void MovzxByte(const Reg dst, const Reg src) { Bytes({0x0F, 0xB6, Direct(dst, src)}); }
+        void MovzxWord(const Reg dst, const Reg src) { Bytes({0x0F, 0xB7, Direct(dst, src)}); }
+        void Shl(const Reg reg, const uint8_t count) { Bytes({0xC1, Direct(4, reg), count}); }
+        // rcl 2, rcr 3, shl 4, shr 5, by one
+        void ShiftOne(const uint8_t kind, const bool wide, const Reg reg) {
+            if (wide) Bytes({0x66, 0xD1, Direct(kind, reg)});
+            else Bytes({0xD0, Direct(kind, reg)});
+        }
+        // inc/dec on the low 8 or 16 bits
+        void StepReg(const bool decrement, const bool wide, const Reg reg) {
+            if (wide) Bytes({0x66, 0xFF, Direct(decrement, reg)});
+            else Bytes({0xFE, Direct(decrement, reg)});
+        }
+        void NegByte(const Reg reg) { Bytes({0xF6, Direct(3, reg)}); }
+
+        void SaveEAX() { Bytes({0x41, 0x89, 0xC6}); }      // mov r14d, eax
+        void RestoreEAX() { Bytes({0x44, 0x89, 0xF0}); }   // mov eax, r14d
+
+        // Calls fn(cpu, esi, edx)
+        void Call(const void* fn) {
+            Bytes({0x48, 0x89, 0xDF});     // mov rdi, rbx
+            Bytes({0x48, 0xB8});           // mov rax, fn
+            Imm64(reinterpret_cast<uint64_t>(fn));
+            Bytes({0xFF, 0xD0});           // call rax
+        }
+
+        // Jumps with a rel32 to patch; return where it is
+        size_t Jcc(const Cond cond) {
+            Bytes({0x0F, static_cast<uint8_t>(0x80 | cond)});
+            Imm32(0);
+            return bytes.size() - 4;
+        }
+        size_t Jmp() {
+            Byte(0xE9);
+            Imm32(0);
+            return bytes.size() - 4;
+        }
+        // Short forward jump over a few instructions
+        size_t JccShort(const Cond cond) {
+            Bytes({static_cast<uint8_t>(0x70 | cond), 0});
+            return bytes.size() - 1;
+        }
+        void PatchShort(const size_t at) { bytes[at] = static_cast<uint8_t>(bytes.size() - at - 1); }
+
+        [[nodiscard]] size_t Position() const { return bytes.size(); }
+
+        void PatchRel32(const size_t at, const size_t target) {
+            const auto rel = static_cast<int32_t>(static_cast<int64_t>(target) - static_cast<int64_t>(at + 4));
+            std::memcpy(&bytes[at], &rel, sizeof(rel));
+        }
+
+        [[nodiscard]] const std::vector<uint8_t>& Data() const { return bytes; }
+    };
+
+    enum class Kind : uint8_t {
+        Unsupported, Nop, ClearCarry, SetCarry, ClearOverflow,
+        Load, Store, And, Or, Xor, Add, Subtract, Compare, Bit,
+        Increment, Decrement,   // A register, or memory when there's an address
+        ShiftLeft, ShiftRight, RotateLeft, RotateRight,
+        Transfer, Branch, Jump
+    };
+
+    enum class Register : uint8_t { A, X, Y, Zero };
+
+    // Where an operand comes from, spelled out the way each handler computes it
+    struct Address {
+        enum class Mode : uint8_t { None, Immediate, Direct, Absolute, Long } mode = Mode::None;
+        enum class Index : uint8_t { None, X, Y, NarrowX } index = Index::None;  // NarrowX: X & 0xFF with 8-bit X
+        bool data_bank = false;     // DB in bits 16-23 before the index is added
+        bool bank_after = false;    // DB ORed in after it
+        bool wrap = false;          // Kept to 16 bits
+        bool page_cross = false;    // One more cycle if the index carries out of the low byte
+    };
+
+    enum class Condition : uint8_t { Always, Plus, Minus, OverflowClear, OverflowSet, CarryClear, CarrySet,
+                                     NotEqual, Equal };
+
+    struct Operation {
+        Kind kind = Kind::Unsupported;
+        Register reg = Register::A;     // Operated on, or the destination of a transfer
+        Address address{};
+        Register source = Register::A;  // Transfers
+        Condition condition = Condition::Always;
+    };
+
+    using Mode = Address::Mode;
+    using Index = Address::Index;
+
+    constexpr Address kImmediate{.mode = Mode::Immediate};
+    constexpr Address kDirect{.mode = Mode::Direct};
+    constexpr Address kDirectWrapped{.mode = Mode::Direct, .wrap = true};
+    constexpr Address kAbsolute{.mode = Mode::Absolute};
+    constexpr Address kAbsoluteData{.mode = Mode::Absolute, .data_bank = true};
+    constexpr Address kLong{.mode = Mode::Long};
+
+    Operation Describe(const uint8_t opcode) {
+        using enum Kind;
+        constexpr Register A = Register::A, X = Register::X, Y = Register::Y;
+
+        switch (opcode) {
+            case 0xEA: return {Nop};
+            case 0x18: return {ClearCarry};
+            case 0x38: return {SetCarry};
+            case 0xB8: return {ClearOverflow};
+
+            case 0xA9: return {Load, A, kImmediate};
+            case 0xA5: return {Load, A, kDirect};
+            case 0xAD: return {Load, A, kAbsolute};
+            case 0xB5: return {Load, A, {.mode = Mode::Direct, .index = Index::NarrowX}};
+            case 0xBD: return {Load, A, {.mode = Mode::Absolute, .index = Index::X, .page_cross = true}};
+            case 0xB9: return {Load, A, {.mode = Mode::Absolute, .index = Index::Y, .page_cross = true}};
+            case 0xAF: return {Load, A, kLong};
+            case 0xA2: return {Load, X, kImmediate};
+            case 0xA6: return {Load, X, kDirect};
+            case 0xAE: return {Load, X, kAbsolute};
+            case 0xA0: return {Load, Y, kImmediate};
+            case 0xA4: return {Load, Y, kDirect};
+            case 0xAC: return {Load, Y, kAbsolute};
+
+            case 0x85: return {Store, A, kDirectWrapped};
+            case 0x8D: return {Store, A, kAbsoluteData};
+            case 0x95: return {Store, A, {.mode = Mode::Direct, .index = Index::X, .wrap = true}};
+            case 0x9D: return {Store, A, {.mode = Mode::Absolute, .index = Index::X, .data_bank = true}};
+            case 0x99: return {Store, A, {.mode = Mode::Absolute, .index = Index::Y, .data_bank = true}};
+            case 0x8F: return {Store, A, kLong};
+            case 0x86: return {Store, X, kDirectWrapped};
+            case 0x8E: return {Store, X, kAbsoluteData};
+            case 0x84: return {Store, Y, kDirectWrapped};
+            case 0x8C: return {Store, Y, kAbsoluteData};
+            case 0x64: return {Store, Register::Zero, kDirect};
+            case 0x9C: return {Store, Register::Zero, kAbsoluteData};
+            case 0x74: return {Store, Register::Zero, {.mode = Mode::Direct, .index = Index::NarrowX}};
+            case 0x9E: return {Store, Register::Zero, {.mode = Mode::Absolute, .index = Index::NarrowX,
+                                                       .bank_after = true}};
+
+            case 0x29: return {And, A, kImmediate};
+            case 0x25: return {And, A, kDirect};
+            case 0x2D: return {And, A, kAbsoluteData};
+            case 0x09: return {Or, A, kImmediate};
+            case 0x05: return {Or, A, kDirect};
+            case 0x0D: return {Or, A, kAbsoluteData};
+            case 0x49: return {Xor, A, kImmediate};
+            case 0x45: return {Xor, A, kDirect};
+            case 0x4D: return {Xor, A, kAbsoluteData};
+            case 0x69: return {Add, A, kImmediate};
+            case 0x65: return {Add, A, kDirect};
+            case 0x6D: return {Add, A, kAbsoluteData};
+            case 0xE9: return {Subtract, A, kImmediate};
+            case 0xE5: return {Subtract, A, kDirect};
+            case 0xED: return {Subtract, A, kAbsoluteData};
+            case 0xC9: return {Compare, A, kImmediate};
+            case 0xC5: return {Compare, A, kDirectWrapped};
+            case 0xCD: return {Compare, A, kAbsoluteData};
+            case 0xE0: return {Compare, X, kImmediate};
+            case 0xE4: return {Compare, X, kDirectWrapped};
+            case 0xEC: return {Compare, X, kAbsoluteData};
+            case 0xC0: return {Compare, Y, kImmediate};
+            case 0xC4: return {Compare, Y, kDirectWrapped};
+            case 0xCC: return {Compare, Y, kAbsoluteData};
+            case 0x89: return {Bit, A, kImmediate};
+            case 0x24: return {Bit, A, kDirect};
+            case 0x2C: return {Bit, A, kAbsoluteData};
+
+            case 0x1A: return {Increment, A};
+            case 0xE8: return {Increment, X};
+            case 0xC8: return {Increment, Y};
+            case 0x3A: return {Decrement, A};
+            case 0xCA: return {Decrement, X};
+            case 0x88: return {Decrement, Y};
+            case 0xE6: return {Increment, A, kDirectWrapped};
+            case 0xEE: return {Increment, A, kAbsoluteData};
+            case 0xC6: return {Decrement, A, kDirectWrapped};
+            case 0xCE: return {Decrement, A, kAbsoluteData};
+
+            case 0x0A: return {ShiftLeft};
+            case 0x4A: return {ShiftRight};
+            case 0x2A: return {RotateLeft};
+            case 0x6A: return {RotateRight};
+
+            case 0xAA: return {Transfer, X, {}, A};
+            case 0xA8: return {Transfer, Y, {}, A};
+            case 0x8A: return {Transfer, A, {}, X};
+            case 0x98: return {Transfer, A, {}, Y};
+
+            case 0x80: return {Branch, A, {}, A, Condition::Always};
+            case 0x10: return {Branch, A, {}, A, Condition::Plus};
+            case 0x30: return {Branch, A, {}, A, Condition::Minus};
+            case 0x50: return {Branch, A, {}, A, Condition::OverflowClear};
+            case 0x70: return {Branch, A, {}, A, Condition::OverflowSet};
+            case 0x90: return {Branch, A, {}, A, Condition::CarryClear};
+            case 0xB0: return {Branch, A, {}, A, Condition::CarrySet};
+            case 0xD0: return {Branch, A, {}, A, Condition::NotEqual};
+            case 0xF0: return {Branch, A, {}, A, Condition::Equal};
+            case 0x4C: return {Jump};
+
+            default: return {};
+        }
+    }
+
+    class BlockCompiler {
+        const JIT::Layout& layout;
+        const BasicBlock& block;
+        const bool m_8bit;
+        const bool x_8bit;
+        size_t count = 0;               // Instructions compiled
+        std::vector<uint32_t> prefix;   // Fewest cycles of the instructions before each one
+        Emitter e;
+        std::vector<std::pair<size_t, size_t>> exits;  // rel32 to patch, index of the instruction it stops before
+        std::vector<size_t> returns;                   // rel32s to patch with the epilogue
+
+        int32_t Field(const Register reg) const {
+            return reg == Register::A ? layout.A : reg == Register::X ? layout.X : layout.Y;
+        }
+
+        bool Wide(const Register reg) const { return reg == Register::A ? !m_8bit : !x_8bit; }
+
+        void Exit(const Cond cond, const size_t before) { exits.emplace_back(e.Jcc(cond), before); }
+
+        void LoadRegister(const Reg to, const Register reg, const bool wide) {
+            if (wide) e.LoadWord(to, Field(reg));
+            else e.LoadByte(to, Field(reg));
+        }
+
+        // N and Z from the zero-extended result in eax
+        void SetNZ(const bool wide) {
+            e.StoreWord(layout.flag_z, kEAX);
+            if (!wide) e.Shl(kEAX, 8);
+            e.StoreWord(layout.flag_n, kEAX);
+        }
+
+        // Carry into the host's CF
+        void LoadCarry() {
+            e.LoadByte(kEDX, layout.flag_c);
+            e.NegByte(kEDX);
+        }
+
+        void EmitAddress(const Address& address, const uint32_t operand) {
+            switch (address.mode) {
+                case Mode::Direct:
+                    e.LoadWord(kESI, layout.D);
+                    if (operand & 0xFF) e.OpImm(kAdd, kESI, operand & 0xFF);
+                    break;
+                case Mode::Absolute:
+                    e.MovImm(kESI, operand & 0xFFFF);
+                    break;
+                default:
+                    e.MovImm(kESI, operand & 0xFFFFFF);
+                    break;
+            }
+            if (address.data_bank) {
+                e.LoadByte(kEAX, layout.DB);
+                e.Shl(kEAX, 16);
+                e.Op32(kOr, kESI, kEAX);
+            }
+            if (address.index != Index::None) {
+                if (address.index == Index::Y) e.LoadWord(kEAX, layout.Y);
+                else if (address.index == Index::NarrowX && x_8bit) e.LoadByte(kEAX, layout.X);
+                else e.LoadWord(kEAX, layout.X);
+                e.Op32(kAdd, kESI, kEAX);
+            }
+            if (address.bank_after) {
+                e.LoadByte(kEAX, layout.DB);
+                e.Shl(kEAX, 16);
+                e.Op32(kOr, kESI, kEAX);
+            }
+            if (address.wrap) e.MovzxWord(kESI, kESI);
+        }
+
+        // Operand value into ecx. Memory that isn't WRAM or ROM leaves before the instruction.
+        void EmitOperand(const Address& address, const uint32_t operand, const bool wide, const size_t index) {
+            if (address.mode == Mode::Immediate) {
+                e.MovImm(kECX, operand & (wide ? 0xFFFF : 0xFF));
+                return;
+            }
+            EmitAddress(address, operand);
+            e.Call(reinterpret_cast<const void*>(wide ? layout.read16 : layout.read8));
+            e.TestSelf(kEAX);
+            Exit(kSign, index);
+            e.Mov(kECX, kEAX);
+        }
+
+        // Cycles the handler adds on top of the fewest, once the instruction can't bail any more.
+        // Leaves eax alone.
+        void EmitPenalties(const Address& address, const uint32_t operand) {
+            if (address.mode == Mode::Direct) e.AddR13(layout.cycles);
+            if (address.page_cross) {
+                const uint32_t base = operand & 0xFFFF;
+                e.LoadWord(kECX, address.index == Index::Y ? layout.Y : layout.X);
+                e.OpImm(kAdd, kECX, base);
+                e.OpImm(kXor, kECX, base);
+                e.TestImm(kECX, 0xFF00);
+                const size_t skip = e.JccShort(kZero);
+                e.AddQword(layout.cycles, 1);
+                e.PatchShort(skip);
+            }
+        }
+
+        void EmitInstruction(const size_t index) {
+            const DecodedInstruction& instruction = block.instructions[index];
+            const Operation op = Describe(instruction.opcode);
+            const uint32_t operand = instruction.operand;
+            const bool wide = Wide(op.reg);
+
+            switch (op.kind) {
+                case Kind::Nop:
+                    break;
+                case Kind::ClearCarry:
+                case Kind::SetCarry:
+                    e.StoreByteImm(layout.flag_c, op.kind == Kind::SetCarry);
+                    break;
+                case Kind::ClearOverflow:
+                    e.StoreByteImm(layout.flag_v, 0);
+                    break;
+
+                case Kind::Load:
+                    EmitOperand(op.address, operand, wide, index);
+                    if (op.reg == Register::A && !wide) e.StoreByte(layout.A, kECX);
+                    else e.StoreWord(Field(op.reg), kECX);
+                    e.Mov(kEAX, kECX);
+                    SetNZ(wide);
+                    EmitPenalties(op.address, operand);
+                    break;
+
+                case Kind::And:
+                case Kind::Or:
+                case Kind::Xor:
+                    EmitOperand(op.address, operand, wide, index);
+                    LoadRegister(kEAX, Register::A, wide);
+                    e.Op32(op.kind == Kind::And ? kAnd : op.kind == Kind::Or ? kOr : kXor, kEAX, kECX);
+                    if (wide) e.StoreWord(layout.A, kEAX);
+                    else e.StoreByte(layout.A, kEAX);
+                    SetNZ(wide);
+                    EmitPenalties(op.address, operand);
+                    break;
+
+                case Kind::Add:
+                case Kind::Subtract:
+                    // Decimal mode is left to the interpreter
+                    e.TestByte(layout.P, 0x08);
+                    Exit(kNotZero, index);
+                    EmitOperand(op.address, operand, wide, index);
+                    LoadRegister(kEAX, Register::A, wide);
+                    if (op.kind == Kind::Add) {
+                        LoadCarry();
+                    } else {
+                        e.ByteImm(kCmp, layout.flag_c, 1);  // CF = borrow = !carry
+                    }
+                    if (wide) e.Op16(op.kind == Kind::Add ? kAdc : kSbb, kEAX, kECX);
+                    else e.Op8(op.kind == Kind::Add ? kAdc : kSbb, kEAX, kECX);
+                    e.Set(op.kind == Kind::Add ? kCarry : kNotCarry, layout.flag_c);
+                    e.Set(kOverflow, layout.flag_v);
+                    if (wide) e.StoreWord(layout.A, kEAX);
+                    else e.StoreByte(layout.A, kEAX);
+                    SetNZ(wide);
+                    EmitPenalties(op.address, operand);
+                    break;
+
+                case Kind::Compare:
+                    EmitOperand(op.address, operand, wide, index);
+                    LoadRegister(kEAX, op.reg, wide);
+                    e.Op32(kSub, kEAX, kECX);
+                    e.Set(kNotCarry, layout.flag_c);
+                    if (wide) e.MovzxWord(kEAX, kEAX);
+                    else e.MovzxByte(kEAX, kEAX);
+                    SetNZ(wide);
+                    EmitPenalties(op.address, operand);
+                    break;
+
+                case Kind::Bit:
+                    EmitOperand(op.address, operand, wide, index);
+                    LoadRegister(kEAX, Register::A, wide);
+                    e.Op32(kAnd, kEAX, kECX);
+                    e.StoreWord(layout.flag_z, kEAX);
+                    if (op.address.mode != Mode::Immediate) {
+                        e.Mov(kEAX, kECX);
+                        if (!wide) e.Shl(kEAX, 8);
+                        e.StoreWord(layout.flag_n, kEAX);
+                        e.TestImm(kECX, wide ? 0x4000 : 0x40);
+                        e.Set(kNotZero, layout.flag_v);
+                    }
+                    EmitPenalties(op.address, operand);
+                    break;
+
+                case Kind::Store: {
+                    EmitAddress(op.address, operand);
+                    const bool store_wide = op.reg == Register::Zero ? !m_8bit : wide;
+                    if (op.reg == Register::Zero) e.Op32(kXor, kEDX, kEDX);
+                    else LoadRegister(kEDX, op.reg, store_wide);
+                    e.Call(reinterpret_cast<const void*>(store_wide ? layout.write16 : layout.write8));
+                    e.TestSelf(kEAX);
+                    Exit(kSign, index);
+                    EmitPenalties(op.address, operand);
+                    e.TestSelf(kEAX);
+                    Exit(kNotZero, index + 1);
+                    break;
+                }
+
+                case Kind::Increment:
+                case Kind::Decrement: {
+                    const bool decrement = op.kind == Kind::Decrement;
+                    if (op.address.mode == Mode::None) {
+                        e.StepMemory(decrement, wide, Field(op.reg));
+                        LoadRegister(kEAX, op.reg, wide);
+                        SetNZ(wide);
+                        break;
+                    }
+                    // Read, modify, write; the read has already checked the address
+                    EmitOperand(op.address, operand, wide, index);
+                    e.StepReg(decrement, wide, kECX);
+                    if (wide) e.MovzxWord(kEAX, kECX);
+                    else e.MovzxByte(kEAX, kECX);
+                    e.SaveEAX();
+                    e.Mov(kEDX, kEAX);
+                    EmitAddress(op.address, operand);
+                    e.Call(reinterpret_cast<const void*>(wide ? layout.write16 : layout.write8));
+                    e.TestSelf(kEAX);
+                    Exit(kSign, index);
+                    e.Mov(kECX, kEAX);
+                    e.RestoreEAX();
+                    SetNZ(wide);
+                    EmitPenalties(op.address, operand);
+                    e.TestSelf(kECX);
+                    Exit(kNotZero, index + 1);
+                    break;
+                }
+
+                case Kind::ShiftLeft:
+                case Kind::ShiftRight:
+                case Kind::RotateLeft:
+                case Kind::RotateRight: {
+                    LoadRegister(kEAX, Register::A, wide);
+                    static constexpr uint8_t kShiftKinds[] = {4, 5, 2, 3};     // shl, shr, rcl, rcr
+                    const size_t shift = static_cast<size_t>(op.kind) - static_cast<size_t>(Kind::ShiftLeft);
+                    if (op.kind == Kind::RotateLeft || op.kind == Kind::RotateRight) LoadCarry();
+                    e.ShiftOne(kShiftKinds[shift], wide, kEAX);
+                    e.Set(kCarry, layout.flag_c);
+                    if (wide) {
+                        e.StoreWord(layout.A, kEAX);
+                    } else {
+                        e.StoreByte(layout.A, kEAX);
+                        e.MovzxByte(kEAX, kEAX);
+                    }
+                    SetNZ(wide);
+                    break;
+                }
+
+                case Kind::Transfer:
+                    if (op.reg == Register::A && wide) {
+                        // 16-bit A takes all of X or Y, which is only 8 bits wide with 8-bit indexes
+                        LoadRegister(kEAX, op.source, !x_8bit);
+                        e.StoreWord(layout.A, kEAX);
+                    } else {
+                        LoadRegister(kEAX, op.source, wide);
+                        if (wide) e.StoreWord(Field(op.reg), kEAX);
+                        else e.StoreByte(Field(op.reg), kEAX);
+                    }
+                    SetNZ(wide);
+                    break;
+
+                case Kind::Branch:
+                    EmitBranch(index, op.condition);
+                    break;
+                case Kind::Jump:
+                    EmitJump(index);
+                    break;
+
+                case Kind::Unsupported:
+                    break;
+            }
+        }
+
+        // Ends the block at its last instruction: PC and cycles set, then back to the caller
+        void Return(const uint32_t pc, const uint32_t cycles, const bool taken) {
+            e.AddQword(layout.cycles, cycles);
+            e.StoreDwordImm(layout.PC, pc);
+            if (taken) e.Call(reinterpret_cast<const void*>(layout.check_idle_loop));
+            e.MovImm(kEAX, count);
+            returns.push_back(e.Jmp());
+        }
+
+        void EmitBranch(const size_t index, const Condition condition) {
+            const DecodedInstruction& instruction = block.instructions[index];
+            const uint32_t next = instruction.address + instruction.length;
+            const auto target = static_cast<uint32_t>(static_cast<int32_t>(next) +
+                                                      static_cast<int8_t>(instruction.operand & 0xFF));
+            const uint32_t cycles = prefix[index] + instruction.cycles;
+            // BRA's fewest already has the taken branch's cycle in it
+            const uint32_t taken_cycles = cycles + (condition != Condition::Always) +
+                                          ((next & 0xFF00) != (target & 0xFF00));
+
+            size_t taken = 0;
+            switch (condition) {
+                case Condition::Always:
+                    Return(target, taken_cycles, true);
+                    return;
+                case Condition::Plus:
+                case Condition::Minus:
+                    e.TestByte(layout.flag_n + 1, 0x80);
+                    taken = e.Jcc(condition == Condition::Plus ? kZero : kNotZero);
+                    break;
+                case Condition::OverflowClear:
+                case Condition::OverflowSet:
+                    e.ByteImm(kCmp, layout.flag_v, 0);
+                    taken = e.Jcc(condition == Condition::OverflowClear ? kZero : kNotZero);
+                    break;
+                case Condition::CarryClear:
+                case Condition::CarrySet:
+                    e.ByteImm(kCmp, layout.flag_c, 0);
+                    taken = e.Jcc(condition == Condition::CarryClear ? kZero : kNotZero);
+                    break;
+                case Condition::NotEqual:
+                case Condition::Equal:
+                    e.WordImm(kCmp, layout.flag_z, 0);
+                    taken = e.Jcc(condition == Condition::NotEqual ? kNotZero : kZero);
+                    break;
+            }
+            Return(next, cycles, false);
+            e.PatchRel32(taken, e.Position());
+            Return(target, taken_cycles, true);
+        }
+
+        // JMP $nnnn stays in the program bank
+        void EmitJump(const size_t index) {
+            const DecodedInstruction& instruction = block.instructions[index];
+            e.LoadByte(kEAX, layout.PB);
+            e.Shl(kEAX, 16);
+            e.OpImm(kOr, kEAX, instruction.operand & 0xFFFF);
+            e.StoreDword(layout.PC, kEAX);
+            e.AddQword(layout.cycles, prefix[index] + instruction.cycles);
+            e.Call(reinterpret_cast<const void*>(layout.check_idle_loop));
+            e.MovImm(kEAX, count);
+            returns.push_back(e.Jmp());
+        }
+
+    public:
+        BlockCompiler(const JIT::Layout& cpu_layout, const BasicBlock& compiled, const bool m, const bool x)
+            : layout(cpu_layout), block(compiled), m_8bit(m), x_8bit(x) {}
+
+        // Returns false if the block doesn't start with at least `min_instructions` the translator handles
+        bool Compile(const size_t min_instructions) {
+            while (count < block.instructions.size() && Describe(block.instructions[count].opcode).kind !=
+                   Kind::Unsupported) {
+                count++;
+            }
+            if (!count || count < min_instructions) return false;
+
+            prefix.resize(count + 1);
+            for (size_t i = 0; i < count; i++) prefix[i + 1] = prefix[i] + block.instructions[i].cycles;
+
+            // Prologue
+            e.Byte(0x53);                          // push rbx
+            e.Bytes({0x41, 0x54});                 // push r12
+            e.Bytes({0x41, 0x55});                 // push r13
+            e.Bytes({0x41, 0x56});                 // push r14
+            e.Bytes({0x48, 0x83, 0xEC, 0x08});     // sub rsp, 8
+            e.Bytes({0x48, 0x89, 0xFB});           // mov rbx, rdi
+            e.Bytes({0x41, 0x89, 0xF4});           // mov r12d, esi
+            e.Bytes({0x45, 0x31, 0xED});           // xor r13d, r13d
+            e.ByteImm(kCmp, layout.D, 0);
+            e.Bytes({0x41, 0x0F, 0x95, 0xC5});     // setne r13b
+
+            for (size_t i = 0; i < count; i++) {
+                if (i) {
+                    e.Bytes({0x41, 0x81, 0xFC});   // cmp r12d, i
+                    e.Imm32(i);
+                    Exit(kBelowOrEqual, i);
+                }
+                EmitInstruction(i);
+            }
+            const Kind last = Describe(block.instructions[count - 1].opcode).kind;
+            if (last != Kind::Branch && last != Kind::Jump) exits.emplace_back(e.Jmp(), count);
+
+            // One exit per instruction boundary that's jumped to
+            std::vector<size_t> stubs(count + 1, SIZE_MAX);
+            for (const auto& [at, before] : exits) stubs[before] = 0;
+            for (size_t i = 0; i <= count; i++) {
+                if (stubs[i] == SIZE_MAX) continue;
+                stubs[i] = e.Position();
+                if (prefix[i]) e.AddQword(layout.cycles, prefix[i]);
+                const DecodedInstruction& previous = block.instructions[i ? i - 1 : 0];
+                e.StoreDwordImm(layout.PC, i < count ? block.instructions[i].address
+                                                     : previous.address + previous.length);
+                e.MovImm(kEAX, i);
+                returns.push_back(e.Jmp());
+            }
+            for (const auto& [at, before] : exits) e.PatchRel32(at, stubs[before]);
+
+            // Epilogue
+            const size_t epilogue = e.Position();
+            for (const size_t at : returns) e.PatchRel32(at, epilogue);
+            e.Bytes({0x48, 0x83, 0xC4, 0x08});     // add rsp, 8
+            e.Bytes({0x41, 0x5E});                 // pop r14
+            e.Bytes({0x41, 0x5D});                 // pop r13
+            e.Bytes({0x41, 0x5C});                 // pop r12
+            e.Byte(0x5B);                          // pop rbx
+            e.Byte(0xC3);                          // ret
+            return true;
+        }
+
+        [[nodiscard]] const std::vector<uint8_t>& Code() const { return e.Data(); }
+    };
+}
+
+JIT::Result JIT::Compile(BasicBlock& block, const bool m_8bit, const bool x_8bit, const size_t min_instructions) {
+    if (block.self_modifying) return Result::Rejected;
+
+    BlockCompiler compiler(layout, block, m_8bit, x_8bit);
+    if (!compiler.Compile(min_instructions)) return Result::Rejected;
+    const std::vector<uint8_t>& bytes = compiler.Code();
+
+    if (!code) {
+        void* memory = mmap(nullptr, kCodeBufferSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) return Result::Rejected;
+        code = static_cast<uint8_t*>(memory);
+        code_used = 0;
+    }
+    if (code_used + bytes.size() > kCodeBufferSize) return Result::OutOfSpace;
+
+    // Keep the buffer W^X: only the pages being written to are writable, and only while we write them
+    uint8_t* entry = code + code_used;
+    uint8_t* const pages = code + (code_used & ~(kPageSize - 1));
+    const size_t length = entry + bytes.size() - pages;
+    if (mprotect(pages, length, PROT_READ | PROT_WRITE) != 0) return Result::Rejected;
+    std::memcpy(entry, bytes.data(), bytes.size());
+    code_used += (bytes.size() + 15) & ~size_t{15};
+    if (mprotect(pages, length, PROT_READ | PROT_EXEC) != 0) return Result::Rejected;
+
+    block.native = reinterpret_cast<NativeBlockFunction>(entry);
+    return Result::Compiled;
+}
+
+void JIT::Reset() {
+    code_used = 0;
+}
+
+#else
+
+JIT::Result JIT::Compile(BasicBlock&, bool, bool, size_t) {
+    return Result::Rejected;
+}
+
+void JIT::Reset() {}
+
+#endif
@@ -0,0 +1,75 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#ifndef JIT_H
+#define JIT_H
+#include <cstddef>
+#include <cstdint>
+
+#include "block_cache.h"
+
+#if defined(__x86_64__) && !defined(_WIN32)
+#define BREADEDSNES_JIT_X86_64 1
+#endif
+
+// x86-64 translator for hot 65816 basic blocks.
+// Loads, stores, ALU ops, compares, transfers, branches and jumps become native code that works on
+// the CPU's registers in place. A block is compiled from its first instruction up to the first one
+// the translator doesn't handle; the interpreter picks up from there. Memory goes through accessors
+// the CPU provides, which refuse anything but WRAM and ROM, and the block then exits before that
+// instruction so I/O is always reached by the interpreter at the exact cycle. Each exit adds the
+// cycles of the instructions before it in one go; direct page, page crossing and taken branch
+// penalties are added as they come up.
+class JIT {
+public:
+    // Where compiled code finds the CPU's state, and what it calls
+    struct Layout {
+        // Byte offsets of the registers in the CPU object
+        int32_t A, X, Y, D, PC, P, DB, PB, flag_n, flag_z, flag_c, flag_v, cycles;
+
+        // Reads return kBail for anything but WRAM and ROM, without reading it. Writes do the same
+        // without writing, and otherwise return kCodeWritten if they wrote over predecoded code.
+        uint32_t (*read8)(void* cpu, uint32_t address);
+        uint32_t (*read16)(void* cpu, uint32_t address);
+        uint32_t (*write8)(void* cpu, uint32_t address, uint32_t value);
+        uint32_t (*write16)(void* cpu, uint32_t address, uint32_t value);
+        // Called after every taken branch or jump, with PC and cycles up to date
+        void (*check_idle_loop)(void* cpu);
+    };
+    static constexpr uint32_t kBail = UINT32_MAX;
+    static constexpr uint32_t kCodeWritten = 1;
+    static constexpr size_t kMinInstructions = 4;
+
+    enum class Result {
+        Compiled,
+        Rejected,   // Block must stay on the interpreter
+        OutOfSpace  // Code buffer is full; Reset() and try again
+    };
+
+    explicit JIT(const Layout& cpu_layout) : layout(cpu_layout) {}
+    ~JIT();
+    JIT(const JIT&) = delete;
+    JIT& operator=(const JIT&) = delete;
+
+    static bool IsSupported();
+
+    // Compiles the block under the register sizes it was decoded for. The compiled function runs
+    // at most `limit` instructions (at least one) and returns how many it ran, with PC pointing
+    // at the next one. Blocks that start with fewer than `min_instructions` the translator handles
+    // are rejected; entering native code costs more than interpreting a couple of instructions.
+    Result Compile(BasicBlock& block, bool m_8bit, bool x_8bit, size_t min_instructions = kMinInstructions);
+
+    // Throws away every compiled block
+    void Reset();
+
+private:
+    static constexpr size_t kCodeBufferSize = 4 * 1024 * 1024;
+    static constexpr size_t kPageSize = 4096;
+
+    Layout layout;
+    uint8_t* code = nullptr;
+    size_t code_used = 0;
+};
+
+#endif //JIT_H
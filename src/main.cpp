@@ -3,17 +3,74 @@
 //
 
 #include <SDL2/SDL.h>
+#include <csignal>
 #include <iostream>
 #include <fstream>
+#include <string>
+#include <utility>
 #include "system.h"
 
-class CPU;
-class PPU;
 class APU;
 class Bus;
 
+// Set by SIGUSR1 to print the profile without quitting
+static volatile std::sig_atomic_t profile_report_requested = 0;
+
+// The keyboard plays port 1. Game controllers take ports 1 and 2 in the order they're found,
+// with the SNES face buttons where they sit on the pad rather than by label.
+constexpr std::pair<SDL_Scancode, uint16_t> kKeyMap[] = {
+    {SDL_SCANCODE_UP, Controllers::Up},     {SDL_SCANCODE_DOWN, Controllers::Down},
+    {SDL_SCANCODE_LEFT, Controllers::Left}, {SDL_SCANCODE_RIGHT, Controllers::Right},
+    {SDL_SCANCODE_Z, Controllers::B},       {SDL_SCANCODE_X, Controllers::A},
+    {SDL_SCANCODE_A, Controllers::Y},       {SDL_SCANCODE_S, Controllers::X},
+    {SDL_SCANCODE_Q, Controllers::L},       {SDL_SCANCODE_W, Controllers::R},
+    {SDL_SCANCODE_RETURN, Controllers::Start}, {SDL_SCANCODE_RSHIFT, Controllers::Select},
+};
+
+constexpr std::pair<SDL_GameControllerButton, uint16_t> kPadMap[] = {
+    {SDL_CONTROLLER_BUTTON_DPAD_UP, Controllers::Up},     {SDL_CONTROLLER_BUTTON_DPAD_DOWN, Controllers::Down},
+    {SDL_CONTROLLER_BUTTON_DPAD_LEFT, Controllers::Left}, {SDL_CONTROLLER_BUTTON_DPAD_RIGHT, Controllers::Right},
+    {SDL_CONTROLLER_BUTTON_A, Controllers::B},            {SDL_CONTROLLER_BUTTON_B, Controllers::A},
+    {SDL_CONTROLLER_BUTTON_X, Controllers::Y},            {SDL_CONTROLLER_BUTTON_Y, Controllers::X},
+    {SDL_CONTROLLER_BUTTON_LEFTSHOULDER, Controllers::L}, {SDL_CONTROLLER_BUTTON_RIGHTSHOULDER, Controllers::R},
+    {SDL_CONTROLLER_BUTTON_START, Controllers::Start},    {SDL_CONTROLLER_BUTTON_BACK, Controllers::Select},
+};
+
+using Pads = SDL_GameController*[Controllers::kPorts];
+
+static void OpenPads(Pads& pads) {
+    for (SDL_GameController*& pad : pads) {
+        if (pad) SDL_GameControllerClose(pad);
+        pad = nullptr;
+    }
+    uint32_t port = 0;
+    for (int i = 0; i < SDL_NumJoysticks() && port < Controllers::kPorts; i++) {
+        if (SDL_IsGameController(i)) pads[port++] = SDL_GameControllerOpen(i);
+    }
+}
+
+// Runs when the game latches its pads, so the state is only as old as this call
+static void PollInput(System& snes, const Pads& pads) {
+    SDL_PumpEvents();
+    const Uint8* keys = SDL_GetKeyboardState(nullptr);
+    for (uint32_t port = 0; port < Controllers::kPorts; port++) {
+        uint16_t buttons = 0;
+        if (port == 0) {
+            for (const auto& [key, button] : kKeyMap) {
+                if (keys[key]) buttons |= button;
+            }
+        }
+        if (pads[port]) {
+            for (const auto& [pad_button, button] : kPadMap) {
+                if (SDL_GameControllerGetButton(pads[port], pad_button)) buttons |= button;
+            }
+        }
+        snes.SetButtons(port, buttons);
+    }
+}
+
 int main(const int argc, char* argv[]) {
-    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
+    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO | SDL_INIT_GAMECONTROLLER) < 0) {
         std::cout << "SDL could not initialize! SDL_Error: " << SDL_GetError() << std::endl;
         return -1;
     }
@@ -22,8 +79,8 @@ int main(const int argc, char* argv[]) {
         "BreadedSNES",
         SDL_WINDOWPOS_UNDEFINED,
         SDL_WINDOWPOS_UNDEFINED,
-        256, 224,  // SNES output res
-        SDL_WINDOW_SHOWN
+        512, 448,  // SNES output res, doubled so hi-res and interlaced frames keep their detail
+        SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE
     );
 
     if (!window) {
@@ -32,7 +89,7 @@ int main(const int argc, char* argv[]) {
         return -1;
     }
 
-    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
     if (!renderer) {
         std::cout << "Renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
         SDL_DestroyWindow(window);
@@ -40,10 +97,58 @@ int main(const int argc, char* argv[]) {
         return -1;
     }
 
+    // Every frame size is stretched over the same 8:7 picture
+    SDL_RenderSetLogicalSize(renderer, 256, 224);
+
+    // Recreated only when the frame size changes, so low-res games keep a 256x224 texture
+    uint32_t screen_width = PPU::kScreenWidth;
+    uint32_t screen_height = 224;
+    SDL_Texture* screen = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+                                            static_cast<int>(screen_width), static_cast<int>(screen_height));
+    if (!screen) {
+        std::cout << "Texture could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+        return -1;
+    }
+
     System snes;
 
-    if (argc > 1) {
-        if (!snes.LoadROM(argv[1])) {
+    // Usage: breadedSNES [--cpu=interpreter|cached|jit] [--verify-jit] [--render-threads=n] [--frame-skip=n]
+    //                    [--record=movie | --play=movie] [--trace=file] [--profile] [rom]
+    const char* rom_path = nullptr;
+    std::string record_path, play_path;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--cpu=interpreter") {
+            snes.SetCPUBackend(CPUBackend::Interpreter);
+        } else if (arg == "--cpu=cached") {
+            snes.SetCPUBackend(CPUBackend::BlockCache);
+        } else if (arg == "--cpu=jit") {
+            snes.SetCPUBackend(CPUBackend::JIT);
+        } else if (arg == "--verify-jit") {
+            snes.SetJITVerification(true);
+        } else if (arg.starts_with("--render-threads=")) {
+            snes.SetRenderThreads(static_cast<uint32_t>(std::stoul(arg.substr(17))));
+        } else if (arg.starts_with("--frame-skip=")) {
+            snes.SetFrameSkip(static_cast<uint32_t>(std::stoul(arg.substr(13))));
+        } else if (arg.starts_with("--record=")) {
+            record_path = arg.substr(9);
+        } else if (arg.starts_with("--play=")) {
+            play_path = arg.substr(7);
+        } else if (arg.starts_with("--trace=")) {
+            snes.StartTrace(arg.substr(8));
+        } else if (arg == "--profile") {
+            snes.StartProfile();
+        } else {
+            rom_path = argv[i];
+        }
+    }
+
+    if (rom_path) {
+        if (!snes.LoadROM(rom_path)) {
+            SDL_DestroyTexture(screen);
             SDL_DestroyRenderer(renderer);
             SDL_DestroyWindow(window);
             SDL_Quit();
@@ -51,7 +156,25 @@ int main(const int argc, char* argv[]) {
         }
     }
 
-    snes.Reset();
+    // Movies start from power-on; playback hands the pads back once the movie ends
+    Movie movie;
+    bool recording = false;
+    if (!play_path.empty() && movie.Load(play_path) && snes.StartPlayback(std::move(movie))) {
+        std::cout << "Playing movie: " << play_path << std::endl;
+    } else if (!record_path.empty()) {
+        snes.StartRecording(Movie::Anchor::PowerOn);
+        recording = true;
+    } else {
+        snes.Reset();
+    }
+    bool playing = snes.IsPlayingMovie();
+    Pads pads = {};
+    OpenPads(pads);
+    snes.SetInputPoll([&snes, &pads] { PollInput(snes, pads); });
+
+#ifdef SIGUSR1
+    std::signal(SIGUSR1, [](int) { profile_report_requested = 1; });
+#endif
 
     bool quit = false;
     SDL_Event e;
@@ -60,21 +183,54 @@ int main(const int argc, char* argv[]) {
         while (SDL_PollEvent(&e)) {
             if (e.type == SDL_QUIT) {
                 quit = true;
+            } else if (e.type == SDL_CONTROLLERDEVICEADDED || e.type == SDL_CONTROLLERDEVICEREMOVED) {
+                OpenPads(pads);
             }
         }
 
-        // Run emulation step
-        snes.Step();
+        snes.RunFrame();
 
-        // Clear screen
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderClear(renderer);
+        if (playing && !snes.IsPlayingMovie()) {
+            playing = false;
+            if (const auto mismatch = snes.GetMovieMismatch()) {
+                std::cout << "Movie finished, the picture first differed on frame " << *mismatch << std::endl;
+            } else {
+                std::cout << "Movie finished, every frame matched" << std::endl;
+            }
+        }
 
-        // TODO: Render frame
+        if (profile_report_requested) {
+            profile_report_requested = 0;
+            snes.ReportProfile();
+        }
+
+        // Skipped frames aren't presented either, so they run without waiting for vsync
+        if (!snes.IsFrameDrawn()) continue;
+
+        if (snes.GetFrameWidth() != screen_width || snes.GetFrameHeight() != screen_height) {
+            screen_width = snes.GetFrameWidth();
+            screen_height = snes.GetFrameHeight();
+            SDL_DestroyTexture(screen);
+            screen = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+                                       static_cast<int>(screen_width), static_cast<int>(screen_height));
+            if (!screen) {
+                std::cout << "Texture could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+                break;
+            }
+        }
 
+        SDL_UpdateTexture(screen, nullptr, snes.GetFramebuffer(), static_cast<int>(screen_width * sizeof(uint32_t)));
+        SDL_RenderClear(renderer);
+        SDL_RenderCopy(renderer, screen, nullptr, nullptr);
         SDL_RenderPresent(renderer);
     }
 
+    if (recording) snes.StopMovie().Save(record_path);
+
+    for (SDL_GameController* pad : pads) {
+        if (pad) SDL_GameControllerClose(pad);
+    }
+    if (screen) SDL_DestroyTexture(screen);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
@@ -0,0 +1,58 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#include "memory_arena.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define BREADEDSNES_ARENA_MMAP 1
+#endif
+
+MemoryArena::MemoryArena(const size_t size) {
+    capacity = (size + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+
+#ifdef BREADEDSNES_ARENA_MMAP
+#ifdef MAP_HUGETLB
+    void* huge = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (huge != MAP_FAILED) {
+        base = static_cast<uint8_t*>(huge);
+        mapped = capacity;
+        pages = Pages::Huge;
+        return;
+    }
+#endif
+
+    // Transparent huge pages only back aligned 2MB ranges, so over-allocate and trim to one
+    const size_t reserved = capacity + kHugePageSize;
+    void* memory = mmap(nullptr, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory != MAP_FAILED) {
+        const auto start = reinterpret_cast<uintptr_t>(memory);
+        const uintptr_t aligned = (start + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+        if (aligned > start) munmap(memory, aligned - start);
+        const uintptr_t end = start + reserved;
+        if (end > aligned + capacity) munmap(reinterpret_cast<void*>(aligned + capacity), end - aligned - capacity);
+
+        base = reinterpret_cast<uint8_t*>(aligned);
+        mapped = capacity;
+#ifdef MADV_HUGEPAGE
+        if (madvise(base, capacity, MADV_HUGEPAGE) == 0) pages = Pages::Transparent;
+#endif
+        return;
+    }
+#endif
+
+    // No mmap, or it failed: a plain allocation, without the whole-page rounding
+    capacity = size;
+    base = static_cast<uint8_t*>(::operator new(capacity, std::align_val_t{kAlignment}));
+}
+
+MemoryArena::~MemoryArena() {
+#ifdef BREADEDSNES_ARENA_MMAP
+    if (mapped) {
+        munmap(base, mapped);
+        return;
+    }
+#endif
+    ::operator delete(base, std::align_val_t{kAlignment});
+}
@@ -0,0 +1,83 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#ifndef MEMORY_ARENA_H
+#define MEMORY_ARENA_H
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// One allocation holding the bulk memory (RAM, VRAM, framebuffer...) of every component in a
+// System, while their registers stay together in the System itself. A System's arena fits in a
+// single 2MB huge page, so hosts running hundreds of them spend one TLB entry per instance on it.
+// Where the OS allows, the arena is backed by huge pages: explicit ones if any are reserved,
+// otherwise transparent ones. Anywhere else it's a plain aligned allocation.
+class MemoryArena {
+public:
+    static constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+    static constexpr size_t kAlignment = 64;    // Blocks start on their own cache line
+
+    enum class Pages { Normal, Transparent, Huge };
+
+private:
+    uint8_t* base = nullptr;
+    size_t capacity = 0;
+    size_t used = 0;
+    size_t mapped = 0;          // Bytes to unmap, 0 if base came from operator new
+    Pages pages = Pages::Normal;
+
+public:
+    explicit MemoryArena(size_t size);
+    ~MemoryArena();
+
+    MemoryArena(const MemoryArena&) = delete;
+    MemoryArena& operator=(const MemoryArena&) = delete;
+
+    static constexpr size_t BlockSize(const size_t size) { return (size + kAlignment - 1) / kAlignment * kAlignment; }
+    // Bytes a set of blocks needs, alignment included
+    template <typename... T>
+    static constexpr size_t SizeFor() {
+        return (BlockSize(sizeof(T)) + ... + 0);
+    }
+
+    // Value-initializes the next block. Blocks are never destroyed one by one, so only trivially
+    // destructible types go in.
+    template <typename T>
+    T* Create() {
+        static_assert(std::is_trivially_destructible_v<T> && alignof(T) <= kAlignment);
+        const size_t size = BlockSize(sizeof(T));
+        if (size > capacity - used) throw std::bad_alloc();
+        T* block = new (base + used) T();
+        used += size;
+        return block;
+    }
+
+    [[nodiscard]] size_t GetSize() const { return capacity; }
+    [[nodiscard]] Pages GetPages() const { return pages; }
+};
+
+// A component's bulk memory: a block of its System's arena, or storage of its own when the
+// component is built on its own (benchmarks, the JIT's verification bus). Copies are deep, so
+// copying a component copies its memory rather than sharing it.
+template <typename T>
+class BulkMemory {
+    std::unique_ptr<T> owned;
+    T* memory;
+
+public:
+    explicit BulkMemory(T* block = nullptr)
+        : owned(block ? nullptr : std::make_unique<T>()), memory(block ? block : owned.get()) {}
+    BulkMemory(const BulkMemory& other) : owned(std::make_unique<T>(*other.memory)), memory(owned.get()) {}
+    BulkMemory& operator=(const BulkMemory& other) {
+        if (this != &other) *memory = *other.memory;
+        return *this;
+    }
+
+    T* operator->() const { return memory; }
+    T& operator*() const { return *memory; }
+};
+
+#endif //MEMORY_ARENA_H
@@ -0,0 +1,128 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#include "movie.h"
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#include "save_state.h"
+
+namespace {
+
+// File layout, in host byte order like save states (see save_state.h):
+//   magic, version, anchor (u8), ports (u8), has hashes (u8), reserved (u8), frames (u32)
+//   state size (u32), state
+//   run count (u32), then per run: length (u32), input per port (u16)
+//   frames x hash (u64), if present
+constexpr uint32_t kMagic = 0x564D5342;    // "BSMV"
+constexpr uint32_t kVersion = 1;
+
+} // namespace
+
+void Movie::Serialize(std::vector<uint8_t>& out) const {
+    out.clear();
+    StateWriter writer(out);
+    writer.Write(kMagic);
+    writer.Write(kVersion);
+    writer.Write(anchor);
+    writer.Write(static_cast<uint8_t>(Controllers::kPorts));
+    writer.Write(static_cast<uint8_t>(!frame_hashes.empty()));
+    writer.Write(static_cast<uint8_t>(0));
+    writer.Write(static_cast<uint32_t>(frames.size()));
+
+    writer.Write(static_cast<uint32_t>(state.size()));
+    writer.WriteBytes(state.data(), state.size());
+
+    std::vector<std::pair<uint32_t, Controllers::FrameInput>> runs;
+    for (const Controllers::FrameInput& input : frames) {
+        if (!runs.empty() && runs.back().second == input) {
+            runs.back().first++;
+        } else {
+            runs.emplace_back(1, input);
+        }
+    }
+    writer.Write(static_cast<uint32_t>(runs.size()));
+    for (const auto& [length, input] : runs) {
+        writer.Write(length);
+        writer.Write(input);
+    }
+
+    if (!frame_hashes.empty()) {
+        for (size_t frame = 0; frame < frames.size(); frame++) {
+            writer.Write(frame < frame_hashes.size() ? frame_hashes[frame] : uint64_t{0});
+        }
+    }
+}
+
+bool Movie::Deserialize(const uint8_t* data, const size_t size) {
+    StateReader reader(data, size);
+    uint32_t magic = 0, version = 0, frame_count = 0, state_size = 0, run_count = 0;
+    uint8_t ports = 0, has_hashes = 0, reserved = 0;
+    Anchor read_anchor = Anchor::PowerOn;
+    reader.Read(magic);
+    reader.Read(version);
+    reader.Read(read_anchor);
+    reader.Read(ports);
+    reader.Read(has_hashes);
+    reader.Read(reserved);
+    reader.Read(frame_count);
+    if (reader.Failed() || magic != kMagic || version != kVersion || ports != Controllers::kPorts ||
+        read_anchor > Anchor::SaveState) {
+        return false;
+    }
+
+    reader.Read(state_size);
+    if (reader.Failed() || state_size > size) return false;
+    std::vector<uint8_t> read_state(state_size);
+    reader.ReadBytes(read_state.data(), state_size);
+
+    std::vector<Controllers::FrameInput> read_frames;
+    reader.Read(run_count);
+    for (uint32_t run = 0; run < run_count && !reader.Failed(); run++) {
+        uint32_t length = 0;
+        Controllers::FrameInput input{};
+        reader.Read(length);
+        reader.Read(input);
+        if (length > frame_count - read_frames.size()) return false;
+        read_frames.insert(read_frames.end(), length, input);
+    }
+    if (reader.Failed() || read_frames.size() != frame_count) return false;
+
+    std::vector<uint64_t> read_hashes(has_hashes ? frame_count : 0);
+    for (uint64_t& hash : read_hashes) reader.Read(hash);
+    if (reader.Failed() || !reader.AtEnd()) return false;
+
+    anchor = read_anchor;
+    state = std::move(read_state);
+    frames = std::move(read_frames);
+    frame_hashes = std::move(read_hashes);
+    return true;
+}
+
+bool Movie::Save(const std::string& path) const {
+    std::vector<uint8_t> data;
+    Serialize(data);
+    std::ofstream file(path, std::ios::binary);
+    if (!file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()))) {
+        std::cout << "Failed to write movie: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Movie::Load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cout << "Failed to open movie: " << path << std::endl;
+        return false;
+    }
+    const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (!Deserialize(data.data(), data.size())) {
+        std::cout << "Not a valid movie: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,39 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#ifndef MOVIE_H
+#define MOVIE_H
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "controllers.h"
+
+// An input movie: the pad state of every frame from a fixed starting point. Given the same ROM,
+// playing it back reproduces the run exactly, whatever the speed, CPU backend or frame skip.
+//
+// Frames run from one line 0 to the next, so each one ends with the picture it drew. Files store
+// the input as runs of identical frames, which keeps hour-long movies to a few kilobytes.
+class Movie {
+public:
+    enum class Anchor : uint8_t {
+        PowerOn,    // Cold start: RAM and SRAM cleared, then reset
+        SaveState,  // The embedded state, see System::SaveState
+    };
+
+    Anchor anchor = Anchor::PowerOn;
+    std::vector<uint8_t> state;
+    std::vector<Controllers::FrameInput> frames;
+    // Framebuffer hash at the end of each frame, 0 where it wasn't drawn. Playback compares
+    // against these when present.
+    std::vector<uint64_t> frame_hashes;
+
+    bool Save(const std::string& path) const;
+    bool Load(const std::string& path);
+
+    void Serialize(std::vector<uint8_t>& out) const;
+    bool Deserialize(const uint8_t* data, size_t size);
+};
+
+#endif //MOVIE_H
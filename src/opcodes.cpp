@@ -0,0 +1,330 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#include "opcodes.h"
+
+const std::array<OpcodeInfo, 256> kOpcodeTable = {{
+    {"BRK", AddressingMode::Immediate8, true, {9, 9, 2, CycleWidth::None}},             // 0x00
+    {"ORA", AddressingMode::DirectPageIndirectX, false, {10, 12, 1, CycleWidth::M}},    // 0x01
+    {"COP", AddressingMode::Immediate8, true, {0, 0, 0, CycleWidth::None}},             // 0x02
+    {"ORA", AddressingMode::StackRelative, false, {6, 8, 0, CycleWidth::M}},            // 0x03
+    {"TSB", AddressingMode::DirectPage, false, {7, 9, 1, CycleWidth::M}},               // 0x04
+    {"ORA", AddressingMode::DirectPage, false, {5, 7, 1, CycleWidth::M}},               // 0x05
+    {"ASL", AddressingMode::DirectPage, false, {7, 10, 1, CycleWidth::M}},              // 0x06
+    {"ORA", AddressingMode::DirectPageIndirectLong, false, {11, 13, 1, CycleWidth::M}}, // 0x07
+    {"PHP", AddressingMode::Implied, false, {4, 4, 0, CycleWidth::None}},               // 0x08
+    {"ORA", AddressingMode::ImmediateM, false, {3, 5, 0, CycleWidth::M}},               // 0x09
+    {"ASL", AddressingMode::Accumulator, false, {2, 2, 0, CycleWidth::None}},           // 0x0A
+    {"PHD", AddressingMode::Implied, false, {6, 6, 0, CycleWidth::None}},               // 0x0B
+    {"TSB", AddressingMode::Absolute, false, {9, 11, 0, CycleWidth::M}},                // 0x0C
+    {"ORA", AddressingMode::Absolute, false, {7, 9, 0, CycleWidth::M}},                 // 0x0D
+    {"ASL", AddressingMode::Absolute, false, {9, 12, 0, CycleWidth::M}},                // 0x0E
+    {"ORA", AddressingMode::AbsoluteLong, false, {9, 11, 0, CycleWidth::M}},            // 0x0F
+    {"BPL", AddressingMode::Relative, true, {1, 1, 2, CycleWidth::None}},               // 0x10
+    {"ORA", AddressingMode::DirectPageIndirectY, false, {9, 11, 2, CycleWidth::M}},     // 0x11
+    {"ORA", AddressingMode::DirectPageIndirect, false, {9, 11, 1, CycleWidth::M}},      // 0x12
+    {"ORA", AddressingMode::StackRelativeIndirectY, false, {11, 13, 0, CycleWidth::M}}, // 0x13
+    {"TRB", AddressingMode::DirectPage, false, {7, 9, 1, CycleWidth::M}},               // 0x14
+    {"ORA", AddressingMode::DirectPageX, false, {6, 8, 1, CycleWidth::M}},              // 0x15
+    {"ASL", AddressingMode::DirectPageX, false, {8, 11, 1, CycleWidth::M}},             // 0x16
+    {"ORA", AddressingMode::DirectPageIndirectLongY, false, {11, 13, 1, CycleWidth::M}},// 0x17
+    {"CLC", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0x18
+    {"ORA", AddressingMode::AbsoluteY, false, {7, 9, 1, CycleWidth::M}},                // 0x19
+    {"INC", AddressingMode::Accumulator, false, {2, 2, 0, CycleWidth::None}},           // 0x1A
+    {"TCS", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0x1B
+    {"TRB", AddressingMode::Absolute, false, {9, 11, 0, CycleWidth::M}},                // 0x1C
+    {"ORA", AddressingMode::AbsoluteX, false, {7, 9, 1, CycleWidth::M}},                // 0x1D
+    {"ASL", AddressingMode::AbsoluteX, false, {10, 13, 0, CycleWidth::M}},              // 0x1E
+    {"ORA", AddressingMode::AbsoluteLongX, false, {9, 11, 0, CycleWidth::M}},           // 0x1F
+    {"JSR", AddressingMode::Absolute, true, {10, 10, 0, CycleWidth::None}},             // 0x20
+    {"AND", AddressingMode::DirectPageIndirectX, false, {10, 12, 1, CycleWidth::M}},    // 0x21
+    {"JSL", AddressingMode::AbsoluteLong, true, {14, 14, 0, CycleWidth::None}},         // 0x22
+    {"AND", AddressingMode::StackRelative, false, {6, 8, 0, CycleWidth::M}},            // 0x23
+    {"BIT", AddressingMode::DirectPage, false, {5, 7, 1, CycleWidth::M}},               // 0x24
+    {"AND", AddressingMode::DirectPage, false, {5, 7, 1, CycleWidth::M}},               // 0x25
+    {"ROL", AddressingMode::DirectPage, false, {7, 9, 1, CycleWidth::M}},               // 0x26
+    {"AND", AddressingMode::DirectPageIndirectLong, false, {11, 13, 1, CycleWidth::M}}, // 0x27
+    {"PLP", AddressingMode::Implied, true, {6, 6, 0, CycleWidth::None}},                // 0x28
+    {"AND", AddressingMode::ImmediateM, false, {3, 5, 0, CycleWidth::M}},               // 0x29
+    {"ROL", AddressingMode::Accumulator, false, {2, 2, 0, CycleWidth::None}},           // 0x2A
+    {"PLD", AddressingMode::Implied, false, {9, 9, 0, CycleWidth::None}},               // 0x2B
+    {"BIT", AddressingMode::Absolute, false, {7, 9, 0, CycleWidth::M}},                 // 0x2C
+    {"AND", AddressingMode::Absolute, false, {7, 9, 0, CycleWidth::M}},                 // 0x2D
+    {"ROL", AddressingMode::Absolute, false, {9, 11, 0, CycleWidth::M}},                // 0x2E
+    {"AND", AddressingMode::AbsoluteLong, false, {9, 11, 0, CycleWidth::M}},            // 0x2F
+    {"BMI", AddressingMode::Relative, true, {1, 1, 2, CycleWidth::None}},               // 0x30
+    {"AND", AddressingMode::DirectPageIndirectY, false, {9, 11, 2, CycleWidth::M}},     // 0x31
+    {"AND", AddressingMode::DirectPageIndirect, false, {9, 11, 1, CycleWidth::M}},      // 0x32
+    {"AND", AddressingMode::StackRelativeIndirectY, false, {11, 13, 0, CycleWidth::M}}, // 0x33
+    {"BIT", AddressingMode::DirectPageX, false, {6, 8, 1, CycleWidth::M}},              // 0x34
+    {"AND", AddressingMode::DirectPageX, false, {6, 8, 1, CycleWidth::M}},              // 0x35
+    {"ROL", AddressingMode::DirectPageX, false, {8, 10, 1, CycleWidth::M}},             // 0x36
+    {"AND", AddressingMode::DirectPageIndirectLongY, false, {11, 13, 1, CycleWidth::M}},// 0x37
+    {"SEC", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0x38
+    {"AND", AddressingMode::AbsoluteY, false, {7, 9, 1, CycleWidth::M}},                // 0x39
+    {"DEC", AddressingMode::Accumulator, false, {2, 2, 0, CycleWidth::None}},           // 0x3A
+    {"TSC", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0x3B
+    {"BIT", AddressingMode::AbsoluteX, false, {7, 9, 1, CycleWidth::M}},                // 0x3C
+    {"AND", AddressingMode::AbsoluteX, false, {7, 9, 1, CycleWidth::M}},                // 0x3D
+    {"ROL", AddressingMode::AbsoluteX, false, {10, 12, 0, CycleWidth::M}},              // 0x3E
+    {"AND", AddressingMode::AbsoluteLongX, false, {9, 11, 0, CycleWidth::M}},           // 0x3F
+    {"RTI", AddressingMode::Implied, true, {13, 13, 1, CycleWidth::None}},              // 0x40
+    {"EOR", AddressingMode::DirectPageIndirectX, false, {10, 12, 1, CycleWidth::M}},    // 0x41
+    {"WDM", AddressingMode::Immediate8, false, {2, 2, 0, CycleWidth::None}},            // 0x42
+    {"EOR", AddressingMode::StackRelative, false, {6, 8, 0, CycleWidth::M}},            // 0x43
+    {"MVP", AddressingMode::BlockMove, true, {7, 7, 0, CycleWidth::None}},              // 0x44
+    {"EOR", AddressingMode::DirectPage, false, {5, 7, 1, CycleWidth::M}},               // 0x45
+    {"LSR", AddressingMode::DirectPage, false, {7, 10, 1, CycleWidth::M}},              // 0x46
+    {"EOR", AddressingMode::DirectPageIndirectLong, false, {11, 13, 1, CycleWidth::M}}, // 0x47
+    {"PHA", AddressingMode::Implied, false, {4, 6, 0, CycleWidth::M}},                  // 0x48
+    {"EOR", AddressingMode::ImmediateM, false, {3, 5, 0, CycleWidth::M}},               // 0x49
+    {"LSR", AddressingMode::Accumulator, false, {2, 2, 0, CycleWidth::None}},           // 0x4A
+    {"PHK", AddressingMode::Implied, false, {4, 4, 0, CycleWidth::None}},               // 0x4B
+    {"JMP", AddressingMode::Absolute, true, {5, 5, 0, CycleWidth::None}},               // 0x4C
+    {"EOR", AddressingMode::Absolute, false, {7, 9, 0, CycleWidth::M}},                 // 0x4D
+    {"LSR", AddressingMode::Absolute, false, {9, 12, 0, CycleWidth::M}},                // 0x4E
+    {"EOR", AddressingMode::AbsoluteLong, false, {9, 11, 0, CycleWidth::M}},            // 0x4F
+    {"BVC", AddressingMode::Relative, true, {3, 3, 2, CycleWidth::None}},               // 0x50
+    {"EOR", AddressingMode::DirectPageIndirectY, false, {9, 11, 2, CycleWidth::M}},     // 0x51
+    {"EOR", AddressingMode::DirectPageIndirect, false, {9, 11, 1, CycleWidth::M}},      // 0x52
+    {"EOR", AddressingMode::StackRelativeIndirectY, false, {11, 13, 0, CycleWidth::M}}, // 0x53
+    {"MVN", AddressingMode::BlockMove, true, {7, 7, 0, CycleWidth::None}},              // 0x54
+    {"EOR", AddressingMode::DirectPageX, false, {6, 8, 1, CycleWidth::M}},              // 0x55
+    {"LSR", AddressingMode::DirectPageX, false, {8, 11, 1, CycleWidth::M}},             // 0x56
+    {"EOR", AddressingMode::DirectPageIndirectLongY, false, {11, 13, 1, CycleWidth::M}},// 0x57
+    {"CLI", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0x58
+    {"EOR", AddressingMode::AbsoluteY, false, {7, 9, 1, CycleWidth::M}},                // 0x59
+    {"PHY", AddressingMode::Implied, false, {4, 6, 0, CycleWidth::X}},                  // 0x5A
+    {"TCD", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0x5B
+    {"JML", AddressingMode::AbsoluteLong, true, {7, 7, 0, CycleWidth::None}},           // 0x5C
+    {"EOR", AddressingMode::AbsoluteX, false, {7, 9, 1, CycleWidth::M}},                // 0x5D
+    {"LSR", AddressingMode::AbsoluteX, false, {10, 13, 0, CycleWidth::M}},              // 0x5E
+    {"EOR", AddressingMode::AbsoluteLongX, false, {9, 11, 0, CycleWidth::M}},           // 0x5F
+    {"RTS", AddressingMode::Implied, true, {10, 10, 0, CycleWidth::None}},              // 0x60
+    {"ADC", AddressingMode::DirectPageIndirectX, false, {10, 12, 1, CycleWidth::M}},    // 0x61
+    {"PER", AddressingMode::RelativeLong, false, {10, 10, 0, CycleWidth::None}},        // 0x62
+    {"ADC", AddressingMode::StackRelative, false, {6, 8, 0, CycleWidth::M}},            // 0x63
+    {"STZ", AddressingMode::DirectPage, false, {4, 5, 1, CycleWidth::M}},               // 0x64
+    {"ADC", AddressingMode::DirectPage, false, {5, 7, 1, CycleWidth::M}},               // 0x65
+    {"ROR", AddressingMode::DirectPage, false, {7, 9, 1, CycleWidth::M}},               // 0x66
+    {"ADC", AddressingMode::DirectPageIndirectLong, false, {11, 13, 1, CycleWidth::M}}, // 0x67
+    {"PLA", AddressingMode::Implied, false, {6, 9, 0, CycleWidth::M}},                  // 0x68
+    {"ADC", AddressingMode::ImmediateM, false, {3, 5, 0, CycleWidth::M}},               // 0x69
+    {"ROR", AddressingMode::Accumulator, false, {2, 2, 0, CycleWidth::None}},           // 0x6A
+    {"RTL", AddressingMode::Implied, true, {12, 12, 0, CycleWidth::None}},              // 0x6B
+    {"JMP", AddressingMode::AbsoluteIndirect, true, {9, 9, 0, CycleWidth::None}},       // 0x6C
+    {"ADC", AddressingMode::Absolute, false, {7, 9, 0, CycleWidth::M}},                 // 0x6D
+    {"ROR", AddressingMode::Absolute, false, {9, 11, 0, CycleWidth::M}},                // 0x6E
+    {"ADC", AddressingMode::AbsoluteLong, false, {9, 11, 0, CycleWidth::M}},            // 0x6F
+    {"BVS", AddressingMode::Relative, true, {3, 3, 2, CycleWidth::None}},               // 0x70
+    {"ADC", AddressingMode::DirectPageIndirectY, false, {9, 11, 2, CycleWidth::M}},     // 0x71
+    {"ADC", AddressingMode::DirectPageIndirect, false, {9, 11, 1, CycleWidth::M}},      // 0x72
+    {"ADC", AddressingMode::StackRelativeIndirectY, false, {11, 13, 0, CycleWidth::M}}, // 0x73
+    {"STZ", AddressingMode::DirectPageX, false, {5, 6, 1, CycleWidth::M}},              // 0x74
+    {"ADC", AddressingMode::DirectPageX, false, {6, 8, 1, CycleWidth::M}},              // 0x75
+    {"ROR", AddressingMode::DirectPageX, false, {8, 10, 1, CycleWidth::M}},             // 0x76
+    {"ADC", AddressingMode::DirectPageIndirectLongY, false, {11, 13, 1, CycleWidth::M}},// 0x77
+    {"SEI", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0x78
+    {"ADC", AddressingMode::AbsoluteY, false, {7, 9, 1, CycleWidth::M}},                // 0x79
+    {"PLY", AddressingMode::Implied, false, {6, 9, 0, CycleWidth::X}},                  // 0x7A
+    {"TDC", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0x7B
+    {"JMP", AddressingMode::AbsoluteIndirectX, true, {10, 10, 0, CycleWidth::None}},    // 0x7C
+    {"ADC", AddressingMode::AbsoluteX, false, {7, 9, 1, CycleWidth::M}},                // 0x7D
+    {"ROR", AddressingMode::AbsoluteX, false, {10, 12, 0, CycleWidth::M}},              // 0x7E
+    {"ADC", AddressingMode::AbsoluteLongX, false, {9, 11, 0, CycleWidth::M}},           // 0x7F
+    {"BRA", AddressingMode::Relative, true, {4, 4, 1, CycleWidth::None}},               // 0x80
+    {"STA", AddressingMode::DirectPageIndirectX, false, {10, 11, 1, CycleWidth::M}},    // 0x81
+    {"BRL", AddressingMode::RelativeLong, true, {6, 6, 0, CycleWidth::None}},           // 0x82
+    {"STA", AddressingMode::StackRelative, false, {5, 6, 0, CycleWidth::M}},            // 0x83
+    {"STY", AddressingMode::DirectPage, false, {4, 5, 1, CycleWidth::X}},               // 0x84
+    {"STA", AddressingMode::DirectPage, false, {4, 5, 1, CycleWidth::M}},               // 0x85
+    {"STX", AddressingMode::DirectPage, false, {4, 5, 1, CycleWidth::X}},               // 0x86
+    {"STA", AddressingMode::DirectPageIndirectLong, false, {10, 11, 1, CycleWidth::M}}, // 0x87
+    {"DEY", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0x88
+    {"BIT", AddressingMode::ImmediateM, false, {3, 5, 0, CycleWidth::M}},               // 0x89
+    {"TXA", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0x8A
+    {"PHB", AddressingMode::Implied, false, {4, 4, 0, CycleWidth::None}},               // 0x8B
+    {"STY", AddressingMode::Absolute, false, {6, 7, 0, CycleWidth::X}},                 // 0x8C
+    {"STA", AddressingMode::Absolute, false, {6, 7, 0, CycleWidth::M}},                 // 0x8D
+    {"STX", AddressingMode::Absolute, false, {6, 7, 0, CycleWidth::X}},                 // 0x8E
+    {"STA", AddressingMode::AbsoluteLong, false, {8, 9, 0, CycleWidth::M}},             // 0x8F
+    {"BCC", AddressingMode::Relative, true, {1, 1, 2, CycleWidth::None}},               // 0x90
+    {"STA", AddressingMode::DirectPageIndirectY, false, {9, 10, 1, CycleWidth::M}},     // 0x91
+    {"STA", AddressingMode::DirectPageIndirect, false, {8, 9, 1, CycleWidth::M}},       // 0x92
+    {"STA", AddressingMode::StackRelativeIndirectY, false, {10, 11, 0, CycleWidth::M}}, // 0x93
+    {"STY", AddressingMode::DirectPageX, false, {5, 6, 1, CycleWidth::X}},              // 0x94
+    {"STA", AddressingMode::DirectPageX, false, {5, 6, 1, CycleWidth::M}},              // 0x95
+    {"STX", AddressingMode::DirectPageY, false, {5, 6, 1, CycleWidth::X}},              // 0x96
+    {"STA", AddressingMode::DirectPageIndirectLongY, false, {10, 11, 1, CycleWidth::M}},// 0x97
+    {"TYA", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0x98
+    {"STA", AddressingMode::AbsoluteY, false, {7, 8, 0, CycleWidth::M}},                // 0x99
+    {"TXS", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0x9A
+    {"TXY", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0x9B
+    {"STZ", AddressingMode::Absolute, false, {6, 7, 0, CycleWidth::M}},                 // 0x9C
+    {"STA", AddressingMode::AbsoluteX, false, {7, 8, 0, CycleWidth::M}},                // 0x9D
+    {"STZ", AddressingMode::AbsoluteX, false, {7, 8, 0, CycleWidth::M}},                // 0x9E
+    {"STA", AddressingMode::AbsoluteLongX, false, {9, 10, 0, CycleWidth::M}},           // 0x9F
+    {"LDY", AddressingMode::ImmediateX, false, {3, 5, 0, CycleWidth::X}},               // 0xA0
+    {"LDA", AddressingMode::DirectPageIndirectX, false, {10, 12, 1, CycleWidth::M}},    // 0xA1
+    {"LDX", AddressingMode::ImmediateX, false, {3, 5, 0, CycleWidth::X}},               // 0xA2
+    {"LDA", AddressingMode::StackRelative, false, {6, 8, 0, CycleWidth::M}},            // 0xA3
+    {"LDY", AddressingMode::DirectPage, false, {5, 7, 1, CycleWidth::X}},               // 0xA4
+    {"LDA", AddressingMode::DirectPage, false, {5, 7, 1, CycleWidth::M}},               // 0xA5
+    {"LDX", AddressingMode::DirectPage, false, {5, 7, 1, CycleWidth::X}},               // 0xA6
+    {"LDA", AddressingMode::DirectPageIndirectLong, false, {11, 13, 1, CycleWidth::M}}, // 0xA7
+    {"TAY", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0xA8
+    {"LDA", AddressingMode::ImmediateM, false, {3, 5, 0, CycleWidth::M}},               // 0xA9
+    {"TAX", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0xAA
+    {"PLB", AddressingMode::Implied, false, {6, 6, 0, CycleWidth::None}},               // 0xAB
+    {"LDY", AddressingMode::Absolute, false, {7, 9, 0, CycleWidth::X}},                 // 0xAC
+    {"LDA", AddressingMode::Absolute, false, {7, 9, 0, CycleWidth::M}},                 // 0xAD
+    {"LDX", AddressingMode::Absolute, false, {7, 9, 0, CycleWidth::X}},                 // 0xAE
+    {"LDA", AddressingMode::AbsoluteLong, false, {9, 11, 0, CycleWidth::M}},            // 0xAF
+    {"BCS", AddressingMode::Relative, true, {1, 1, 2, CycleWidth::None}},               // 0xB0
+    {"LDA", AddressingMode::DirectPageIndirectY, false, {9, 11, 2, CycleWidth::M}},     // 0xB1
+    {"LDA", AddressingMode::DirectPageIndirect, false, {9, 11, 1, CycleWidth::M}},      // 0xB2
+    {"LDA", AddressingMode::StackRelativeIndirectY, false, {11, 13, 0, CycleWidth::M}}, // 0xB3
+    {"LDY", AddressingMode::DirectPageX, false, {6, 8, 1, CycleWidth::X}},              // 0xB4
+    {"LDA", AddressingMode::DirectPageX, false, {6, 8, 1, CycleWidth::M}},              // 0xB5
+    {"LDX", AddressingMode::DirectPageY, false, {6, 8, 1, CycleWidth::X}},              // 0xB6
+    {"LDA", AddressingMode::DirectPageIndirectLongY, false, {11, 13, 1, CycleWidth::M}},// 0xB7
+    {"CLV", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0xB8
+    {"LDA", AddressingMode::AbsoluteY, false, {7, 9, 1, CycleWidth::M}},                // 0xB9
+    {"TSX", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0xBA
+    {"TYX", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0xBB
+    {"LDY", AddressingMode::AbsoluteX, false, {7, 9, 1, CycleWidth::X}},                // 0xBC
+    {"LDA", AddressingMode::AbsoluteX, false, {7, 9, 1, CycleWidth::M}},                // 0xBD
+    {"LDX", AddressingMode::AbsoluteY, false, {7, 9, 1, CycleWidth::X}},                // 0xBE
+    {"LDA", AddressingMode::AbsoluteLongX, false, {9, 11, 0, CycleWidth::M}},           // 0xBF
+    {"CPY", AddressingMode::ImmediateX, false, {3, 5, 0, CycleWidth::X}},               // 0xC0
+    {"CMP", AddressingMode::DirectPageIndirectX, false, {10, 12, 1, CycleWidth::M}},    // 0xC1
+    {"REP", AddressingMode::Immediate8, true, {4, 4, 0, CycleWidth::None}},             // 0xC2
+    {"CMP", AddressingMode::StackRelative, false, {6, 8, 0, CycleWidth::M}},            // 0xC3
+    {"CPY", AddressingMode::DirectPage, false, {5, 7, 1, CycleWidth::X}},               // 0xC4
+    {"CMP", AddressingMode::DirectPage, false, {5, 7, 1, CycleWidth::M}},               // 0xC5
+    {"DEC", AddressingMode::DirectPage, false, {7, 10, 1, CycleWidth::M}},              // 0xC6
+    {"CMP", AddressingMode::DirectPageIndirectLong, false, {11, 13, 1, CycleWidth::M}}, // 0xC7
+    {"INY", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0xC8
+    {"CMP", AddressingMode::ImmediateM, false, {3, 5, 0, CycleWidth::M}},               // 0xC9
+    {"DEX", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0xCA
+    {"WAI", AddressingMode::Implied, true, {3, 3, 0, CycleWidth::None}},                // 0xCB
+    {"CPY", AddressingMode::Absolute, false, {7, 9, 0, CycleWidth::X}},                 // 0xCC
+    {"CMP", AddressingMode::Absolute, false, {7, 9, 0, CycleWidth::M}},                 // 0xCD
+    {"DEC", AddressingMode::Absolute, false, {9, 12, 0, CycleWidth::M}},                // 0xCE
+    {"CMP", AddressingMode::AbsoluteLong, false, {9, 11, 0, CycleWidth::M}},            // 0xCF
+    {"BNE", AddressingMode::Relative, true, {1, 1, 2, CycleWidth::None}},               // 0xD0
+    {"CMP", AddressingMode::DirectPageIndirectY, false, {9, 11, 2, CycleWidth::M}},     // 0xD1
+    {"CMP", AddressingMode::DirectPageIndirect, false, {9, 11, 1, CycleWidth::M}},      // 0xD2
+    {"CMP", AddressingMode::StackRelativeIndirectY, false, {11, 13, 0, CycleWidth::M}}, // 0xD3
+    {"PEI", AddressingMode::DirectPageIndirect, false, {11, 11, 1, CycleWidth::None}},  // 0xD4
+    {"CMP", AddressingMode::DirectPageX, false, {6, 8, 1, CycleWidth::M}},              // 0xD5
+    {"DEC", AddressingMode::DirectPageX, false, {8, 11, 1, CycleWidth::M}},             // 0xD6
+    {"CMP", AddressingMode::DirectPageIndirectLongY, false, {11, 13, 1, CycleWidth::M}},// 0xD7
+    {"CLD", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0xD8
+    {"CMP", AddressingMode::AbsoluteY, false, {7, 9, 1, CycleWidth::M}},                // 0xD9
+    {"PHX", AddressingMode::Implied, false, {4, 6, 0, CycleWidth::X}},                  // 0xDA
+    {"STP", AddressingMode::Implied, true, {3, 3, 0, CycleWidth::None}},                // 0xDB
+    {"JML", AddressingMode::AbsoluteIndirectLong, true, {11, 11, 0, CycleWidth::None}}, // 0xDC
+    {"CMP", AddressingMode::AbsoluteX, false, {7, 9, 1, CycleWidth::M}},                // 0xDD
+    {"DEC", AddressingMode::AbsoluteX, false, {10, 13, 0, CycleWidth::M}},              // 0xDE
+    {"CMP", AddressingMode::AbsoluteLongX, false, {10, 12, 0, CycleWidth::M}},          // 0xDF
+    {"CPX", AddressingMode::ImmediateX, false, {3, 5, 0, CycleWidth::X}},               // 0xE0
+    {"SBC", AddressingMode::DirectPageIndirectX, false, {10, 12, 1, CycleWidth::M}},    // 0xE1
+    {"SEP", AddressingMode::Immediate8, true, {4, 4, 0, CycleWidth::None}},             // 0xE2
+    {"SBC", AddressingMode::StackRelative, false, {6, 8, 0, CycleWidth::M}},            // 0xE3
+    {"CPX", AddressingMode::DirectPage, false, {5, 7, 1, CycleWidth::X}},               // 0xE4
+    {"SBC", AddressingMode::DirectPage, false, {5, 7, 1, CycleWidth::M}},               // 0xE5
+    {"INC", AddressingMode::DirectPage, false, {7, 10, 1, CycleWidth::M}},              // 0xE6
+    {"SBC", AddressingMode::DirectPageIndirectLong, false, {11, 13, 1, CycleWidth::M}}, // 0xE7
+    {"INX", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0xE8
+    {"SBC", AddressingMode::ImmediateM, false, {3, 5, 0, CycleWidth::M}},               // 0xE9
+    {"NOP", AddressingMode::Implied, false, {0, 0, 0, CycleWidth::None}},               // 0xEA
+    {"XBA", AddressingMode::Implied, false, {3, 3, 0, CycleWidth::None}},               // 0xEB
+    {"CPX", AddressingMode::Absolute, false, {7, 9, 0, CycleWidth::X}},                 // 0xEC
+    {"SBC", AddressingMode::Absolute, false, {7, 9, 0, CycleWidth::M}},                 // 0xED
+    {"INC", AddressingMode::Absolute, false, {9, 12, 0, CycleWidth::M}},                // 0xEE
+    {"SBC", AddressingMode::AbsoluteLong, false, {9, 11, 0, CycleWidth::M}},            // 0xEF
+    {"BEQ", AddressingMode::Relative, true, {1, 1, 2, CycleWidth::None}},               // 0xF0
+    {"SBC", AddressingMode::DirectPageIndirectY, false, {9, 11, 2, CycleWidth::M}},     // 0xF1
+    {"SBC", AddressingMode::DirectPageIndirect, false, {9, 11, 1, CycleWidth::M}},      // 0xF2
+    {"SBC", AddressingMode::StackRelativeIndirectY, false, {11, 13, 0, CycleWidth::M}}, // 0xF3
+    {"PEA", AddressingMode::Absolute, false, {9, 9, 0, CycleWidth::None}},              // 0xF4
+    {"SBC", AddressingMode::DirectPageX, false, {6, 8, 1, CycleWidth::M}},              // 0xF5
+    {"INC", AddressingMode::DirectPageX, false, {8, 11, 1, CycleWidth::M}},             // 0xF6
+    {"SBC", AddressingMode::DirectPageIndirectLongY, false, {11, 13, 1, CycleWidth::M}},// 0xF7
+    {"SED", AddressingMode::Implied, false, {2, 2, 0, CycleWidth::None}},               // 0xF8
+    {"SBC", AddressingMode::AbsoluteY, false, {7, 9, 1, CycleWidth::M}},                // 0xF9
+    {"PLX", AddressingMode::Implied, false, {6, 9, 0, CycleWidth::X}},                  // 0xFA
+    {"XCE", AddressingMode::Implied, true, {0, 0, 0, CycleWidth::None}},                // 0xFB
+    {"JSR", AddressingMode::AbsoluteIndirectX, true, {14, 14, 0, CycleWidth::None}},    // 0xFC
+    {"SBC", AddressingMode::AbsoluteX, false, {7, 9, 1, CycleWidth::M}},                // 0xFD
+    {"INC", AddressingMode::AbsoluteX, false, {10, 13, 0, CycleWidth::M}},              // 0xFE
+    {"SBC", AddressingMode::AbsoluteLongX, false, {9, 11, 0, CycleWidth::M}},           // 0xFF
+}};
+
+uint8_t InstructionLength(const uint8_t opcode, const bool m_8bit, const bool x_8bit) {
+    switch (kOpcodeTable[opcode].mode) {
+        case AddressingMode::Implied:
+        case AddressingMode::Accumulator:
+            return 1;
+        case AddressingMode::ImmediateM:
+            return m_8bit ? 2 : 3;
+        case AddressingMode::ImmediateX:
+            return x_8bit ? 2 : 3;
+        case AddressingMode::Absolute:
+        case AddressingMode::AbsoluteX:
+        case AddressingMode::AbsoluteY:
+        case AddressingMode::AbsoluteIndirect:
+        case AddressingMode::AbsoluteIndirectX:
+        case AddressingMode::AbsoluteIndirectLong:
+        case AddressingMode::RelativeLong:
+        case AddressingMode::BlockMove:
+            return 3;
+        case AddressingMode::AbsoluteLong:
+        case AddressingMode::AbsoluteLongX:
+            return 4;
+        default:
+            return 2;
+    }
+}
+
+CycleRange InstructionCycles(const uint8_t opcode, const bool m_8bit, const bool x_8bit) {
+    const OpcodeInfo& info = kOpcodeTable[opcode];
+    const bool narrow = info.cycles.width == CycleWidth::None || (info.cycles.width == CycleWidth::M ? m_8bit : x_8bit);
+    const uint32_t min = narrow ? info.cycles.narrow : info.cycles.wide;
+    if (info.mode == AddressingMode::BlockMove) return {min, kVariableCycles};
+    return {min, min + info.cycles.penalties};
+}
+
+const char* AddressingModeName(const AddressingMode mode) {
+    switch (mode) {
+        case AddressingMode::Implied: return "implied";
+        case AddressingMode::Accumulator: return "A";
+        case AddressingMode::ImmediateM: return "#imm (M)";
+        case AddressingMode::ImmediateX: return "#imm (X)";
+        case AddressingMode::Immediate8: return "#imm8";
+        case AddressingMode::DirectPage: return "dp";
+        case AddressingMode::DirectPageX: return "dp,X";
+        case AddressingMode::DirectPageY: return "dp,Y";
+        case AddressingMode::DirectPageIndirect: return "(dp)";
+        case AddressingMode::DirectPageIndirectX: return "(dp,X)";
+        case AddressingMode::DirectPageIndirectY: return "(dp),Y";
+        case AddressingMode::DirectPageIndirectLong: return "[dp]";
+        case AddressingMode::DirectPageIndirectLongY: return "[dp],Y";
+        case AddressingMode::StackRelative: return "sr,S";
+        case AddressingMode::StackRelativeIndirectY: return "(sr,S),Y";
+        case AddressingMode::Absolute: return "abs";
+        case AddressingMode::AbsoluteX: return "abs,X";
+        case AddressingMode::AbsoluteY: return "abs,Y";
+        case AddressingMode::AbsoluteIndirect: return "(abs)";
+        case AddressingMode::AbsoluteIndirectX: return "(abs,X)";
+        case AddressingMode::AbsoluteIndirectLong: return "[abs]";
+        case AddressingMode::AbsoluteLong: return "long";
+        case AddressingMode::AbsoluteLongX: return "long,X";
+        case AddressingMode::Relative: return "rel";
+        case AddressingMode::RelativeLong: return "rel16";
+        case AddressingMode::BlockMove: return "src,dest";
+    }
+    return "?";
+}
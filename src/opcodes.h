@@ -0,0 +1,74 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#ifndef OPCODES_H
+#define OPCODES_H
+#include <array>
+#include <cstdint>
+
+// 65816 addressing modes, as far as the decoder needs to know them
+enum class AddressingMode : uint8_t {
+    Implied,
+    Accumulator,
+    ImmediateM,     // #$nn or #$nnnn depending on the M flag
+    ImmediateX,     // #$nn or #$nnnn depending on the X flag
+    Immediate8,     // Always one operand byte (REP, SEP, BRK, COP, WDM)
+    DirectPage,
+    DirectPageX,
+    DirectPageY,
+    DirectPageIndirect,
+    DirectPageIndirectX,
+    DirectPageIndirectY,
+    DirectPageIndirectLong,
+    DirectPageIndirectLongY,
+    StackRelative,
+    StackRelativeIndirectY,
+    Absolute,
+    AbsoluteX,
+    AbsoluteY,
+    AbsoluteIndirect,
+    AbsoluteIndirectX,
+    AbsoluteIndirectLong,
+    AbsoluteLong,
+    AbsoluteLongX,
+    Relative,
+    RelativeLong,
+    BlockMove
+};
+
+// Which register size an instruction's cycle count depends on
+enum class CycleWidth : uint8_t { None, M, X };
+
+// Cycles the handlers charge for an instruction, the opcode fetch not included
+struct OpcodeCycles {
+    uint8_t narrow;     // With 8-bit registers
+    uint8_t wide;       // With 16-bit registers
+    uint8_t penalties;  // Most that a direct page off a page boundary, a page crossing or a taken branch add
+    CycleWidth width;
+};
+
+struct OpcodeInfo {
+    const char* mnemonic;
+    AddressingMode mode;
+    bool ends_block;    // Changes control flow or M/X/E, so a predecoded block has to stop here
+    OpcodeCycles cycles;
+};
+
+extern const std::array<OpcodeInfo, 256> kOpcodeTable;
+
+// Total instruction length in bytes, opcode included
+uint8_t InstructionLength(uint8_t opcode, bool m_8bit, bool x_8bit);
+
+// Fewest and most cycles an instruction can take under the given register sizes. MVN and MVP
+// charge per byte and run until the deadline, so their most is kVariableCycles.
+static constexpr uint32_t kVariableCycles = UINT32_MAX;
+struct CycleRange {
+    uint32_t min;
+    uint32_t max;
+};
+CycleRange InstructionCycles(uint8_t opcode, bool m_8bit, bool x_8bit);
+
+const char* AddressingModeName(AddressingMode mode);
+
+#endif //OPCODES_H
@@ -5,6 +5,7 @@
 #include "ppu.h"
 
 #include <algorithm>
+#include <iterator>
 
 // PPU Implementation
 void PPU::Reset() {
@@ -12,32 +13,559 @@ void PPU::Reset() {
     dot = 0;
     frame_complete = false;
     brightness = 0x0F;
+    force_blank = true;
     bg_mode = 0;
+    obj_select = 0;
+    oam_address = 0;
+    oam_internal_address = 0;
+    oam_latch = 0;
+    screen_settings = 0;
+    main_screen_layers = 0;
+    sub_screen_layers = 0;
+    vram_increment_mode = 0;
+    vram_address = 0;
+    vram_read_latch = 0;
+    cgram_address = 0;
+    cgram_latch = 0;
+    obj_status = 0;
+    mode7 = {};
+    windows = {};
+    color_math_control = 0;
+    color_math_layers = 0;
+    fixed_color = 0;
+    memory->line_buffers.window_masks_valid = false;
+    ClearFrameLog();
 
-    std::fill(vram, vram + sizeof(vram), 0);
-    std::fill(oam, oam + sizeof(oam), 0);
-    std::fill(cgram, cgram + sizeof(cgram), 0);
+    std::fill(memory->vram, memory->vram + sizeof(Memory::vram), 0);
+    std::fill(memory->oam, memory->oam + sizeof(Memory::oam), 0);
+    std::fill(memory->cgram, memory->cgram + sizeof(Memory::cgram), 0);
+    for (uint32_t i = 0; i < 0x100; i++) UpdatePalette(i);
+    std::fill(std::begin(memory->framebuffer), std::end(memory->framebuffer), 0xFF000000);
+    output_width = kScreenWidth;
+    output_height = VisibleLines();
+    frame_interlaced = false;
+    odd_field = false;
+    vram_dirty.MarkAll();
+    InvalidateObjects();
 }
 
-void PPU::Step() {
-    dot++;
-    if (dot >= 341) {
-        dot = 0;
-        scanline++;
+// The framebuffer isn't saved; the first frame after loading draws over it
+void PPU::SaveState(StateWriter& writer) const {
+    writer.WriteBytes(memory->vram, sizeof(Memory::vram));
+    writer.WriteBytes(memory->oam, sizeof(Memory::oam));
+    writer.WriteBytes(memory->cgram, sizeof(Memory::cgram));
+    writer.Write(scanline);
+    writer.Write(dot);
+    writer.Write(frame_complete);
 
-        if (scanline >= 262) {
-            scanline = 0;
-            frame_complete = true;
-        }
+    writer.Write(brightness);
+    writer.Write(force_blank);
+    writer.Write(bg_mode);
+    writer.Write(obj_select);
+    writer.Write(oam_address);
+    writer.Write(oam_internal_address);
+    writer.Write(oam_latch);
+    writer.Write(screen_settings);
+    writer.Write(main_screen_layers);
+    writer.Write(sub_screen_layers);
+    writer.Write(vram_increment_mode);
+    writer.Write(vram_address);
+    writer.Write(vram_read_latch);
+    writer.Write(cgram_address);
+    writer.Write(cgram_latch);
+    writer.Write(obj_status);
+
+    // Field by field, so padding never ends up in the state
+    for (const int16_t value : {mode7.a, mode7.b, mode7.c, mode7.d, mode7.center_x, mode7.center_y,
+                                mode7.h_offset, mode7.v_offset}) {
+        writer.Write(value);
     }
+    writer.Write(mode7.settings);
+    writer.Write(mode7.latch);
+    writer.Write(mode7.multiplicand);
+    writer.Write(windows);
+    writer.Write(color_math_control);
+    writer.Write(color_math_layers);
+    writer.Write(fixed_color);
+
+    writer.Write(output_width);
+    writer.Write(output_height);
+    writer.Write(frame_interlaced);
+    writer.Write(odd_field);
+}
+
+void PPU::LoadState(StateReader& reader) {
+    reader.ReadBytes(memory->vram, sizeof(Memory::vram));
+    reader.ReadBytes(memory->oam, sizeof(Memory::oam));
+    reader.ReadBytes(memory->cgram, sizeof(Memory::cgram));
+    reader.Read(scanline);
+    reader.Read(dot);
+    reader.Read(frame_complete);
+
+    reader.Read(brightness);
+    reader.Read(force_blank);
+    reader.Read(bg_mode);
+    reader.Read(obj_select);
+    reader.Read(oam_address);
+    reader.Read(oam_internal_address);
+    reader.Read(oam_latch);
+    reader.Read(screen_settings);
+    reader.Read(main_screen_layers);
+    reader.Read(sub_screen_layers);
+    reader.Read(vram_increment_mode);
+    reader.Read(vram_address);
+    reader.Read(vram_read_latch);
+    reader.Read(cgram_address);
+    reader.Read(cgram_latch);
+    reader.Read(obj_status);
+
+    for (int16_t* value : {&mode7.a, &mode7.b, &mode7.c, &mode7.d, &mode7.center_x, &mode7.center_y,
+                           &mode7.h_offset, &mode7.v_offset}) {
+        reader.Read(*value);
+    }
+    reader.Read(mode7.settings);
+    reader.Read(mode7.latch);
+    reader.Read(mode7.multiplicand);
+    reader.Read(windows);
+    reader.Read(color_math_control);
+    reader.Read(color_math_layers);
+    reader.Read(fixed_color);
+
+    reader.Read(output_width);
+    reader.Read(output_height);
+    reader.Read(frame_interlaced);
+    reader.Read(odd_field);
+    output_width = std::min(output_width, kMaxOutputWidth);
+    output_height = std::min(output_height, kMaxOutputHeight);
+    brightness &= 0x0F;
+
+    // Everything derived from the loaded memory and registers is rebuilt
+    ClearFrameLog();
+    memory->line_buffers.window_masks_valid = false;
+    for (uint32_t i = 0; i < 0x100; i++) UpdatePalette(i);
+    vram_dirty.MarkAll();
+    InvalidateObjects();
+}
+
+void PPU::Step() {
+    Advance(1);
+}
+
+void PPU::Advance(const uint32_t dots) {
+    if (dots >= DotsUntilFrameEnd()) frame_complete = true;
 
-    // TODO: Implement PPU renderer
+    const uint32_t position = (scanline * kDotsPerScanline + dot + dots % kDotsPerFrame) % kDotsPerFrame;
+    scanline = position / kDotsPerScanline;
+    dot = position % kDotsPerScanline;
+}
+
+uint32_t PPU::DotsUntilFrameEnd() const {
+    return kDotsPerFrame - (scanline * kDotsPerScanline + dot);
 }
 
 uint8_t PPU::ReadVRAM(uint16_t address) {
-    return vram[address & 0xFFFF];
+    return memory->vram[address & 0xFFFF];
 }
 
 void PPU::WriteVRAM(uint16_t address, uint8_t value) {
-    vram[address & 0xFFFF] = value;
-}
\ No newline at end of file
+    if (vram_versions.shared) Detach(vram_versions, memory->vram, sizeof(Memory::vram), &LineState::vram);
+    memory->vram[address & 0xFFFF] = value;
+    vram_dirty.Mark(address);
+}
+
+// VMAIN bits 2-3 rotate the low bits of the word address, for writing 2/4/8bpp tiles column-wise
+uint16_t PPU::VRAMWordAddress() const {
+    const uint16_t a = vram_address;
+    switch ((vram_increment_mode >> 2) & 3) {
+        case 1: return (a & 0xFF00) | ((a & 0x001F) << 3) | ((a >> 5) & 7);
+        case 2: return (a & 0xFE00) | ((a & 0x003F) << 3) | ((a >> 6) & 7);
+        case 3: return (a & 0xFC00) | ((a & 0x007F) << 3) | ((a >> 7) & 7);
+        default: return a;
+    }
+}
+
+void PPU::IncrementVRAMAddress(const bool high_byte) {
+    static constexpr uint16_t steps[] = {1, 32, 128, 128};
+    if (high_byte == ((vram_increment_mode & 0x80) != 0)) vram_address += steps[vram_increment_mode & 3];
+}
+
+// The low table takes words: even bytes are latched and written together with the odd byte
+void PPU::WriteOAM(const uint8_t value) {
+    const uint16_t address = oam_internal_address;
+    if (address >= 0x200) {
+        memory->oam[0x200 | (address & 0x1F)] = value;
+        InvalidateObjects();
+    } else if (address & 1) {
+        memory->oam[address - 1] = oam_latch;
+        memory->oam[address] = value;
+        InvalidateObjects();
+    } else {
+        oam_latch = value;
+    }
+    oam_internal_address = (address + 1) & 0x3FF;
+}
+
+uint8_t PPU::ReadRegister(const uint16_t address) {
+    switch (address) {
+        case 0x2138: {  // OAMDATAREAD
+            const uint16_t oam_byte = oam_internal_address;
+            oam_internal_address = (oam_byte + 1) & 0x3FF;
+            return oam_byte >= 0x200 ? memory->oam[0x200 | (oam_byte & 0x1F)] : memory->oam[oam_byte];
+        }
+        case 0x2139:    // VMDATALREAD
+        case 0x213A: {  // VMDATAHREAD
+            const bool high = address == 0x213A;
+            const uint8_t value = high ? vram_read_latch >> 8 : vram_read_latch & 0xFF;
+            if (high == ((vram_increment_mode & 0x80) != 0)) {
+                const uint16_t word = VRAMWordAddress() & 0x7FFF;
+                vram_read_latch = memory->vram[word * 2] | (memory->vram[word * 2 + 1] << 8);
+                IncrementVRAMAddress(high);
+            }
+            return value;
+        }
+        case 0x2134:    // MPYL/MPYM/MPYH: M7A times the last byte written to M7B
+        case 0x2135:
+        case 0x2136: {
+            const int32_t product = mode7.a * static_cast<int8_t>(mode7.multiplicand);
+            return static_cast<uint8_t>(product >> ((address - 0x2134) * 8));
+        }
+        case 0x213B: {  // CGDATAREAD
+            const uint8_t value = memory->cgram[cgram_address];
+            cgram_address = (cgram_address + 1) & 0x1FF;
+            return value;
+        }
+        case 0x213E:    // STAT77: PPU1 version 1
+            return obj_status | 0x01;
+        case 0x213F:    // STAT78: current field, PPU2 version 1, NTSC
+            return (odd_field ? 0x80 : 0x00) | 0x01;
+        default:
+            return 0x00; // Open bus
+    }
+}
+
+void PPU::WriteRegister(const uint16_t address, const uint8_t value) {
+    switch (address) {
+        case 0x2100:    // INIDISP
+            force_blank = value & 0x80;
+            SetBrightness(value & 0x0F);
+            break;
+        case 0x2101:    // OBSEL
+            if (value != obj_select) InvalidateObjects();
+            obj_select = value;
+            break;
+        case 0x2102:    // OAMADDL
+        case 0x2103: {  // OAMADDH
+            const uint8_t first_object = FirstObject();
+            if (address == 0x2102) {
+                oam_address = (oam_address & 0xFF00) | value;
+            } else {
+                oam_address = (oam_address & 0x00FF) | ((value & 0x81) << 8);
+            }
+            oam_internal_address = (oam_address & 0x1FF) << 1;
+            if (FirstObject() != first_object) InvalidateObjects();
+            break;
+        }
+        case 0x2104:    // OAMDATA
+            WriteOAM(value);
+            break;
+        case 0x2105:    // BGMODE
+            bg_mode = value;
+            break;
+        case 0x210D:    // BG1HOFS, also M7HOFS
+        case 0x210E:    // BG1VOFS, also M7VOFS
+        case 0x211B:    // M7A
+        case 0x211C:    // M7B
+        case 0x211D:    // M7C
+        case 0x211E:    // M7D
+        case 0x211F:    // M7X
+        case 0x2120:    // M7Y
+            WriteMode7(address, value);
+            break;
+        case 0x211A:    // M7SEL
+            mode7.settings = value;
+            break;
+        case 0x2115:    // VMAIN
+            vram_increment_mode = value;
+            break;
+        case 0x2116:    // VMADDL
+        case 0x2117: {  // VMADDH
+            if (address == 0x2116) {
+                vram_address = (vram_address & 0xFF00) | value;
+            } else {
+                vram_address = (vram_address & 0x00FF) | (value << 8);
+            }
+            const uint16_t word = VRAMWordAddress() & 0x7FFF;
+            vram_read_latch = memory->vram[word * 2] | (memory->vram[word * 2 + 1] << 8);
+            break;
+        }
+        case 0x2118:    // VMDATAL
+        case 0x2119: {  // VMDATAH
+            const bool high = address == 0x2119;
+            WriteVRAM(((VRAMWordAddress() & 0x7FFF) << 1) | high, value);
+            IncrementVRAMAddress(high);
+            break;
+        }
+        case 0x2121:    // CGADD
+            cgram_address = value << 1;
+            break;
+        case 0x2122:    // CGDATA
+            if (cgram_address & 1) {
+                if (cgram_versions.shared) {
+                    Detach(cgram_versions, memory->cgram, sizeof(Memory::cgram), &LineState::cgram);
+                }
+                if (palette_versions.shared) Detach(palette_versions, memory->palette, 0x100, &LineState::palette);
+                memory->cgram[cgram_address - 1] = cgram_latch;
+                memory->cgram[cgram_address] = value & 0x7F;
+                UpdatePalette(cgram_address >> 1);
+            } else {
+                cgram_latch = value;
+            }
+            cgram_address = (cgram_address + 1) & 0x1FF;
+            break;
+        case 0x2123:    // W12SEL
+        case 0x2124:    // W34SEL
+        case 0x2125:    // WOBJSEL
+            windows.settings[address - 0x2123] = value;
+            break;
+        case 0x2126:    // WH0
+        case 0x2128:    // WH2
+            windows.left[(address - 0x2126) / 2] = value;
+            break;
+        case 0x2127:    // WH1
+        case 0x2129:    // WH3
+            windows.right[(address - 0x2127) / 2] = value;
+            break;
+        case 0x212A:    // WBGLOG
+        case 0x212B:    // WOBJLOG
+            windows.logic[address - 0x212A] = value;
+            break;
+        case 0x212C:    // TM
+            main_screen_layers = value;
+            break;
+        case 0x212D:    // TS
+            sub_screen_layers = value;
+            break;
+        case 0x212E:    // TMW
+            windows.main_mask = value;
+            break;
+        case 0x212F:    // TSW
+            windows.sub_mask = value;
+            break;
+        case 0x2130:    // CGWSEL
+            color_math_control = value;
+            break;
+        case 0x2131:    // CGADSUB
+            color_math_layers = value;
+            break;
+        case 0x2133:    // SETINI
+            screen_settings = value;
+            break;
+        case 0x2132:    // COLDATA: bits 5-7 pick which channels get the intensity
+            if (value & 0x20) fixed_color = (fixed_color & ~0x001F) | (value & 0x1F);
+            if (value & 0x40) fixed_color = (fixed_color & ~0x03E0) | ((value & 0x1F) << 5);
+            if (value & 0x80) fixed_color = (fixed_color & ~0x7C00) | ((value & 0x1F) << 10);
+            break;
+        case 0x2106:    // MOSAIC
+        case 0x2107:    // BG1SC
+        case 0x2108:    // BG2SC
+        case 0x2109:    // BG3SC
+        case 0x210A:    // BG4SC
+        case 0x210B:    // BG12NBA
+        case 0x210C:    // BG34NBA
+        case 0x210F:    // BG2HOFS
+        case 0x2110:    // BG2VOFS
+        case 0x2111:    // BG3HOFS
+        case 0x2112:    // BG3VOFS
+        case 0x2113:    // BG4HOFS
+        case 0x2114:    // BG4VOFS
+            // Ignored: BG modes 0-6 have no layers yet (see DrawLine), so nothing would read them
+            break;
+        default:
+            // $2134-$213F are read-only
+            break;
+    }
+}
+
+// The mode 7 registers are written twice, low byte first, through a shared latch
+void PPU::WriteMode7(const uint16_t address, const uint8_t value) {
+    const uint16_t word = (value << 8) | mode7.latch;
+    mode7.latch = value;
+    const auto sign_extend_13 = [](const uint16_t v) {
+        return static_cast<int16_t>(static_cast<int16_t>(v << 3) >> 3);
+    };
+
+    switch (address) {
+        case 0x210D: mode7.h_offset = sign_extend_13(word); break;
+        case 0x210E: mode7.v_offset = sign_extend_13(word); break;
+        case 0x211B: mode7.a = static_cast<int16_t>(word); break;
+        case 0x211C:
+            mode7.b = static_cast<int16_t>(word);
+            mode7.multiplicand = value;
+            break;
+        case 0x211D: mode7.c = static_cast<int16_t>(word); break;
+        case 0x211E: mode7.d = static_cast<int16_t>(word); break;
+        case 0x211F: mode7.center_x = sign_extend_13(word); break;
+        case 0x2120: mode7.center_y = sign_extend_13(word); break;
+        default: break;
+    }
+}
+
+// Fades write INIDISP every frame, so the palette is only rebuilt when the level actually changes
+void PPU::SetBrightness(const uint8_t level) {
+    if (level == brightness) return;
+    if (palette_versions.shared) Detach(palette_versions, memory->palette, 0x100, &LineState::palette);
+    brightness = level;
+    for (uint32_t i = 0; i < 0x100; i++) UpdatePalette(i);
+}
+
+void PPU::OnVBlankStart() {
+    if (!force_blank) oam_internal_address = (oam_address & 0x1FF) << 1;
+    if (!frame_lines.empty()) DrawFrameLog();
+}
+
+void PPU::OnFrameStart() {
+    if (!force_blank) obj_status = 0;
+    odd_field = !odd_field;
+}
+
+// The frame's size is picked from the registers at its first line; interlaced frames keep the
+// other field's rows from the previous frame
+void PPU::BeginFrame(const bool hires) {
+    output_width = hires ? kMaxOutputWidth : kScreenWidth;
+    frame_interlaced = screen_settings & 0x01;
+    output_height = VisibleLines() * (frame_interlaced ? 2 : 1);
+}
+
+// A hi-res line mid-frame: re-lays the frame out at 512 wide, doubling every pixel. Works
+// backwards so each row moves into space the rows below it have already vacated.
+void PPU::WidenFrame() {
+    uint32_t* pixels = memory->framebuffer;
+    for (uint32_t row = output_height; row-- > 0;) {
+        const uint32_t* source = pixels + row * kScreenWidth;
+        uint32_t* target = pixels + row * kMaxOutputWidth;
+        for (uint32_t x = kScreenWidth; x-- > 0;) {
+            const uint32_t pixel = source[x];
+            target[x * 2] = pixel;
+            target[x * 2 + 1] = pixel;
+        }
+    }
+    output_width = kMaxOutputWidth;
+}
+
+void PPU::RenderScanline(const uint16_t line) {
+    if (line == 0 || line > VisibleLines()) return;
+    const uint32_t y = line - 1;
+
+    // Sprites are evaluated whether or not they're drawn, for the STAT77 flags
+    const ObjLine* sprites = nullptr;
+    if (!force_blank) {
+        if (y < obj_valid_from) EvaluateObjects(y);
+        sprites = &memory->obj_lines[y];
+        obj_status |= (sprites->time_over ? 0x80 : 0) | (sprites->range_over ? 0x40 : 0);
+    }
+    if (skip_drawing) return;
+
+    const bool hires = IsHiRes();
+    if (line == 1) {
+        BeginFrame(hires);
+    } else if (hires && output_width != kMaxOutputWidth) {
+        WidenFrame();
+    }
+    // Lines past the frame's height only happen if overscan was turned on mid-frame
+    const uint32_t row = frame_interlaced ? y * 2 + odd_field : y;
+    if (row >= output_height) return;
+
+    const LineState state = {
+        memory->vram, memory->cgram, memory->palette, sprites, row, line, hires, force_blank, brightness, bg_mode,
+        main_screen_layers, sub_screen_layers, color_math_control, color_math_layers, fixed_color,
+        mode7, windows,
+    };
+    if (!render_workers) {
+        DrawLine(state, memory->line_buffers);
+        return;
+    }
+    Share(vram_versions);
+    Share(cgram_versions);
+    Share(palette_versions);
+    frame_lines.push_back(state);
+}
+
+void PPU::DrawLine(const LineState& state, LineBuffers& buffers) {
+    uint32_t* out = memory->framebuffer + state.row * output_width;
+    if (state.force_blank) {
+        std::fill(out, out + output_width, 0xFF000000);
+        return;
+    }
+
+    // Layers only need drawing if a screen shows them; the sub screen only matters for color math
+    // and hi-res, where it makes up the even dots
+    const bool sub_screen = state.hires || ((state.color_math_control & 0x02) && (state.color_math_layers & 0x3F));
+    const uint8_t shown = state.main_screen_layers | (sub_screen ? state.sub_screen_layers : 0);
+    uint8_t rendered = 0;
+    if (shown & 0x10) {
+        RenderObjects(state, buffers);
+        rendered |= 0x10;
+    }
+    // TODO: BG modes 0-6
+    if ((state.bg_mode & 7) == 7 && (shown & 0x01)) {
+        RenderMode7(state, buffers);
+        rendered |= 0x01;
+    }
+
+    if (output_width == kScreenWidth) {
+        Composite(state, buffers, rendered, out);
+        return;
+    }
+
+    uint32_t main[kScreenWidth], sub[kScreenWidth];
+    Composite(state, buffers, rendered, main);
+    if (state.hires) {
+        CompositeSubScreen(state, buffers, rendered, sub);
+    } else {
+        std::copy(main, main + kScreenWidth, sub);
+    }
+    for (uint32_t x = 0; x < kScreenWidth; x++) {
+        out[x * 2] = sub[x];
+        out[x * 2 + 1] = main[x];
+    }
+}
+
+// Called just before a write changes memory that logged lines still point at
+template <typename T>
+void PPU::Detach(MemoryVersions<T>& versions, const T* live, const uint32_t count, const T* LineState::*pointer) {
+    if (versions.copies_used == versions.copies.size()) {
+        versions.copies.push_back(std::make_unique<T[]>(count));
+    }
+    T* copy = versions.copies[versions.copies_used++].get();
+    std::copy(live, live + count, copy);
+    for (uint32_t i = versions.shared_from; i < frame_lines.size(); i++) frame_lines[i].*pointer = copy;
+    versions.shared = false;
+}
+
+void PPU::DrawFrameLog() {
+    const uint32_t line_count = static_cast<uint32_t>(frame_lines.size());
+    const uint32_t bands = (line_count + kLinesPerBand - 1) / kLinesPerBand;
+    if (band_buffers.size() < bands) band_buffers.resize(bands);
+    render_workers->Run(bands, [this, line_count](const uint32_t band) {
+        const uint32_t end = std::min(line_count, (band + 1) * kLinesPerBand);
+        for (uint32_t i = band * kLinesPerBand; i < end; i++) DrawLine(frame_lines[i], band_buffers[band]);
+    });
+
+    ClearFrameLog();
+}
+
+void PPU::ClearFrameLog() {
+    frame_lines.clear();
+    vram_versions.shared = false;
+    vram_versions.copies_used = 0;
+    cgram_versions.shared = false;
+    cgram_versions.copies_used = 0;
+    palette_versions.shared = false;
+    palette_versions.copies_used = 0;
+}
+
+void PPU::SetRenderThreads(const uint32_t threads) {
+    // Lines already logged are drawn by the old pool
+    if (!frame_lines.empty()) DrawFrameLog();
+    render_workers = threads ? std::make_unique<WorkerPool>(threads - 1) : nullptr;
+}
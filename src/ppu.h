@@ -4,14 +4,47 @@
 
 #ifndef PPU_H
 #define PPU_H
+#include <array>
 #include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "dirty_pages.h"
+#include "memory_arena.h"
+#include "save_state.h"
+#include "worker_pool.h"
 
 // PPU (Picture Processing Unit)
-class PPU {
+class alignas(64) PPU {
+public:
+    // Dots per line on each of the main and sub screens, and visible lines per field with overscan
+    static constexpr uint32_t kScreenWidth = 256;
+    static constexpr uint32_t kMaxScreenHeight = 239;
+    // Output frames are 256 or 512 0xAARRGGBB pixels wide (hi-res) and 224/239 lines tall, or
+    // 448/478 when interlaced
+    static constexpr uint32_t kMaxOutputWidth = kScreenWidth * 2;
+    static constexpr uint32_t kMaxOutputHeight = kMaxScreenHeight * 2;
+
 private:
-    uint8_t vram[0x10000];      // 64KB Video RAM
-    uint8_t oam[0x220];         // Object Attribute Memory
-    uint8_t cgram[0x200];       // Color Generator RAM
+    // OBJ hardware limits per scanline
+    static constexpr uint32_t kMaxLineSprites = 32;
+    static constexpr uint32_t kMaxLineTiles = 34;
+
+    // One 8-pixel OBJ tile sliver the PPU fetches for a line
+    struct ObjTile {
+        int16_t x;
+        uint16_t address;       // VRAM byte address of the row's bitplanes 0/1 (2/3 are 16 bytes on)
+        uint8_t attributes;     // OAM attribute byte: flips, priority, palette
+        uint8_t reserved;
+    };
+
+    // Result of sprite evaluation for one screen line
+    struct ObjLine {
+        uint8_t tile_count;
+        bool range_over;        // More than 32 sprites were on the line
+        bool time_over;         // More than 34 tiles were, and the extra ones were dropped
+        ObjTile tiles[kMaxLineTiles];   // In fetch order, so later tiles win where sprites overlap
+    };
 
     uint16_t scanline;
     uint16_t dot;
@@ -19,25 +52,255 @@ private:
 
     // PPU registers
     uint8_t brightness;
+    bool force_blank;
     uint8_t bg_mode;
-    // TODO: Add remaining registers
+    uint8_t obj_select;             // $2101 OBSEL: sprite sizes and tile bases
+    uint16_t oam_address;           // $2102/3 as written: word address and priority rotation bit
+    uint16_t oam_internal_address;  // Byte address the next $2104/$2138 access uses
+    uint8_t oam_latch;
+    uint8_t screen_settings;        // $2133 SETINI: interlace, overscan, pseudo hi-res
+    uint8_t main_screen_layers;     // $212C TM
+    uint8_t sub_screen_layers;      // $212D TS
+    uint8_t vram_increment_mode;    // $2115 VMAIN
+    uint16_t vram_address;          // Word address
+    uint16_t vram_read_latch;
+    uint16_t cgram_address;         // Byte address
+    uint8_t cgram_latch;
+    uint8_t obj_status;             // $213E range/time over flags
+
+    struct Mode7 {
+        int16_t a, b, c, d;             // $211B-$211E matrix, 8.8 fixed point
+        int16_t center_x, center_y;     // $211F/$2120, 13-bit signed
+        int16_t h_offset, v_offset;     // $210D/$210E, 13-bit signed
+        uint8_t settings;               // $211A M7SEL: fill mode and flips
+        uint8_t latch;                  // Last byte written to any mode 7 register
+        uint8_t multiplicand;           // Last byte written to $211C, for $2134-$2136
+    } mode7;
+
+    // Windows and color math
+    struct Windows {
+        uint8_t left[2], right[2];      // $2126-$2129, window 1 and 2 edges (inclusive)
+        uint8_t settings[3];            // $2123-$2125 W12SEL/W34SEL/WOBJSEL, 4 bits per layer
+        uint8_t logic[2];               // $212A/$212B WBGLOG/WOBJLOG
+        uint8_t main_mask;              // $212E TMW
+        uint8_t sub_mask;               // $212F TSW
+    } windows;
+    uint8_t color_math_control;         // $2130 CGWSEL
+    uint8_t color_math_layers;          // $2131 CGADSUB
+    uint16_t fixed_color;               // $2132 COLDATA, BGR555
+
+    // Sprite evaluation depends only on OAM and OBSEL, so it's done for every line at once and
+    // kept until one of those changes. Lines from obj_valid_from on are up to date.
+    uint32_t obj_valid_from;
+
+    // Everything drawing a line reads, captured as the line starts
+    struct LineState {
+        const uint8_t* vram;            // Live VRAM, or a copy of it from before a later write
+        const uint8_t* cgram;           // Same for CGRAM
+        const uint32_t* palette;        // And for the host palette
+        const ObjLine* sprites;         // Null on force blank lines
+        uint32_t row;                   // Framebuffer row
+        uint16_t line;
+        bool hires;
+        bool force_blank;
+        uint8_t brightness;
+        uint8_t bg_mode;
+        uint8_t main_screen_layers;
+        uint8_t sub_screen_layers;
+        uint8_t color_math_control;
+        uint8_t color_math_layers;
+        uint16_t fixed_color;
+        Mode7 mode7;
+        Windows windows;
+    };
+
+    // Scratch space for drawing lines, one set per thread drawing them
+    struct LineBuffers {
+        uint8_t bg_color[4][kScreenWidth];  // CGRAM index per BG layer, 0 where transparent
+        uint8_t bg_priority[4][kScreenWidth];
+        uint8_t obj_color[kScreenWidth];    // CGRAM index, 0 where no sprite is opaque
+        uint8_t obj_priority[kScreenWidth];
+
+        // Window shapes change rarely, so the per-layer masks are kept until the window
+        // registers differ from the ones they were built from. 0xFF inside the layer's
+        // combined window, 0 outside.
+        uint8_t window_masks[6][kScreenWidth];  // BG1-4, OBJ, color window
+        Windows window_source;
+        bool window_masks_valid = false;
+    };
 
 public:
-    PPU() {
+    // Everything bulky, kept apart from the registers
+    struct Memory {
+        uint8_t vram[0x10000];      // 64KB Video RAM
+        uint8_t oam[0x220];         // Object Attribute Memory
+        uint8_t cgram[0x200];       // Color Generator RAM
+        uint32_t palette[0x100];    // CGRAM as host pixels at the current brightness
+        ObjLine obj_lines[kMaxScreenHeight];
+        LineBuffers line_buffers;
+        // The frame being drawn, output_width pixels per row
+        uint32_t framebuffer[kMaxOutputWidth * kMaxOutputHeight];
+    };
+
+private:
+    BulkMemory<Memory> memory;
+    DirtyPageMap<sizeof(Memory::vram)> vram_dirty;
+
+    // Deferred rendering (SetRenderThreads): lines are logged as they start and drawn in bands
+    // across the workers at VBlank
+    static constexpr uint32_t kLinesPerBand = 16;
+    std::unique_ptr<WorkerPool> render_workers;
+    std::vector<LineState> frame_lines;
+    std::vector<LineBuffers> band_buffers;
+
+    // Logged lines point at live VRAM/CGRAM/palette until the next write to it, which first copies
+    // the memory aside and points them at the copy. Mid-frame writes are rare (VRAM only takes them
+    // in force blank), so most frames never copy anything.
+    template <typename T>
+    struct MemoryVersions {
+        std::vector<std::unique_ptr<T[]>> copies;   // Kept from frame to frame
+        uint32_t copies_used = 0;
+        bool shared = false;            // Logged lines from shared_from on read the live memory
+        uint32_t shared_from = 0;
+    };
+    MemoryVersions<uint8_t> vram_versions;
+    MemoryVersions<uint8_t> cgram_versions;
+    MemoryVersions<uint32_t> palette_versions;
+
+    // Low-res frames stay 256 wide; a frame is only widened to 512 (doubling what's drawn so far)
+    // when a hi-res line turns up
+    uint32_t output_width;
+    uint32_t output_height;
+    bool frame_interlaced;
+    bool odd_field;                 // Interlaced frames draw odd rows on odd fields
+    bool skip_drawing = false;      // See SetSkipDrawing
+
+    // With priority rotation on, OAMADD picks which sprite has the highest priority
+    [[nodiscard]] uint8_t FirstObject() const { return oam_address & 0x8000 ? (oam_address >> 1) & 0x7F : 0; }
+    void InvalidateObjects() { obj_valid_from = kMaxScreenHeight; }
+    // Rebuilds obj_lines from `first_line` down
+    void EvaluateObjects(uint32_t first_line);
+
+    // Line drawing only sees the captured state, so it can run on any thread
+    void DrawLine(const LineState& state, LineBuffers& buffers);
+    static void RenderObjects(const LineState& state, LineBuffers& buffers);
+    static void RenderMode7(const LineState& state, LineBuffers& buffers);
+
+    // Compositor stages, see ppu_compositor.cpp
+    static void UpdateWindowMasks(const Windows& windows, LineBuffers& buffers);
+    static void ResolveScreen(const LineState& state, const LineBuffers& buffers, uint8_t layers,
+                              uint8_t windowed_layers, uint8_t* color, uint8_t* layer);
+    static void Composite(const LineState& state, LineBuffers& buffers, uint8_t rendered_layers, uint32_t* out);
+    // The sub screen on its own, for the even dots of hi-res lines
+    static void CompositeSubScreen(const LineState& state, LineBuffers& buffers, uint8_t rendered_layers,
+                                   uint32_t* out);
+
+    template <typename T>
+    void Share(MemoryVersions<T>& versions) {
+        if (versions.shared) return;
+        versions.shared = true;
+        versions.shared_from = static_cast<uint32_t>(frame_lines.size());
+    }
+    template <typename T>
+    void Detach(MemoryVersions<T>& versions, const T* live, uint32_t count, const T* LineState::*pointer);
+    void DrawFrameLog();
+    void ClearFrameLog();
+
+    [[nodiscard]] bool IsHiRes() const {
+        return (bg_mode & 7) == 5 || (bg_mode & 7) == 6 || (screen_settings & 0x08);
+    }
+    [[nodiscard]] uint32_t VisibleLines() const { return screen_settings & 0x04 ? 239 : 224; }
+    void BeginFrame(bool hires);
+    void WidenFrame();
+
+    [[nodiscard]] uint16_t VRAMWordAddress() const;
+    void IncrementVRAMAddress(bool high_byte);
+    void WriteOAM(uint8_t value);
+    void WriteMode7(uint16_t address, uint8_t value);
+
+    [[nodiscard]] static uint16_t CGRAMColor(const uint8_t* cgram, const uint8_t index) {
+        return cgram[index * 2] | (cgram[index * 2 + 1] << 8);
+    }
+
+    // 5-bit color channel to 8-bit host channel, per master brightness level
+    static constexpr auto kBrightnessLevels = [] {
+        std::array<std::array<uint8_t, 32>, 16> levels{};
+        for (uint32_t level = 0; level < 16; level++) {
+            for (uint32_t c = 0; c < 32; c++) {
+                levels[level][c] = static_cast<uint8_t>((((c << 3) | (c >> 2)) * level + 7) / 15);
+            }
+        }
+        return levels;
+    }();
+
+    // BGR555 scaled by the master brightness
+    [[nodiscard]] static uint32_t ToHostColor(const uint16_t color, const uint8_t brightness) {
+        const std::array<uint8_t, 32>& channel = kBrightnessLevels[brightness];
+        return 0xFF000000 | (channel[color & 0x1F] << 16) | (channel[(color >> 5) & 0x1F] << 8) |
+               channel[(color >> 10) & 0x1F];
+    }
+    void UpdatePalette(uint8_t index) {
+        memory->palette[index] = ToHostColor(CGRAMColor(memory->cgram, index), brightness);
+    }
+    void SetBrightness(uint8_t level);
+
+public:
+    // NTSC timing
+    static constexpr uint64_t kMasterCyclesPerDot = 4;
+    static constexpr uint32_t kDotsPerScanline = 341;
+    static constexpr uint32_t kScanlinesPerFrame = 262;
+    static constexpr uint32_t kVBlankScanline = 225;   // Without overscan, see VBlankScanline()
+    static constexpr uint32_t kDotsPerFrame = kDotsPerScanline * kScanlinesPerFrame;
+    static constexpr uint32_t kHBlankStartDot = 274;
+    static constexpr uint32_t kHBlankEndDot = 1;
+
+    // Without a block of the System's arena, the PPU allocates its own memory
+    explicit PPU(Memory* block = nullptr) : memory(block) {
         Reset();
     }
 
     void Reset();
+    void SaveState(StateWriter& writer) const;
+    void LoadState(StateReader& reader);
     void Step();
+    // Runs several dots at once
+    void Advance(uint32_t dots);
+    [[nodiscard]] uint32_t DotsUntilFrameEnd() const;
     [[nodiscard]] bool IsFrameComplete() const { return frame_complete; }
     void SetFrameComplete(bool complete) { frame_complete = complete; }
 
     std::uint8_t ReadVRAM(uint16_t address);
     void WriteVRAM(uint16_t address, uint8_t value);
 
-    // TODO: Implement Rendering
-    void RenderScanline();
-    void UpdateScreen();
+    // $2100-$213F as seen from the CPU bus
+    uint8_t ReadRegister(uint16_t address);
+    void WriteRegister(uint16_t address, uint8_t value);
+
+    // Incremental snapshot support
+    [[nodiscard]] const uint8_t* GetVRAM() const { return memory->vram; }
+    DirtyPageMap<sizeof(Memory::vram)>& GetVRAMDirtyPages() { return vram_dirty; }
+
+    // Frame signals from the system's scanline event
+    void OnVBlankStart();
+    void OnFrameStart();
+
+    // First line of VBlank: 225, or 240 with overscan
+    [[nodiscard]] uint16_t VBlankScanline() const { return static_cast<uint16_t>(VisibleLines() + 1); }
+
+    // Draws visible line 1-224 (1-239 with overscan) into the framebuffer using the current register
+    // state, or logs it for drawing at VBlank when deferred
+    void RenderScanline(uint16_t line);
+    // 0 draws each line as it starts. Otherwise lines are drawn together at VBlank on `threads`
+    // threads, the calling one included, with the registers and memory each line saw.
+    void SetRenderThreads(uint32_t threads);
+    // For frames nobody will see: lines still evaluate sprites and set the STAT77 flags, but draw
+    // nothing, and the framebuffer keeps the last frame that was drawn
+    void SetSkipDrawing(bool skip) { skip_drawing = skip; }
+    [[nodiscard]] bool IsSkippingDrawing() const { return skip_drawing; }
+    // The last finished frame once VBlank starts, GetOutputWidth() pixels per row
+    [[nodiscard]] const uint32_t* GetFramebuffer() const { return memory->framebuffer; }
+    [[nodiscard]] uint32_t GetOutputWidth() const { return output_width; }
+    [[nodiscard]] uint32_t GetOutputHeight() const { return output_height; }
 };
 
 #endif //PPU_H
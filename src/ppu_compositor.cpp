@@ -0,0 +1,223 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+// Last stage of a line: picks the front pixel of each screen from the layer line buffers,
+// then applies the color window, color math and master brightness. Lines without color math
+// come straight from the host palette; blended colors go through the brightness table.
+// Each step is a straight loop over the line so compilers can vectorize it, and steps that
+// the current registers make no-ops are skipped.
+
+#include "ppu.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace {
+
+// Layer ids in the compositor's per-pixel layer buffers. CGADSUB/TMW/TSW use the same bit order.
+constexpr uint8_t kOBJ = 4;
+constexpr uint8_t kBackdrop = 5;
+constexpr uint8_t kOBJLowPalette = 6;    // OBJ palettes 0-3, which never take part in color math
+
+struct LayerPass {
+    uint8_t layer;
+    uint8_t priority;
+};
+
+struct LayerOrder {
+    uint8_t count;
+    LayerPass passes[12];
+};
+
+// Per BG mode, back to front. Index 8 is mode 1 with the BG3 priority bit set.
+constexpr LayerOrder kLayerOrders[9] = {
+    {12, {{3, 0}, {2, 0}, {4, 0}, {3, 1}, {2, 1}, {4, 1}, {1, 0}, {0, 0}, {4, 2}, {1, 1}, {0, 1}, {4, 3}}},
+    {10, {{2, 0}, {4, 0}, {2, 1}, {4, 1}, {1, 0}, {0, 0}, {4, 2}, {1, 1}, {0, 1}, {4, 3}}},
+    {8, {{1, 0}, {4, 0}, {0, 0}, {4, 1}, {1, 1}, {4, 2}, {0, 1}, {4, 3}}},
+    {8, {{1, 0}, {4, 0}, {0, 0}, {4, 1}, {1, 1}, {4, 2}, {0, 1}, {4, 3}}},
+    {8, {{1, 0}, {4, 0}, {0, 0}, {4, 1}, {1, 1}, {4, 2}, {0, 1}, {4, 3}}},
+    {8, {{1, 0}, {4, 0}, {0, 0}, {4, 1}, {1, 1}, {4, 2}, {0, 1}, {4, 3}}},
+    {6, {{4, 0}, {0, 0}, {4, 1}, {4, 2}, {0, 1}, {4, 3}}},
+    {5, {{4, 0}, {0, 0}, {4, 1}, {4, 2}, {4, 3}}},
+    {10, {{2, 0}, {4, 0}, {4, 1}, {1, 0}, {0, 0}, {4, 2}, {1, 1}, {0, 1}, {4, 3}, {2, 1}}},
+};
+
+constexpr uint8_t kNoWindow[PPU::kScreenWidth] = {};
+
+} // namespace
+
+// W12SEL/W34SEL/WOBJSEL give each layer 4 bits: window 1 invert/enable, window 2 invert/enable.
+// With both windows enabled, WBGLOG/WOBJLOG combine them with OR, AND, XOR or XNOR.
+// TMW/TSW at the end of Windows don't change the shapes, so they're left out of the comparison.
+void PPU::UpdateWindowMasks(const Windows& windows, LineBuffers& buffers) {
+    if (buffers.window_masks_valid &&
+        std::memcmp(&buffers.window_source, &windows, offsetof(Windows, main_mask)) == 0) {
+        return;
+    }
+
+    uint8_t inside[2][kScreenWidth];
+    for (uint32_t window = 0; window < 2; window++) {
+        const uint8_t left = windows.left[window], right = windows.right[window];
+        for (uint32_t x = 0; x < kScreenWidth; x++) {
+            inside[window][x] = x >= left && x <= right ? 0xFF : 0x00;
+        }
+    }
+
+    for (uint32_t layer = 0; layer < 6; layer++) {
+        const uint8_t settings = (windows.settings[layer / 2] >> ((layer & 1) * 4)) & 0x0F;
+        const uint8_t logic = (windows.logic[layer / 4] >> ((layer % 4) * 2)) & 3;
+        const bool enable1 = settings & 0x02, enable2 = settings & 0x08;
+        const uint8_t invert1 = settings & 0x01 ? 0xFF : 0x00, invert2 = settings & 0x04 ? 0xFF : 0x00;
+        uint8_t* mask = buffers.window_masks[layer];
+
+        if (!enable1 && !enable2) {
+            std::fill(mask, mask + kScreenWidth, 0);
+        } else if (!enable2) {
+            for (uint32_t x = 0; x < kScreenWidth; x++) mask[x] = inside[0][x] ^ invert1;
+        } else if (!enable1) {
+            for (uint32_t x = 0; x < kScreenWidth; x++) mask[x] = inside[1][x] ^ invert2;
+        } else {
+            for (uint32_t x = 0; x < kScreenWidth; x++) {
+                const uint8_t w1 = inside[0][x] ^ invert1, w2 = inside[1][x] ^ invert2;
+                switch (logic) {
+                    case 0: mask[x] = w1 | w2; break;
+                    case 1: mask[x] = w1 & w2; break;
+                    case 2: mask[x] = w1 ^ w2; break;
+                    default: mask[x] = ~(w1 ^ w2); break;
+                }
+            }
+        }
+    }
+    buffers.window_source = windows;
+    buffers.window_masks_valid = true;
+}
+
+// Painter's algorithm over the mode's layer order: each pass overwrites the pixels its layer
+// and priority own, unless the layer's window masks them on this screen
+void PPU::ResolveScreen(const LineState& state, const LineBuffers& buffers, const uint8_t layers,
+                        const uint8_t windowed_layers, uint8_t* color, uint8_t* layer) {
+    std::fill(color, color + kScreenWidth, 0);
+    std::fill(layer, layer + kScreenWidth, kBackdrop);
+
+    const uint8_t mode = state.bg_mode & 7;
+    const LayerOrder& order = kLayerOrders[mode == 1 && (state.bg_mode & 0x08) ? 8 : mode];
+    for (uint32_t i = 0; i < order.count; i++) {
+        const auto [id, pass_priority] = order.passes[i];
+        if (!(layers & (1 << id))) continue;
+
+        const bool obj = id == kOBJ;
+        const uint8_t* source = obj ? buffers.obj_color : buffers.bg_color[id];
+        const uint8_t* priority = obj ? buffers.obj_priority : buffers.bg_priority[id];
+        const uint8_t* mask = windowed_layers & (1 << id) ? buffers.window_masks[id] : kNoWindow;
+        const uint8_t low_palette_id = obj ? kOBJLowPalette : id;
+        // Blends with a byte mask rather than ?: so the loop has no branches to stop vectorization
+        for (uint32_t x = 0; x < kScreenWidth; x++) {
+            const uint8_t pixel = source[x];
+            const uint8_t shown = -static_cast<uint8_t>((pixel != 0) & (priority[x] == pass_priority) & (mask[x] == 0));
+            const uint8_t shown_id = pixel < 0xC0 ? low_palette_id : id;
+            color[x] = (pixel & shown) | (color[x] & ~shown);
+            layer[x] = (shown_id & shown) | (layer[x] & ~shown);
+        }
+    }
+}
+
+void PPU::Composite(const LineState& state, LineBuffers& buffers, const uint8_t rendered_layers, uint32_t* out) {
+    const Windows& windows = state.windows;
+    const uint8_t* cgram = state.cgram;
+    const uint8_t brightness = state.brightness;
+    const uint16_t fixed_color = state.fixed_color;
+
+    // CGWSEL regions: nowhere, outside the color window, inside it, everywhere
+    const uint8_t clip_region = state.color_math_control >> 6;
+    const uint8_t prevent_region = (state.color_math_control >> 4) & 3;
+    const uint8_t math_layers = state.color_math_layers & 0x3F;
+    const bool math = math_layers && prevent_region != 3;
+    const bool sub_screen = math && (state.color_math_control & 0x02);
+
+    const auto partial = [](const uint8_t region) { return region == 1 || region == 2; };
+    const bool windowed = ((windows.main_mask | (sub_screen ? windows.sub_mask : 0)) & rendered_layers) ||
+                          partial(clip_region) || (math && partial(prevent_region));
+    if (windowed) UpdateWindowMasks(windows, buffers);
+
+    uint8_t main_color[kScreenWidth], main_layer[kScreenWidth];
+    ResolveScreen(state, buffers, state.main_screen_layers & rendered_layers, windows.main_mask, main_color,
+                  main_layer);
+
+    if (!math && !clip_region) {
+        for (uint32_t x = 0; x < kScreenWidth; x++) out[x] = state.palette[main_color[x]];
+        return;
+    }
+
+    // 0xFF where a CGWSEL region applies
+    const auto fill_region = [&buffers](const uint8_t region, uint8_t* out_mask) {
+        const uint8_t* color_window = buffers.window_masks[5];
+        switch (region) {
+            case 0: std::fill(out_mask, out_mask + kScreenWidth, 0x00); break;
+            case 1: for (uint32_t x = 0; x < kScreenWidth; x++) out_mask[x] = ~color_window[x]; break;
+            case 2: std::copy(color_window, color_window + kScreenWidth, out_mask); break;
+            default: std::fill(out_mask, out_mask + kScreenWidth, 0xFF); break;
+        }
+    };
+
+    uint16_t main[kScreenWidth];
+    for (uint32_t x = 0; x < kScreenWidth; x++) main[x] = CGRAMColor(cgram, main_color[x]);
+    if (clip_region) {
+        uint8_t clip[kScreenWidth];
+        fill_region(clip_region, clip);
+        for (uint32_t x = 0; x < kScreenWidth; x++) main[x] = clip[x] ? 0 : main[x];
+    }
+
+    if (math) {
+        // The addend is the sub screen, or the fixed color where the sub screen shows its backdrop.
+        // Halving is skipped for those backdrop pixels.
+        const bool half = state.color_math_layers & 0x40;
+        uint16_t sub[kScreenWidth];
+        uint8_t halve[kScreenWidth];
+        if (sub_screen) {
+            uint8_t sub_color[kScreenWidth], sub_layer[kScreenWidth];
+            ResolveScreen(state, buffers, state.sub_screen_layers & rendered_layers, windows.sub_mask, sub_color,
+                          sub_layer);
+            for (uint32_t x = 0; x < kScreenWidth; x++) {
+                const bool backdrop = sub_layer[x] == kBackdrop;
+                sub[x] = backdrop ? fixed_color : CGRAMColor(cgram, sub_color[x]);
+                halve[x] = half && !backdrop;
+            }
+        } else {
+            std::fill(sub, sub + kScreenWidth, fixed_color);
+            std::fill(halve, halve + kScreenWidth, half);
+        }
+
+        uint8_t apply[kScreenWidth];
+        fill_region(prevent_region, apply);
+        for (uint32_t x = 0; x < kScreenWidth; x++) {
+            apply[x] = !apply[x] && ((math_layers >> main_layer[x]) & 1);
+        }
+
+        const bool subtract = state.color_math_layers & 0x80;
+        for (uint32_t x = 0; x < kScreenWidth; x++) {
+            const int32_t m = main[x], s = sub[x];
+            int32_t channels[3];
+            for (uint32_t c = 0; c < 3; c++) {
+                const int32_t a = (m >> (c * 5)) & 0x1F, b = (s >> (c * 5)) & 0x1F;
+                const int32_t v = subtract ? std::max(a - b, 0) : a + b;
+                channels[c] = halve[x] ? v >> 1 : std::min(v, 31);
+            }
+            const uint16_t blended = static_cast<uint16_t>(channels[0] | (channels[1] << 5) | (channels[2] << 10));
+            main[x] = apply[x] ? blended : main[x];
+        }
+    }
+
+    for (uint32_t x = 0; x < kScreenWidth; x++) out[x] = ToHostColor(main[x], brightness);
+}
+
+// Hi-res sub screen dots go out as they are, with the main backdrop color behind them
+void PPU::CompositeSubScreen(const LineState& state, LineBuffers& buffers, const uint8_t rendered_layers,
+                             uint32_t* out) {
+    const Windows& windows = state.windows;
+    if (windows.sub_mask & rendered_layers) UpdateWindowMasks(windows, buffers);
+    uint8_t sub_color[kScreenWidth], sub_layer[kScreenWidth];
+    ResolveScreen(state, buffers, state.sub_screen_layers & rendered_layers, windows.sub_mask, sub_color, sub_layer);
+    for (uint32_t x = 0; x < kScreenWidth; x++) out[x] = state.palette[sub_color[x]];
+}
@@ -0,0 +1,79 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+// Mode 7: BG1 as a 1024x1024 affine-transformed plane
+
+#include "ppu.h"
+
+#include <algorithm>
+
+namespace {
+
+// Pixels transformed per batch. The coordinate loop is plain fixed-length integer math with no
+// branches so compilers turn it into SIMD; the VRAM lookups after it stay scalar.
+constexpr uint32_t kMode7Batch = 16;
+
+// 13-bit scroll/center differences wrap into 10 bits, keeping the sign
+int32_t Clip(const int32_t n) {
+    return n & 0x2000 ? (n | ~0x3FF) : (n & 0x3FF);
+}
+
+} // namespace
+
+void PPU::RenderMode7(const LineState& state, LineBuffers& buffers) {
+    const Mode7& mode7 = state.mode7;
+    const uint8_t* vram = state.vram;
+    uint8_t* out = buffers.bg_color[0];
+    std::fill(buffers.bg_priority[0], buffers.bg_priority[0] + kScreenWidth, 0);
+    const int32_t line = state.line;
+    const int32_t a = mode7.a, b = mode7.b, c = mode7.c, d = mode7.d;
+    const int32_t center_x = mode7.center_x, center_y = mode7.center_y;
+    const int32_t y = mode7.settings & 0x02 ? 255 - line : line;
+
+    // Transform the start of the line once (with the hardware's truncation), then step by A/C per pixel
+    const int32_t dx = Clip(mode7.h_offset - center_x);
+    const int32_t dy = Clip(mode7.v_offset - center_y);
+    int32_t start_x = ((a * dx) & ~63) + ((b * dy) & ~63) + ((b * y) & ~63) + center_x * 256;
+    int32_t start_y = ((c * dx) & ~63) + ((d * dy) & ~63) + ((d * y) & ~63) + center_y * 256;
+    int32_t step_x = a, step_y = c;
+    if (mode7.settings & 0x01) {
+        start_x += 255 * a;
+        start_y += 255 * c;
+        step_x = -a;
+        step_y = -c;
+    }
+
+    int32_t lane_x[kMode7Batch], lane_y[kMode7Batch];
+    for (uint32_t i = 0; i < kMode7Batch; i++) {
+        lane_x[i] = step_x * static_cast<int32_t>(i);
+        lane_y[i] = step_y * static_cast<int32_t>(i);
+    }
+
+    // M7SEL bits 6-7: wrap around the plane, or outside it be transparent or repeat character 0
+    const uint8_t fill = mode7.settings >> 6;
+    const bool transparent_outside = fill == 2;
+    const bool tile_zero_outside = fill == 3;
+
+    // VRAM words: the tilemap is in the low bytes, 8bpp character pixels in the high bytes
+    for (uint32_t x = 0; x < kScreenWidth; x += kMode7Batch) {
+        uint16_t map_address[kMode7Batch];
+        uint8_t pixel[kMode7Batch];
+        uint8_t outside[kMode7Batch];
+        for (uint32_t i = 0; i < kMode7Batch; i++) {
+            const int32_t px = (start_x + lane_x[i]) >> 8;
+            const int32_t py = (start_y + lane_y[i]) >> 8;
+            outside[i] = ((px | py) & ~0x3FF) != 0;
+            map_address[i] = static_cast<uint16_t>((((py >> 3) & 0x7F) << 8) | (((px >> 3) & 0x7F) << 1));
+            pixel[i] = static_cast<uint8_t>(((py & 7) << 3) | (px & 7));
+        }
+        start_x += step_x * static_cast<int32_t>(kMode7Batch);
+        start_y += step_y * static_cast<int32_t>(kMode7Batch);
+
+        for (uint32_t i = 0; i < kMode7Batch; i++) {
+            const uint8_t tile = tile_zero_outside && outside[i] ? 0 : vram[map_address[i]];
+            const uint8_t color = vram[((tile << 6 | pixel[i]) << 1) | 1];
+            out[x + i] = transparent_outside && outside[i] ? 0 : color;
+        }
+    }
+}
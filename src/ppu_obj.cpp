@@ -0,0 +1,134 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+// OBJ (sprite) evaluation and rasterization
+
+#include "ppu.h"
+
+#include <algorithm>
+
+namespace {
+
+struct ObjSize {
+    int32_t width;
+    int32_t height;
+};
+
+// OBSEL size select: {small, large}. 6 and 7 are the undocumented rectangular sizes.
+constexpr ObjSize kObjSizes[8][2] = {
+    {{8, 8}, {16, 16}},   {{8, 8}, {32, 32}},   {{8, 8}, {64, 64}},   {{16, 16}, {32, 32}},
+    {{16, 16}, {64, 64}}, {{32, 32}, {64, 64}}, {{16, 32}, {32, 64}}, {{16, 32}, {32, 32}},
+};
+
+} // namespace
+
+// Range pass then time pass, the way the PPU does it on each line: the first 32 sprites in
+// priority order that touch the line are kept, then their tiles are fetched starting from the
+// last one, up to 34 tiles
+void PPU::EvaluateObjects(const uint32_t first_line) {
+    struct Sprite {
+        int32_t x;
+        ObjSize size;
+    };
+    Sprite sprites[128];
+    for (uint32_t sprite = 0; sprite < 128; sprite++) {
+        const uint8_t high = memory->oam[0x200 + sprite / 4] >> ((sprite & 3) * 2);
+        const int32_t x = memory->oam[sprite * 4] | ((high & 1) << 8);
+        sprites[sprite] = {x >= 256 ? x - 512 : x, kObjSizes[obj_select >> 5][(high >> 1) & 1]};
+    }
+
+    uint8_t line_sprites[kMaxScreenHeight][kMaxLineSprites];
+    uint8_t line_counts[kMaxScreenHeight] = {};
+    for (uint32_t line = first_line; line < kMaxScreenHeight; line++) {
+        memory->obj_lines[line].range_over = false;
+    }
+
+    const uint8_t first = FirstObject();
+    for (uint32_t i = 0; i < 128; i++) {
+        const uint8_t sprite = (first + i) & 0x7F;
+        const auto [x, size] = sprites[sprite];
+        if (x + size.width <= 0) continue;
+
+        const uint8_t y = memory->oam[sprite * 4 + 1];
+        for (int32_t row = 0; row < size.height; row++) {
+            // Sprites wrap from the bottom of the 256-line space back to the top
+            const uint32_t line = (y + row) & 0xFF;
+            if (line < first_line || line >= kMaxScreenHeight) continue;
+            if (line_counts[line] == kMaxLineSprites) {
+                memory->obj_lines[line].range_over = true;
+            } else {
+                line_sprites[line][line_counts[line]++] = sprite;
+            }
+        }
+    }
+
+    const uint32_t name_base = (obj_select & 7) << 14;
+    const uint32_t name_gap = (((obj_select >> 3) & 3) + 1) << 13;
+    for (uint32_t line = first_line; line < kMaxScreenHeight; line++) {
+        ObjLine& result = memory->obj_lines[line];
+        result.tile_count = 0;
+        result.time_over = false;
+
+        for (int32_t i = line_counts[line] - 1; i >= 0 && !result.time_over; i--) {
+            const uint8_t sprite = line_sprites[line][i];
+            const auto [x, size] = sprites[sprite];
+            const uint8_t* entry = memory->oam + sprite * 4;
+            const uint8_t attributes = entry[3];
+
+            uint32_t row = (line - entry[1]) & 0xFF;
+            if (attributes & 0x80) row = size.height - 1 - row;
+            const uint32_t columns = size.width / 8;
+            const uint32_t table = name_base + (attributes & 0x01 ? name_gap : 0);
+
+            for (uint32_t column = 0; column < columns; column++) {
+                const int32_t tile_x = x + static_cast<int32_t>(column) * 8;
+                if (tile_x <= -8 || tile_x >= static_cast<int32_t>(kScreenWidth)) continue;
+                if (result.tile_count == kMaxLineTiles) {
+                    result.time_over = true;
+                    break;
+                }
+
+                // Characters are laid out on a 16x16 grid, and large sprites wrap within it
+                const uint32_t tile_column = attributes & 0x40 ? columns - 1 - column : column;
+                const uint32_t character = ((((entry[2] >> 4) + row / 8) & 0x0F) << 4) |
+                                           ((entry[2] + tile_column) & 0x0F);
+                result.tiles[result.tile_count++] = {
+                    static_cast<int16_t>(tile_x),
+                    static_cast<uint16_t>((table + character * 32 + (row & 7) * 2) & 0xFFFF),
+                    attributes,
+                    0,
+                };
+            }
+        }
+    }
+    obj_valid_from = first_line;
+}
+
+void PPU::RenderObjects(const LineState& state, LineBuffers& buffers) {
+    uint8_t* obj_color = buffers.obj_color;
+    uint8_t* obj_priority = buffers.obj_priority;
+    std::fill(obj_color, obj_color + kScreenWidth, 0);
+
+    const ObjLine& sprites = *state.sprites;
+    for (uint32_t i = 0; i < sprites.tile_count; i++) {
+        const ObjTile& tile = sprites.tiles[i];
+        // 4bpp: planes 0/1 interleaved in the first 16 bytes of the tile, 2/3 in the next 16
+        const uint8_t* planes = state.vram + tile.address;
+        const uint32_t p0 = planes[0], p1 = planes[1], p2 = planes[16], p3 = planes[17];
+        const uint8_t palette = 0x80 | ((tile.attributes & 0x0E) << 3);
+        const uint8_t priority = (tile.attributes >> 4) & 3;
+        const bool flip = tile.attributes & 0x40;
+
+        for (int32_t pixel = 0; pixel < 8; pixel++) {
+            const int32_t x = tile.x + pixel;
+            if (x < 0 || x >= static_cast<int32_t>(kScreenWidth)) continue;
+            const uint32_t bit = flip ? pixel : 7 - pixel;
+            const uint8_t color = ((p0 >> bit) & 1) | (((p1 >> bit) & 1) << 1) | (((p2 >> bit) & 1) << 2) |
+                                  (((p3 >> bit) & 1) << 3);
+            if (!color) continue;
+            obj_color[x] = palette | color;
+            obj_priority[x] = priority;
+        }
+    }
+}
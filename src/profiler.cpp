@@ -0,0 +1,72 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#include "profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <vector>
+
+#include "opcodes.h"
+
+void Profiler::Clear() {
+    opcodes.fill({});
+    pages.fill({});
+}
+
+void Profiler::Report(std::ostream& out, const size_t max_opcodes, const size_t max_pages) const {
+    uint64_t total_count = 0;
+    uint64_t total_cycles = 0;
+    uint64_t total_idle = 0;
+    for (const OpcodeStats& stats : opcodes) {
+        total_count += stats.count;
+        total_cycles += stats.cycles;
+    }
+    for (const PageStats& stats : pages) total_idle += stats.idle_cycles;
+
+    char line[128];
+    std::snprintf(line, sizeof(line), "Profile: %llu instructions, %llu cycles executed, %llu cycles idle\n",
+                  static_cast<unsigned long long>(total_count), static_cast<unsigned long long>(total_cycles),
+                  static_cast<unsigned long long>(total_idle));
+    out << line;
+    if (total_count == 0 && total_idle == 0) return;
+
+    std::vector<int> order(256);
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::sort(order, [this](const int a, const int b) { return opcodes[a].cycles > opcodes[b].cycles; });
+
+    out << "\n  op  instruction                     count        cycles   cyc%  avg\n";
+    for (size_t i = 0; i < std::min<size_t>(max_opcodes, order.size()); i++) {
+        const OpcodeStats& stats = opcodes[order[i]];
+        if (stats.count == 0) break;
+        const OpcodeInfo& info = kOpcodeTable[order[i]];
+        std::snprintf(line, sizeof(line), "  %02X  %s %-27s %12llu %13llu %5.1f%% %5.2f\n", order[i], info.mnemonic,
+                      AddressingModeName(info.mode), static_cast<unsigned long long>(stats.count),
+                      static_cast<unsigned long long>(stats.cycles), 100.0 * stats.cycles / total_cycles,
+                      static_cast<double>(stats.cycles) / stats.count);
+        out << line;
+    }
+
+    // Pages rank by executed plus idle time, so spin loops show up even when skipped
+    std::vector<uint32_t> hot;
+    for (uint32_t page = 0; page < pages.size(); page++) {
+        if (pages[page].count || pages[page].idle_cycles) hot.push_back(page);
+    }
+    const auto time = [this](const uint32_t page) { return pages[page].cycles + pages[page].idle_cycles; };
+    const size_t shown = std::min(max_pages, hot.size());
+    std::partial_sort(hot.begin(), hot.begin() + shown, hot.end(),
+                      [&time](const uint32_t a, const uint32_t b) { return time(a) > time(b); });
+
+    out << "\n  page          count        cycles   idle cycles  time%\n";
+    for (size_t i = 0; i < shown; i++) {
+        const PageStats& stats = pages[hot[i]];
+        std::snprintf(line, sizeof(line), "  %02X:%02Xxx %12llu %13llu %13llu %5.1f%%\n", hot[i] >> 8, hot[i] & 0xFF,
+                      static_cast<unsigned long long>(stats.count), static_cast<unsigned long long>(stats.cycles),
+                      static_cast<unsigned long long>(stats.idle_cycles),
+                      100.0 * time(hot[i]) / (total_cycles + total_idle));
+        out << line;
+    }
+    out.flush();
+}
@@ -0,0 +1,49 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#ifndef PROFILER_H
+#define PROFILER_H
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// Counts where the CPU spends its time: executions and cycles for each opcode, and for
+// each 256-byte bank:page of code
+class Profiler {
+public:
+    struct OpcodeStats {
+        uint64_t count = 0;
+        uint64_t cycles = 0;
+    };
+
+    struct PageStats {
+        uint64_t count = 0;
+        uint64_t cycles = 0;
+        uint64_t idle_cycles = 0;   // Skipped while halted or spinning in a detected idle loop
+    };
+
+    void RecordInstruction(const uint8_t opcode, const uint32_t pc, const uint64_t elapsed) {
+        opcodes[opcode].count++;
+        opcodes[opcode].cycles += elapsed;
+        PageStats& page = pages[(pc >> 8) & 0xFFFF];
+        page.count++;
+        page.cycles += elapsed;
+    }
+
+    void RecordIdle(const uint32_t pc, const uint64_t elapsed) {
+        pages[(pc >> 8) & 0xFFFF].idle_cycles += elapsed;
+    }
+
+    void Clear();
+
+    // Opcodes sorted by cycles, then the hottest pages
+    void Report(std::ostream& out, size_t max_opcodes = 64, size_t max_pages = 32) const;
+
+private:
+    std::array<OpcodeStats, 256> opcodes{};
+    std::array<PageStats, 0x10000> pages{};     // Indexed by bank << 8 | page
+};
+
+#endif //PROFILER_H
@@ -0,0 +1,66 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#ifndef SAVE_STATE_H
+#define SAVE_STATE_H
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// Save states are the components' fields appended one after another in a fixed order, and read
+// back in the same order. Values are stored as raw host bytes, so states only load on the same
+// kind of host and with the same kVersion.
+class StateWriter {
+    std::vector<uint8_t>& data;
+
+public:
+    explicit StateWriter(std::vector<uint8_t>& out) : data(out) {}
+
+    void WriteBytes(const void* bytes, const size_t size) {
+        if (size == 0) return;
+        const size_t offset = data.size();
+        data.resize(offset + size);
+        std::memcpy(data.data() + offset, bytes, size);
+    }
+
+    template <typename T>
+    void Write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        WriteBytes(&value, sizeof(T));
+    }
+};
+
+class StateReader {
+    const uint8_t* data;
+    size_t size;
+    size_t position = 0;
+    bool failed = false;
+
+public:
+    StateReader(const uint8_t* bytes, const size_t length) : data(bytes), size(length) {}
+
+    // Past the end of the state, reads leave `out` alone and mark the reader as failed
+    void ReadBytes(void* out, const size_t length) {
+        if (length == 0) return;
+        if (failed || length > size - position) {
+            failed = true;
+            return;
+        }
+        std::memcpy(out, data + position, length);
+        position += length;
+    }
+
+    template <typename T>
+    void Read(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        ReadBytes(&value, sizeof(T));
+    }
+
+    [[nodiscard]] bool Failed() const { return failed; }
+    [[nodiscard]] bool AtEnd() const { return position == size; }
+};
+
+#endif //SAVE_STATE_H
@@ -0,0 +1,116 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Timed callbacks on the master clock. Components register a handler once and then
+// (re)schedule it; each handler is pending at most once, so scheduling it again moves it.
+// The earliest pending time is cached, and a listener hears about every change to it so
+// the CPU can run free until that point.
+class Scheduler {
+public:
+    using EventId = uint32_t;
+    using Handler = std::function<void(uint64_t time)>;    // Called with the time the event was due
+    static constexpr uint64_t kNever = UINT64_MAX;
+
+    EventId Register(Handler handler) {
+        handlers.push_back(std::move(handler));
+        generations.push_back(0);
+        return static_cast<EventId>(handlers.size() - 1);
+    }
+
+    void SetNextTimeListener(std::function<void(uint64_t next_time)> listener) {
+        next_time_listener = std::move(listener);
+        next_time_listener(next_time);
+    }
+
+    void Schedule(const EventId id, const uint64_t time) {
+        heap.push_back({time, ++generations[id], id});
+        std::ranges::push_heap(heap, std::greater{});
+        Update();
+    }
+
+    void Cancel(const EventId id) {
+        generations[id]++;
+        Update();
+    }
+
+    // Drops every pending event; registrations stay
+    void CancelAll() {
+        heap.clear();
+        for (uint32_t& generation : generations) {
+            generation++;
+        }
+        Update();
+    }
+
+    [[nodiscard]] uint64_t NextTime() const { return next_time; }
+
+    // When an event is due, or kNever if it isn't pending
+    [[nodiscard]] uint64_t PendingTime(const EventId id) const {
+        for (const Entry& entry : heap) {
+            if (entry.id == id && entry.generation == generations[id]) return entry.time;
+        }
+        return kNever;
+    }
+
+    // Puts an event back at a time PendingTime reported
+    void Restore(const EventId id, const uint64_t time) {
+        if (time == kNever) {
+            Cancel(id);
+        } else {
+            Schedule(id, time);
+        }
+    }
+
+    // Runs every handler due by `now` in time order, including ones they schedule
+    void RunDue(const uint64_t now) {
+        while (next_time <= now) {
+            const Entry entry = heap.front();
+            std::ranges::pop_heap(heap, std::greater{});
+            heap.pop_back();
+            generations[entry.id]++;
+            Update();
+
+            handlers[entry.id](entry.time);
+        }
+    }
+
+private:
+    struct Entry {
+        uint64_t time;
+        uint32_t generation;
+        EventId id;
+
+        bool operator>(const Entry& other) const { return time > other.time; }
+    };
+
+    std::vector<Entry> heap;
+    std::vector<Handler> handlers;
+    std::vector<uint32_t> generations;
+    uint64_t next_time = kNever;
+    std::function<void(uint64_t)> next_time_listener;
+
+    // Drops cancelled/rescheduled entries off the top and refreshes the cached next time
+    void Update() {
+        while (!heap.empty() && heap.front().generation != generations[heap.front().id]) {
+            std::ranges::pop_heap(heap, std::greater{});
+            heap.pop_back();
+        }
+
+        const uint64_t time = heap.empty() ? kNever : heap.front().time;
+        if (time != next_time) {
+            next_time = time;
+            if (next_time_listener) next_time_listener(next_time);
+        }
+    }
+};
+
+#endif //SCHEDULER_H
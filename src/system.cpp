@@ -2,18 +2,35 @@
 // Created by Palindromic Bread Loaf on 7/21/25.
 //
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <utility>
 
 #include "bus.h"
 #include "system.h"
 
+namespace {
+
+constexpr uint32_t kStateMagic = 0x54534253;    // "BSST"
+constexpr uint32_t kStateVersion = 1;
+
+} // namespace
+
 // SNES System Implementation
-System::System() : running(false) {
-    bus = std::make_unique<Bus>(&cartridge_data);
-    cpu = std::make_unique<CPU>(bus.get());
-    ppu = std::make_unique<PPU>();
-    apu = std::make_unique<APU>();
+System::System() {
+    bus.ConnectInterrupts(&interrupts);
+    bus.ConnectPPU(&ppu);
+    bus.ConnectControllers(&controllers);
+
+    scanline_event = scheduler.Register([this](const uint64_t time) { OnScanline(time); });
+    apu_sync_event = scheduler.Register([this](const uint64_t time) { OnAPUSync(time); });
+
+    // The CPU runs free until the earliest pending event
+    scheduler.SetNextTimeListener([this](const uint64_t next_time) {
+        cpu.SetCycleDeadline(next_time == Scheduler::kNever ? UINT64_MAX : cpu_cycle_base + ToCPUCycles(next_time));
+    });
+    ResetTiming();
 }
 
 System::~System() {
@@ -38,30 +55,303 @@ bool System::LoadROM(const std::string& filename) {
     return true;
 }
 
+void System::LoadROM(std::vector<uint8_t> data) {
+    cartridge_data = std::move(data);
+}
+
 void System::Reset() {
-    cpu->Reset();
-    ppu->Reset();
-    apu->Reset();
+    cpu.Reset();
+    ppu.Reset();
+    apu.Reset();
+    controllers.Reset();
+    ResetTiming();
+    movie_frame_open = false;
+}
+
+void System::PowerOn() {
+    bus.ClearMemory();
+    Reset();
+}
+
+void System::ResetTiming() {
+    cpu_cycle_base = cpu.GetCycles();
+    ppu_dots = 0;
+
+    scheduler.CancelAll();
+    interrupts.Reset();
+    scheduler.Schedule(scanline_event, 0);
+    scheduler.Schedule(apu_sync_event, kAPUSyncMasterCycles);
 }
 
 void System::Step() {
-    cpu->Step();
-    ppu->Step();
-    apu->Step();
+    if (cpu.IsIdle()) {
+        // Nothing can change until the next event, so jump straight to it
+        const uint64_t now = MasterNow();
+        uint64_t target = scheduler.NextTime();
+        if (interrupts.TakeHBlankPolled()) {
+            // From the start of the loop's last iteration, which may have read the flag before an edge
+            const uint64_t loop_start = now - cpu.GetIdleLoopCycles() * kMasterCyclesPerCPUCycle;
+            target = std::min(target, std::max(InterruptController::NextHBlankEdge(loop_start), now));
+        }
+        cpu.SkipIdleCycles(ToCPUCycles(target - now));
+    } else {
+        cpu.Run();
+    }
+
+    scheduler.RunDue(MasterNow());
+}
+
+// Start of every scanline: catch the PPU up, draw the line with the registers as they are now
+// and raise the VBlank/frame signals
+void System::OnScanline(const uint64_t time) {
+    SyncPPU();
+
+    const uint64_t line = time / kScanlineMasterCycles % PPU::kScanlinesPerFrame;
+    const uint16_t vblank_line = ppu.VBlankScanline();
+    if (line > 0 && line < vblank_line) {
+        ppu.RenderScanline(static_cast<uint16_t>(line));
+    } else if (line == vblank_line) {
+        ppu.OnVBlankStart();
+        interrupts.OnVBlankStart();
+        // Pads are latched here rather than at frame start, so input is as fresh as it can be
+        if (interrupts.IsAutoJoypadEnabled()) {
+            controllers.OnAutoJoypadRead();
+            interrupts.OnAutoJoypadRead(time);
+        }
+    } else if (line == 0) {
+        ppu.OnFrameStart();
+        interrupts.OnFrameEnd();
+
+        frame_drawn = !ppu.IsSkippingDrawing();
+        const bool skip = frames_until_drawn > 0;
+        frames_until_drawn = skip ? frames_until_drawn - 1 : frame_skip;
+        ppu.SetSkipDrawing(skip);
+
+        OnMovieFrame();
+    }
+
+    scheduler.Schedule(scanline_event, time + kScanlineMasterCycles);
+}
+
+void System::OnAPUSync(const uint64_t time) {
+    // TODO: Run the SPC700 up to `time` once it executes instructions
+    apu.Step();
+    scheduler.Schedule(apu_sync_event, time + kAPUSyncMasterCycles);
+}
+
+// Catches the PPU up to the current master time
+void System::SyncPPU() {
+    const uint64_t due = MasterNow() / PPU::kMasterCyclesPerDot - ppu_dots;
+    ppu.Advance(static_cast<uint32_t>(due));
+    ppu_dots += due;
+}
+
+// Line 0 ends one movie frame and starts the next
+void System::OnMovieFrame() {
+    if (movie_frame_open && movie_mode == MovieMode::Recording) {
+        movie.frames.push_back(controllers.TakeFrameInput());
+        movie.frame_hashes.push_back(frame_drawn ? GetFrameHash() : 0);
+        movie_frame++;
+    } else if (movie_frame_open && movie_mode == MovieMode::Playing) {
+        if (!movie_mismatch && frame_drawn && movie_frame < movie.frame_hashes.size() &&
+            movie.frame_hashes[movie_frame] && movie.frame_hashes[movie_frame] != GetFrameHash()) {
+            movie_mismatch = movie_frame;
+        }
+        movie_frame++;
+    }
+
+    controllers.BeginFrame();
+    movie_frame_open = true;
+    if (movie_mode == MovieMode::Playing) ApplyMovieInput();
+}
+
+void System::ApplyMovieInput() {
+    if (movie_frame < movie.frames.size()) {
+        controllers.SetFrameInput(movie.frames[movie_frame]);
+    } else {
+        movie_mode = MovieMode::None;
+    }
+}
+
+void System::StartRecording(const Movie::Anchor anchor) {
+    movie = {};
+    movie.anchor = anchor;
+    if (anchor == Movie::Anchor::PowerOn) {
+        PowerOn();
+    } else {
+        // Playback loads this into the middle of a frame, so count the one in progress as the first
+        SaveState(movie.state);
+        movie_frame_open = true;
+    }
+    movie_mode = MovieMode::Recording;
+    movie_frame = 0;
+    movie_mismatch.reset();
+}
+
+bool System::StartPlayback(Movie played) {
+    StopMovie();
+    if (played.anchor == Movie::Anchor::PowerOn) {
+        PowerOn();
+    } else if (!LoadState(played.state.data(), played.state.size())) {
+        return false;
+    }
+
+    movie = std::move(played);
+    movie_mode = MovieMode::Playing;
+    movie_frame = 0;
+    movie_mismatch.reset();
+    // After a power-on the first frame starts at line 0; a state is already inside one
+    if (movie_frame_open) ApplyMovieInput();
+    return true;
+}
+
+// The frame in progress when recording stops isn't finished, so it isn't kept
+Movie System::StopMovie() {
+    movie_mode = MovieMode::None;
+    return std::exchange(movie, {});
+}
+
+uint64_t System::GetFrameHash() const {
+    const uint32_t width = GetFrameWidth(), height = GetFrameHeight();
+    const uint32_t* pixels = GetFramebuffer();
+    uint64_t hash = 0xCBF29CE484222325;
+    const auto mix = [&hash](const uint32_t value) {
+        hash ^= value;
+        hash *= 0x100000001B3;
+    };
+    mix(width);
+    mix(height);
+    for (uint32_t i = 0; i < width * height; i++) mix(pixels[i]);
+    return hash;
+}
+
+// Layout: header, CPU, system timing, bus, PPU, APU, pads, interrupts, pending system events
+void System::SaveState(std::vector<uint8_t>& out) const {
+    out.clear();
+    StateWriter writer(out);
+    writer.Write(kStateMagic);
+    writer.Write(kStateVersion);
+    writer.Write(static_cast<uint64_t>(cartridge_data.size()));
+
+    cpu.SaveState(writer);
+    writer.Write(cpu_cycle_base);
+    writer.Write(ppu_dots);
+    bus.SaveState(writer);
+    ppu.SaveState(writer);
+    apu.SaveState(writer);
+    controllers.SaveState(writer);
+    interrupts.SaveState(writer);
+    writer.Write(scheduler.PendingTime(scanline_event));
+    writer.Write(scheduler.PendingTime(apu_sync_event));
+}
+
+bool System::LoadState(const uint8_t* data, const size_t size) {
+    StateReader reader(data, size);
+    uint32_t magic = 0, version = 0;
+    uint64_t cartridge_size = 0;
+    reader.Read(magic);
+    reader.Read(version);
+    reader.Read(cartridge_size);
+    if (reader.Failed() || magic != kStateMagic || version != kStateVersion) {
+        std::cout << "Not a save state for this version" << std::endl;
+        return false;
+    }
+    if (cartridge_size != cartridge_data.size()) {
+        std::cout << "Save state is for a different ROM" << std::endl;
+        return false;
+    }
+
+    // A truncated state is only found partway through, so keep a way back
+    std::vector<uint8_t> previous;
+    SaveState(previous);
+
+    cpu.LoadState(reader);
+    reader.Read(cpu_cycle_base);
+    reader.Read(ppu_dots);
+    bus.LoadState(reader);
+    ppu.LoadState(reader);
+    apu.LoadState(reader);
+    controllers.LoadState(reader);
+    scheduler.CancelAll();
+    interrupts.LoadState(reader);
+    uint64_t scanline_time = Scheduler::kNever, apu_sync_time = Scheduler::kNever;
+    reader.Read(scanline_time);
+    reader.Read(apu_sync_time);
+
+    if (reader.Failed() || !reader.AtEnd()) {
+        LoadState(previous.data(), previous.size());
+        std::cout << "Save state is damaged" << std::endl;
+        return false;
+    }
+    scheduler.Restore(scanline_event, scanline_time);
+    scheduler.Restore(apu_sync_event, apu_sync_time);
+    movie_frame_open = true;
+    return true;
 }
 
 void System::Run() {
     running = true;
     while (running) {
-        Step();
+        RunFrame();
+        // TODO: Handle frame rendering and input
+    }
+}
 
-        if (ppu->IsFrameComplete()) {
-            ppu->SetFrameComplete(false);
-            // TODO: Handle frame rendering and input
-        }
+void System::RunFrame() {
+    while (!ppu.IsFrameComplete()) {
+        Step();
     }
+    ppu.SetFrameComplete(false);
 }
 
 void System::Shutdown() {
     running = false;
-}
\ No newline at end of file
+    StopTrace();
+    if (profiler) {
+        ReportProfile();
+#ifdef BREADEDSNES_PROFILE
+        cpu.SetProfiler(nullptr);
+#endif
+        profiler.reset();
+    }
+}
+
+bool System::StartTrace(const std::string& path) {
+#ifdef BREADEDSNES_TRACE
+    StopTrace();
+    tracer = std::make_unique<TraceWriter>();
+    if (!tracer->Start(path)) {
+        tracer.reset();
+        return false;
+    }
+    cpu.SetTracer(tracer.get());
+    return true;
+#else
+    (void)path;
+    std::cout << "Tracing isn't available, rebuild with -DBREADEDSNES_TRACE=ON" << std::endl;
+    return false;
+#endif
+}
+
+void System::StopTrace() {
+    if (!tracer) return;
+#ifdef BREADEDSNES_TRACE
+    cpu.SetTracer(nullptr);
+#endif
+    tracer.reset();
+}
+bool System::StartProfile() {
+#ifdef BREADEDSNES_PROFILE
+    if (!profiler) profiler = std::make_unique<Profiler>();
+    profiler->Clear();
+    cpu.SetProfiler(profiler.get());
+    return true;
+#else
+    std::cout << "Profiling isn't available, rebuild with -DBREADEDSNES_PROFILE=ON" << std::endl;
+    return false;
+#endif
+}
+
+void System::ReportProfile() const {
+    if (profiler) profiler->Report(std::cout);
+}
@@ -5,33 +5,152 @@
 #ifndef SYSTEM_H
 #define SYSTEM_H
 
+#include <algorithm>
 #include <memory>
+#include <optional>
 #include <string>
 #include "cpu.h"
 #include "ppu.h"
 #include "apu.h"
 #include "bus.h"
+#include "controllers.h"
+#include "interrupts.h"
+#include "memory_arena.h"
+#include "movie.h"
+#include "profiler.h"
+#include "scheduler.h"
+#include "trace.h"
 
 
 // Main SNES System class
 class System {
-    std::unique_ptr<CPU> cpu;
-    std::unique_ptr<PPU> ppu;
-    std::unique_ptr<APU> apu;
-    std::unique_ptr<Bus> bus;
-
     std::vector<uint8_t> cartridge_data;
-    bool running;
+
+    // The components live here, each starting on a cache line with its registers up front, while
+    // their RAM, VRAM and framebuffer share one arena allocation (see MemoryArena)
+    MemoryArena arena{MemoryArena::SizeFor<Bus::Memory, PPU::Memory, APU::Memory>()};
+    Bus bus{&cartridge_data, arena.Create<Bus::Memory>()};
+    CPU cpu{&bus};
+    PPU ppu{arena.Create<PPU::Memory>()};
+    APU apu{arena.Create<APU::Memory>()};
+    Scheduler scheduler;
+    InterruptController interrupts{&cpu, &scheduler, [this] { return MasterNow(); }};
+    Controllers controllers;
+
+    bool running = false;
+    std::unique_ptr<TraceWriter> tracer;
+    std::unique_ptr<Profiler> profiler;
+
+    // Master clock (21.477 MHz), derived from the CPU's cycle count. Every CPU cycle is
+    // charged at the FastROM/I-O speed; slower memory regions aren't modelled yet.
+    static constexpr uint64_t kMasterCyclesPerCPUCycle = 6;
+    uint64_t cpu_cycle_base = 0;    // CPU cycle count at master time 0
+    uint64_t ppu_dots = 0;          // Dots the PPU has been run for
+
+    // Frame skip: after each drawn frame, this many run without drawing
+    uint32_t frame_skip = 0;
+    uint32_t frames_until_drawn = 0;
+    bool frame_drawn = true;        // Whether the last finished frame was drawn
+
+    // Movie being recorded or played back, and the frame it's on
+    enum class MovieMode { None, Recording, Playing };
+    MovieMode movie_mode = MovieMode::None;
+    Movie movie;
+    uint64_t movie_frame = 0;
+    bool movie_frame_open = false;              // Whether movie_frame has started yet
+    std::optional<uint64_t> movie_mismatch;     // First played frame whose picture differed
+
+    // Scheduled work
+    static constexpr uint64_t kScanlineMasterCycles = PPU::kDotsPerScanline * PPU::kMasterCyclesPerDot;
+    static constexpr uint64_t kAPUSyncMasterCycles = 4 * kScanlineMasterCycles;
+    Scheduler::EventId scanline_event;
+    Scheduler::EventId apu_sync_event;
+
+    [[nodiscard]] uint64_t MasterNow() const { return (cpu.GetCycles() - cpu_cycle_base) * kMasterCyclesPerCPUCycle; }
+    [[nodiscard]] static uint64_t ToCPUCycles(const uint64_t master) {
+        return (master + kMasterCyclesPerCPUCycle - 1) / kMasterCyclesPerCPUCycle;
+    }
+
+    void ResetTiming();
+    void SyncPPU();
+    void OnScanline(uint64_t time);
+    void OnAPUSync(uint64_t time);
+    void OnMovieFrame();
+    void ApplyMovieInput();
 
 public:
     System();
     ~System();
 
     bool LoadROM(const std::string& filename);
+    void LoadROM(std::vector<uint8_t> data);
     void Reset();
+    // Reset plus cleared WRAM and SRAM, as if the console had just been switched on
+    void PowerOn();
     void Run();
+    // Runs the CPU up to the next scheduled event and handles everything that is due
     void Step();
+    // Runs until the PPU finishes the current frame
+    void RunFrame();
     void Shutdown();
+
+    void SetCPUBackend(CPUBackend backend) { cpu.SetBackend(backend); }
+    void SetJITVerification(bool enabled) { cpu.SetJITVerification(enabled); }
+    // See PPU::SetRenderThreads
+    void SetRenderThreads(uint32_t threads) { ppu.SetRenderThreads(threads); }
+    // Draws one frame in every frames + 1. Skipped frames still run the PPU's sprite evaluation
+    // and status flags, so games see no difference.
+    void SetFrameSkip(uint32_t frames) {
+        frame_skip = frames;
+        frames_until_drawn = std::min(frames_until_drawn, frames);
+    }
+    // Skips drawing the next `frames` frames whatever the frame skip, then draws one and goes back
+    // to the usual cadence. Callers that run several frames at a time use it to draw only the last.
+    void SkipNextFrames(uint32_t frames) { frames_until_drawn = frames; }
+    [[nodiscard]] bool IsFrameDrawn() const { return frame_drawn; }
+
+    // Pad input, see Controllers. `buttons` is a mask of Controllers::Button.
+    void SetButtons(uint32_t port, uint16_t buttons) { controllers.SetButtons(port, buttons); }
+    void SetInputPoll(std::function<void()> poll) { controllers.SetPoll(std::move(poll)); }
+
+    [[nodiscard]] uint64_t GetMasterCycles() const { return MasterNow(); }
+
+    // Everything the emulated machine holds, for the same ROM on the same kind of host. Saving
+    // between RunFrame calls keeps the state on a frame boundary. A state that doesn't load
+    // leaves the system as it was.
+    void SaveState(std::vector<uint8_t>& out) const;
+    bool LoadState(const uint8_t* data, size_t size);
+
+    // Movies, see movie.h. Recording starts from power-on or from a state saved on the spot.
+    void StartRecording(Movie::Anchor anchor);
+    // Also stops playback. Returns what was recorded, or the movie that was playing.
+    Movie StopMovie();
+    // Loads the movie's anchor and feeds it the recorded input, ignoring SetButtons and the poll
+    // hook until the movie runs out
+    bool StartPlayback(Movie played);
+    [[nodiscard]] bool IsPlayingMovie() const { return movie_mode == MovieMode::Playing; }
+    [[nodiscard]] uint64_t GetMovieFrame() const { return movie_frame; }
+    // The first frame of playback whose picture differed from the recording's, if any
+    [[nodiscard]] std::optional<uint64_t> GetMovieMismatch() const { return movie_mismatch; }
+
+    // FNV-1a over the last finished frame's pixels and size
+    [[nodiscard]] uint64_t GetFrameHash() const;
+
+    // The last finished frame, GetFrameWidth() pixels per row
+    [[nodiscard]] const uint32_t* GetFramebuffer() const { return ppu.GetFramebuffer(); }
+    [[nodiscard]] uint32_t GetFrameWidth() const { return ppu.GetOutputWidth(); }
+    [[nodiscard]] uint32_t GetFrameHeight() const { return ppu.GetOutputHeight(); }
+    [[nodiscard]] const uint8_t* GetWRAM() const { return bus.GetWRAM(); }
+
+    // Streams every executed instruction to a binary trace file, see tools/trace_format.cpp.
+    // Needs a build with BREADEDSNES_TRACE.
+    bool StartTrace(const std::string& path);
+    void StopTrace();
+
+    // Per-opcode and per-page execution counts, reported on Shutdown or on request.
+    // Needs a build with BREADEDSNES_PROFILE.
+    bool StartProfile();
+    void ReportProfile() const;
 };
 
 #endif //SYSTEM_H
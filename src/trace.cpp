@@ -0,0 +1,50 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#include "trace.h"
+
+#include <chrono>
+#include <iostream>
+
+bool TraceWriter::Start(const std::string& path) {
+    Stop();
+
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cout << "Failed to open trace file: " << path << std::endl;
+        return false;
+    }
+
+    constexpr TraceFileHeader header;
+    std::fwrite(&header, sizeof(header), 1, file);
+
+    stalls = 0;
+    running = true;
+    thread = std::thread(&TraceWriter::WriterLoop, this);
+    return true;
+}
+
+void TraceWriter::Stop() {
+    if (!file) return;
+
+    running = false;
+    if (thread.joinable()) thread.join();
+    Flush();
+
+    std::fclose(file);
+    file = nullptr;
+    if (stalls) std::cout << "Trace writer fell behind " << stalls << " times" << std::endl;
+}
+
+void TraceWriter::WriterLoop() {
+    while (running.load(std::memory_order_relaxed)) {
+        if (Flush() == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+size_t TraceWriter::Flush() {
+    return ring.Drain([this](const TraceRecord* records, const size_t count) {
+        std::fwrite(records, sizeof(TraceRecord), count, file);
+    });
+}
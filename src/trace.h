@@ -0,0 +1,108 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#ifndef TRACE_H
+#define TRACE_H
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+// One executed instruction, as written to a trace file. Registers are captured before
+// the instruction runs.
+struct TraceRecord {
+    uint64_t cycles;
+    uint32_t pc;            // PB:PC of the opcode
+    uint8_t opcode;
+    uint8_t operand[3];     // Only the first length - 1 bytes are meaningful
+    uint16_t a, x, y, sp, d;
+    uint8_t p;
+    uint8_t db;
+    uint8_t flags;          // kTraceEmulation
+    uint8_t length;         // Opcode + operand bytes under the current M/X flags
+    uint8_t reserved[2];
+};
+static_assert(sizeof(TraceRecord) == 32, "Trace records are a fixed 32 bytes on disk");
+static_assert(std::is_trivially_copyable_v<TraceRecord>);
+
+constexpr uint8_t kTraceEmulation = 0x01;
+
+// Trace files start with this, followed by raw TraceRecords in host byte order
+struct TraceFileHeader {
+    char magic[8] = {'B', 'S', 'N', 'S', 'T', 'R', 'C', '\0'};
+    uint32_t version = 1;
+    uint32_t record_size = sizeof(TraceRecord);
+};
+
+// Single-producer/single-consumer ring of trace records. The emulation thread pushes,
+// the writer thread pops; neither takes a lock.
+class TraceRing {
+    static constexpr size_t kCapacity = 1 << 16;    // Records, must be a power of two
+
+    std::array<TraceRecord, kCapacity> records;
+    alignas(64) std::atomic<size_t> head{0};        // Next slot to write, owned by the producer
+    alignas(64) std::atomic<size_t> tail{0};        // Next slot to read, owned by the consumer
+
+public:
+    // Returns false if the ring is full
+    bool TryPush(const TraceRecord& record) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == kCapacity) return false;
+        records[h & (kCapacity - 1)] = record;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Hands every readable record to fn(const TraceRecord*, count) in at most two runs
+    template <typename Fn>
+    size_t Drain(Fn&& fn) {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        const size_t h = head.load(std::memory_order_acquire);
+        const size_t count = h - t;
+        if (count == 0) return 0;
+
+        const size_t first = t & (kCapacity - 1);
+        const size_t run = count < kCapacity - first ? count : kCapacity - first;
+        fn(&records[first], run);
+        if (run < count) fn(&records[0], count - run);
+
+        tail.store(h, std::memory_order_release);
+        return count;
+    }
+};
+
+// Streams trace records to a file from a background thread
+class TraceWriter {
+    TraceRing ring;
+    std::FILE* file = nullptr;
+    std::thread thread;
+    std::atomic<bool> running{false};
+    uint64_t stalls = 0;    // Pushes that had to wait for the writer
+
+    void WriterLoop();
+    size_t Flush();
+
+public:
+    TraceWriter() = default;
+    ~TraceWriter() { Stop(); }
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    bool Start(const std::string& path);
+    void Stop();
+
+    // Called from the emulation thread. Waits for the writer rather than dropping records.
+    void Record(const TraceRecord& record) {
+        while (!ring.TryPush(record)) [[unlikely]] {
+            stalls++;
+            std::this_thread::yield();
+        }
+    }
+};
+
+#endif //TRACE_H
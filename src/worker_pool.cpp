@@ -0,0 +1,74 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#include "worker_pool.h"
+
+WorkerPool::WorkerPool(const uint32_t workers) {
+    threads.reserve(workers);
+    for (uint32_t i = 0; i < workers; i++) threads.emplace_back(&WorkerPool::WorkerLoop, this, i + 1);
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    start.notify_all();
+    for (std::thread& thread : threads) thread.join();
+}
+
+void WorkerPool::Run(const uint32_t tasks, const std::function<void(uint32_t)>& fn) {
+    Dispatch(tasks, fn, false);
+}
+
+void WorkerPool::RunPinned(const uint32_t tasks, const std::function<void(uint32_t)>& fn) {
+    Dispatch(tasks, fn, true);
+}
+
+void WorkerPool::Dispatch(const uint32_t tasks, const std::function<void(uint32_t)>& fn, const bool pin) {
+    {
+        std::lock_guard lock(mutex);
+        job = &fn;
+        task_count = tasks;
+        pinned = pin;
+        next_task.store(0, std::memory_order_relaxed);
+        busy = static_cast<uint32_t>(threads.size());
+        generation++;
+    }
+    start.notify_all();
+
+    RunTasks(0);
+
+    std::unique_lock lock(mutex);
+    done.wait(lock, [this] { return busy == 0; });
+    job = nullptr;
+}
+
+void WorkerPool::WorkerLoop(const uint32_t thread) {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock lock(mutex);
+            start.wait(lock, [this, seen] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+
+        RunTasks(thread);
+
+        std::lock_guard lock(mutex);
+        if (--busy == 0) done.notify_one();
+    }
+}
+
+// Unless pinned, tasks are handed out one at a time, so threads that finish early take more of them
+void WorkerPool::RunTasks(const uint32_t thread) {
+    if (pinned) {
+        for (uint32_t task = thread; task < task_count; task += GetThreadCount()) (*job)(task);
+        return;
+    }
+    for (uint32_t task = next_task.fetch_add(1); task < task_count; task = next_task.fetch_add(1)) {
+        (*job)(task);
+    }
+}
@@ -0,0 +1,51 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of threads that work through numbered tasks together with the thread calling Run
+class WorkerPool {
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable start;
+    std::condition_variable done;
+    uint64_t generation = 0;    // Bumped for each Run so sleeping workers know there's a new job
+    uint32_t busy = 0;          // Workers still on the current job
+    bool stopping = false;
+
+    const std::function<void(uint32_t)>* job = nullptr;
+    uint32_t task_count = 0;
+    bool pinned = false;
+    std::atomic<uint32_t> next_task{0};
+
+    void WorkerLoop(uint32_t thread);
+    void RunTasks(uint32_t thread);
+    void Dispatch(uint32_t tasks, const std::function<void(uint32_t)>& fn, bool pin);
+
+public:
+    explicit WorkerPool(uint32_t workers);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Worker threads plus the caller
+    [[nodiscard]] uint32_t GetThreadCount() const { return static_cast<uint32_t>(threads.size()) + 1; }
+
+    // Calls fn(0) to fn(tasks - 1) spread over every thread and returns once all of them have finished
+    void Run(uint32_t tasks, const std::function<void(uint32_t)>& fn);
+    // Same, but task i always runs on thread i % GetThreadCount() (the caller is thread 0), so
+    // whatever a task works on stays in one thread's caches from run to run
+    void RunPinned(uint32_t tasks, const std::function<void(uint32_t)>& fn);
+};
+
+#endif //WORKER_POOL_H
@@ -0,0 +1,286 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+// Runs the SingleStepTests 65816 vectors (one JSON file per opcode and mode, e.g. "a9.n.json")
+// against BasicCPU<FlatBus>: load the initial registers and RAM, execute one
+// instruction, then diff registers, RAM and the cycle count against the expected state.
+// Usage: breadedSNES-conformance [--cpu=interpreter|cached|jit] [--cycles] [--verbose]
+//                                [--baseline=file] [--write-baseline=file] <file or directory>...
+//
+// --cpu=jit compiles every instruction it can and checks it against the interpreter as it runs;
+// a disagreement fails the test.
+//
+// Exits non-zero if any file outside the baseline (a list of file names like "a9.n" that are
+// known to fail) has a failing test.
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "cpu.h"
+#include "flat_bus.h"
+#include "json.h"
+
+namespace {
+
+struct Options {
+    CPUBackend backend = CPUBackend::Interpreter;
+    bool check_cycles = false;      // Cycle count mismatches fail a test instead of just being counted
+    bool verbose = false;
+    std::string baseline_path;
+    std::string write_baseline_path;
+    std::vector<std::string> inputs;
+};
+
+struct FileResult {
+    std::string name;
+    size_t tests = 0;
+    size_t failures = 0;
+    size_t cycle_mismatches = 0;
+};
+
+class ConformanceRunner {
+    using TestCPU = BasicCPU<FlatBus>;
+
+    FlatBus bus;
+    TestCPU cpu{&bus};
+    uint8_t* memory = bus.GetMemory();
+    const Options& options;
+
+    static TestCPU::State ToState(const JSONValue& registers) {
+        TestCPU::State state{};
+        state.A = registers.Int("a");
+        state.X = registers.Int("x");
+        state.Y = registers.Int("y");
+        state.SP = registers.Int("s");
+        state.D = registers.Int("d");
+        state.PB = registers.Int("pbr");
+        state.PC = (state.PB << 16) | registers.Int("pc");
+        state.DB = registers.Int("dbr");
+        state.P = registers.Int("p");
+        state.emulation_mode = registers.Int("e");
+        return state;
+    }
+
+    static std::string Describe(const TestCPU::State& state) {
+        char text[128];
+        std::snprintf(text, sizeof(text), "PC:%02X:%04X A:%04X X:%04X Y:%04X S:%04X D:%04X DB:%02X P:%02X E:%d",
+                      state.PB, state.PC & 0xFFFF, state.A, state.X, state.Y, state.SP, state.D, state.DB, state.P,
+                      state.emulation_mode);
+        return text;
+    }
+
+    void SetRAM(const JSONValue* ram, const bool clear) {
+        if (!ram) return;
+        for (const JSONValue& entry : ram->array) {
+            if (entry.array.size() < 2) continue;
+            memory[static_cast<uint32_t>(entry.array[0].number) & 0xFFFFFF] =
+                clear ? 0 : static_cast<uint8_t>(entry.array[1].number);
+        }
+    }
+
+    // Returns a description of what differs, or an empty string if the test passed
+    std::string RunTest(const JSONValue& test, bool& cycle_mismatch) {
+        const JSONValue* initial = test.Find("initial");
+        const JSONValue* expected = test.Find("final");
+        if (!initial || !expected) return "missing initial or final state";
+
+        SetRAM(initial->Find("ram"), false);
+        // Code in flat RAM is rewritten between tests without the bus noticing
+        if (options.backend != CPUBackend::Interpreter) cpu.SetBackend(options.backend);
+        cpu.SetState(ToState(*initial));
+        // MVN/MVP move one byte per step here, like the vectors expect
+        cpu.SetCycleDeadline(0);
+        const uint64_t jit_mismatches = cpu.GetJITMismatches();
+        cpu.Step();
+
+        const TestCPU::State actual = cpu.GetState();
+        TestCPU::State wanted = ToState(*expected);
+        wanted.cycles = actual.cycles;
+        wanted.stopped = actual.stopped;
+        wanted.waiting_for_interrupt = actual.waiting_for_interrupt;
+
+        std::ostringstream diff;
+        if (cpu.GetJITMismatches() != jit_mismatches) diff << "\n      JIT and interpreter disagree";
+        if (actual.A != wanted.A || actual.X != wanted.X || actual.Y != wanted.Y || actual.SP != wanted.SP ||
+            actual.D != wanted.D || actual.DB != wanted.DB || actual.PB != wanted.PB || actual.P != wanted.P ||
+            (actual.PC & 0xFFFF) != (wanted.PC & 0xFFFF) || actual.emulation_mode != wanted.emulation_mode) {
+            diff << "\n      expected " << Describe(wanted) << "\n      actual   " << Describe(actual);
+        }
+
+        if (const JSONValue* ram = expected->Find("ram")) {
+            for (const JSONValue& entry : ram->array) {
+                if (entry.array.size() < 2) continue;
+                const uint32_t address = static_cast<uint32_t>(entry.array[0].number) & 0xFFFFFF;
+                const uint8_t value = static_cast<uint8_t>(entry.array[1].number);
+                if (memory[address] != value) {
+                    char text[64];
+                    std::snprintf(text, sizeof(text), "\n      [%06X] expected %02X, actual %02X", address, value,
+                                  memory[address]);
+                    diff << text;
+                }
+            }
+        }
+
+        const JSONValue* cycles = test.Find("cycles");
+        const size_t expected_cycles = cycles ? cycles->array.size() : 0;
+        cycle_mismatch = actual.cycles != expected_cycles;
+        if (cycle_mismatch && options.check_cycles) {
+            diff << "\n      expected " << expected_cycles << " cycles, actual " << actual.cycles;
+        }
+
+        SetRAM(initial->Find("ram"), true);
+        SetRAM(expected->Find("ram"), true);
+        return diff.str();
+    }
+
+public:
+    explicit ConformanceRunner(const Options& runner_options) : options(runner_options) {
+        cpu.SetBackend(options.backend);
+        cpu.SetJITThreshold(0);
+        cpu.SetJITVerification(true);
+    }
+
+    bool RunFile(const std::filesystem::path& path, FileResult& result) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            std::cout << "Failed to open " << path.string() << std::endl;
+            return false;
+        }
+        const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        JSONValue tests;
+        JSONParser parser(text);
+        if (!parser.Parse(tests) || tests.type != JSONValue::Type::Array) {
+            std::cout << path.string() << ": " << (parser.GetError().empty() ? "not a test array" : parser.GetError())
+                      << std::endl;
+            return false;
+        }
+
+        result.name = path.filename().string();
+        if (result.name.ends_with(".json")) result.name.resize(result.name.size() - 5);
+
+        for (const JSONValue& test : tests.array) {
+            bool cycle_mismatch = false;
+            const std::string diff = RunTest(test, cycle_mismatch);
+            result.tests++;
+            result.cycle_mismatches += cycle_mismatch;
+            if (diff.empty()) continue;
+
+            result.failures++;
+            if (options.verbose || result.failures <= 3) {
+                const JSONValue* name = test.Find("name");
+                std::cout << "  FAIL " << (name ? name->string : result.name) << diff << std::endl;
+            }
+        }
+        return true;
+    }
+};
+
+std::set<std::string> ReadBaseline(const std::string& path) {
+    std::set<std::string> names;
+    std::ifstream file(path);
+    if (!file) {
+        std::cout << "Failed to open baseline " << path << std::endl;
+        return names;
+    }
+    for (std::string line; std::getline(file, line);) {
+        line.erase(0, line.find_first_not_of(" \t"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (!line.empty() && line[0] != '#') names.insert(line);
+    }
+    return names;
+}
+
+} // namespace
+
+int main(const int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--cpu=interpreter") {
+            options.backend = CPUBackend::Interpreter;
+        } else if (arg == "--cpu=cached") {
+            options.backend = CPUBackend::BlockCache;
+        } else if (arg == "--cpu=jit") {
+            options.backend = CPUBackend::JIT;
+        } else if (arg == "--cycles") {
+            options.check_cycles = true;
+        } else if (arg == "--verbose") {
+            options.verbose = true;
+        } else if (arg.starts_with("--baseline=")) {
+            options.baseline_path = arg.substr(11);
+        } else if (arg.starts_with("--write-baseline=")) {
+            options.write_baseline_path = arg.substr(17);
+        } else if (arg.starts_with("--")) {
+            std::cout << "Unknown option " << arg << std::endl;
+            return 2;
+        } else {
+            options.inputs.push_back(arg);
+        }
+    }
+    if (options.inputs.empty()) {
+        std::cout << "Usage: " << argv[0] << " [--cpu=interpreter|cached|jit] [--cycles] [--verbose]"
+                  << " [--baseline=file] [--write-baseline=file] <file or directory>..." << std::endl;
+        return 2;
+    }
+
+    std::vector<std::filesystem::path> files;
+    for (const std::string& input : options.inputs) {
+        if (std::filesystem::is_directory(input)) {
+            for (const auto& entry : std::filesystem::directory_iterator(input)) {
+                if (entry.path().extension() == ".json") files.push_back(entry.path());
+            }
+        } else {
+            files.emplace_back(input);
+        }
+    }
+    std::ranges::sort(files);
+
+    const std::set<std::string> baseline =
+        options.baseline_path.empty() ? std::set<std::string>{} : ReadBaseline(options.baseline_path);
+
+    ConformanceRunner runner(options);
+    std::vector<FileResult> results;
+    size_t total_tests = 0, total_failures = 0, total_cycle_mismatches = 0, unexpected = 0, unreadable = 0;
+    for (const auto& path : files) {
+        FileResult result;
+        if (!runner.RunFile(path, result)) {
+            unreadable++;
+            continue;
+        }
+
+        const bool known = baseline.contains(result.name);
+        std::printf("%-8s %6zu/%-6zu passed", result.name.c_str(), result.tests - result.failures, result.tests);
+        if (result.cycle_mismatches) std::printf(", %zu cycle counts differ", result.cycle_mismatches);
+        if (result.failures && known) std::printf(" (known failure)");
+        std::printf("\n");
+        std::fflush(stdout);
+
+        total_tests += result.tests;
+        total_failures += result.failures;
+        total_cycle_mismatches += result.cycle_mismatches;
+        if (result.failures && !known) unexpected++;
+        results.push_back(result);
+    }
+
+    std::printf("\n%zu files, %zu tests, %zu failed, %zu cycle counts differ, %zu files failing outside the baseline\n",
+                results.size(), total_tests, total_failures, total_cycle_mismatches, unexpected);
+
+    if (!options.write_baseline_path.empty()) {
+        std::ofstream out(options.write_baseline_path);
+        out << "# Vector files with failing tests, generated by breadedSNES-conformance\n";
+        for (const FileResult& result : results) {
+            if (result.failures) out << result.name << "\n";
+        }
+    }
+
+    return unexpected || unreadable ? 1 : 0;
+}
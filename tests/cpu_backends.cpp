@@ -0,0 +1,193 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+// Checks that every CPU backend runs code exactly like the interpreter: same registers, same
+// cycle count and same WRAM. The JIT compiles every block the first time it sees it. Each case
+// runs random code from a random state in short slices, with an NMI and an IRQ raised along the
+// way, so blocks get cut off by deadlines and interrupts and code in WRAM gets overwritten while
+// it is cached. The same code, stepped one instruction at a time, also has to stay within the
+// cycle counts InstructionCycles gives, which blocks rely on to skip deadline checks. WAI with an
+// IRQ already pending and loops polling registers are checked on their own.
+// Usage: breadedSNES-cpu-backends-test [cases]
+
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cpu.h"
+#include "opcodes.h"
+
+namespace {
+
+struct Outcome {
+    CPU::State state;
+    std::vector<uint8_t> wram;
+};
+
+// Random bytes, minus opcodes the CPU doesn't implement
+uint8_t RandomCode(std::mt19937& random) {
+    const auto value = static_cast<uint8_t>(random());
+    return value == 0x02 || value == 0xDB ? 0xEA : value;
+}
+
+struct Machine {
+    std::unique_ptr<std::vector<uint8_t>> cartridge = std::make_unique<std::vector<uint8_t>>(0x40000);
+    std::unique_ptr<Bus> bus;
+    std::unique_ptr<CPU> cpu;
+};
+
+// Random code in ROM and the first 8KB of WRAM, and a random state to start it from
+Machine Build(const uint32_t seed, std::mt19937& random) {
+    Machine machine;
+    for (auto& byte : *machine.cartridge) byte = RandomCode(random);
+    machine.bus = std::make_unique<Bus>(machine.cartridge.get());
+    for (uint32_t address = 0; address < 0x2000; address++) {
+        machine.bus->Write(0x7E0000 + address, RandomCode(random));
+    }
+
+    CPU::State state{};
+    state.A = random();
+    state.X = random();
+    state.Y = random();
+    state.SP = 0x1F00 | (random() & 0xFF);
+    state.D = seed & 1 ? 0 : random() & 0x1FFF;
+    state.DB = seed & 2 ? 0x7E : 0;
+    state.PC = 0x8000 | (random() & 0x7FFF);
+    state.P = random() & ~0x04;
+    state.emulation_mode = seed % 7 == 0;
+    if (state.emulation_mode) state.P |= 0x30;
+    machine.cpu = std::make_unique<CPU>(machine.bus.get());
+    machine.cpu->SetState(state);
+    return machine;
+}
+
+Outcome Run(const uint32_t seed, const CPUBackend backend) {
+    std::mt19937 random(seed);
+    const Machine machine = Build(seed, random);
+    CPU* cpu = machine.cpu.get();
+    cpu->SetBackend(backend);
+    cpu->SetJITThreshold(0);
+
+    for (int slice = 0; slice < 6; slice++) {
+        cpu->SetCycleDeadline(cpu->GetCycles() + 50 + random() % 400);
+        cpu->Run();
+        if (slice == 2) cpu->RaiseNMI();
+        if (slice == 3) cpu->SetIRQLine(true);
+        if (slice == 4) cpu->SetIRQLine(false);
+        if (cpu->IsIdle()) cpu->SkipIdleCycles(37);
+    }
+    return {cpu->GetState(), std::vector<uint8_t>(machine.bus->GetWRAM(), machine.bus->GetWRAM() + 0x20000)};
+}
+
+// Steps the case's code on the interpreter and returns false at the first instruction that takes
+// a cycle count outside InstructionCycles
+bool CheckCycles(const uint32_t seed) {
+    std::mt19937 random(seed);
+    const Machine machine = Build(seed, random);
+    CPU* cpu = machine.cpu.get();
+    cpu->SetBackend(CPUBackend::Interpreter);
+
+    for (int step = 0; step < 500 && !cpu->IsIdle(); step++) {
+        const CPU::State before = cpu->GetState();
+        const uint32_t pc = before.PC & 0xFFFFFF;
+        if (!machine.bus->IsPlainMemory(pc)) break;
+        const uint8_t opcode = machine.bus->Read(pc);
+        const CycleRange range = InstructionCycles(opcode, before.P & 0x20, before.P & 0x10);
+        cpu->Step();
+        const uint64_t taken = cpu->GetCycles() - before.cycles;
+        if (taken < range.min || taken > range.max) {
+            std::cout << "Case " << seed << ": opcode " << std::hex << static_cast<int>(opcode) << " at " << pc
+                      << std::dec << " took " << taken << " cycles, expected " << range.min << " to " << range.max
+                      << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// A machine about to run `code` from $00:0100, in native mode with IRQs disabled
+Machine BuildSnippet(const std::initializer_list<uint8_t> code, const CPUBackend backend) {
+    Machine machine;
+    machine.bus = std::make_unique<Bus>(machine.cartridge.get());
+    uint32_t address = 0x0100;
+    for (const uint8_t byte : code) machine.bus->Write(address++, byte);
+    machine.cpu = std::make_unique<CPU>(machine.bus.get());
+    CPU::State state{};
+    state.PC = 0x0100;
+    state.SP = 0x1FF;
+    state.P = 0x34;
+    machine.cpu->SetState(state);
+    machine.cpu->SetBackend(backend);
+    return machine;
+}
+
+// SEI; WAI with an IRQ already asserted has to carry straight on, and a loop that polls a register
+// with read side effects must never be taken for an idle loop, on every backend
+bool CheckInterruptsAndIdleLoops() {
+    bool passed = true;
+    for (const CPUBackend backend : {CPUBackend::Interpreter, CPUBackend::BlockCache, CPUBackend::JIT}) {
+        const Machine waiting = BuildSnippet({0x78, 0xCB, 0xE8, 0x80, 0xFE}, backend);  // SEI; WAI; INX; BRA -2
+        waiting.cpu->SetIRQLine(true);
+        waiting.cpu->SetCycleDeadline(100);
+        waiting.cpu->Run();
+        const CPU::State after = waiting.cpu->GetState();
+        if (after.waiting_for_interrupt || after.X != 1) {
+            std::cout << "WAI with an IRQ pending " << (after.waiting_for_interrupt ? "slept" : "didn't reach INX")
+                      << " on backend " << static_cast<int>(backend) << std::endl;
+            passed = false;
+        }
+
+        // LDA abs; BRA -5, on plain memory, an interrupt status register and a PPU latch
+        for (const auto& [address, idle] : {std::pair<uint16_t, bool>{0x0010, true}, {0x4212, true}, {0x2137, false}}) {
+            const Machine polling = BuildSnippet(
+                {0xAD, static_cast<uint8_t>(address), static_cast<uint8_t>(address >> 8), 0x80, 0xFB}, backend);
+            polling.cpu->SetCycleDeadline(1000);
+            polling.cpu->Run();
+            if (polling.cpu->IsIdle() != idle) {
+                std::cout << "A loop reading $" << std::hex << address << std::dec << (idle ? " wasn't" : " was")
+                          << " taken for an idle loop on backend " << static_cast<int>(backend) << std::endl;
+                passed = false;
+            }
+        }
+    }
+    return passed;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const uint32_t cases = argc > 1 ? std::stoul(argv[1]) : 500;
+    uint32_t failures = 0;
+    for (uint32_t seed = 0; seed < cases; seed++) {
+        if (!CheckCycles(seed)) {
+            failures++;
+            continue;
+        }
+        const Outcome expected = Run(seed, CPUBackend::Interpreter);
+        bool failed = false;
+        for (const CPUBackend backend : {CPUBackend::BlockCache, CPUBackend::JIT}) {
+            const Outcome actual = Run(seed, backend);
+            if (actual.state == expected.state && actual.wram == expected.wram) continue;
+
+            if (!failed && failures < 10) {
+                std::cout << "Case " << seed << ": the " << (backend == CPUBackend::JIT ? "JIT" : "block cache")
+                          << " ends at PC " << std::hex << actual.state.PC << " after " << std::dec
+                          << actual.state.cycles << " cycles, the interpreter at " << std::hex << expected.state.PC
+                          << " after " << std::dec << expected.state.cycles
+                          << (actual.wram == expected.wram ? "" : ", and WRAM differs") << std::endl;
+            }
+            failed = true;
+        }
+        failures += failed;
+    }
+    std::cout << std::dec << cases - failures << " of " << cases << " cases passed" << std::endl;
+    const bool passed = !failures && CheckInterruptsAndIdleLoops();
+    std::cout << (passed ? "Passed" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+}
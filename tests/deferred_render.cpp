@@ -0,0 +1,117 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+// Checks that deferred rendering (PPU::SetRenderThreads) draws the same frames as drawing each
+// line as it starts. The frames change VRAM, CGRAM, OAM and registers partway down, so every
+// logged line has to keep the memory it saw rather than what is there at VBlank.
+// Usage: breadedSNES-deferred-render-test
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <utility>
+
+#include "ppu.h"
+
+namespace {
+
+// FNV-1a over the output size and pixels
+uint64_t HashFrame(const PPU& ppu) {
+    uint64_t hash = 0xCBF29CE484222325;
+    const auto mix = [&hash](const uint32_t value) {
+        hash ^= value;
+        hash *= 0x100000001B3;
+    };
+    mix(ppu.GetOutputWidth());
+    mix(ppu.GetOutputHeight());
+    for (uint32_t i = 0; i < ppu.GetOutputWidth() * ppu.GetOutputHeight(); i++) mix(ppu.GetFramebuffer()[i]);
+    return hash;
+}
+
+// Registers written twice in a row, low byte first
+void WriteTwice(PPU& ppu, const uint16_t address, const uint16_t value) {
+    ppu.WriteRegister(address, value & 0xFF);
+    ppu.WriteRegister(address, value >> 8);
+}
+
+// Register pairs with the low byte at `address` and the high byte at the next one
+void WritePair(PPU& ppu, const uint16_t address, const uint16_t value) {
+    ppu.WriteRegister(address, value & 0xFF);
+    ppu.WriteRegister(address + 1, value >> 8);
+}
+
+// Mode 7 with sprites, a window and color math, then two frames of mid-frame writes. Returns the
+// hash of the second frame.
+uint64_t RenderFrames(const uint32_t threads, const bool mid_frame_writes) {
+    auto ppu = std::make_unique<PPU>();
+    ppu->SetRenderThreads(threads);
+    std::mt19937 random(7);
+
+    ppu->WriteRegister(0x2115, 0x80);   // VMAIN: increment after the high byte
+    for (int i = 0; i < 0x8000; i++) WritePair(*ppu, 0x2118, static_cast<uint16_t>(random()));
+    for (int i = 0; i < 0x200; i++) ppu->WriteRegister(0x2122, static_cast<uint8_t>(random()));
+    for (int i = 0; i < 0x220; i++) ppu->WriteRegister(0x2104, static_cast<uint8_t>(random()));
+
+    static constexpr std::pair<uint16_t, uint16_t> kMode7[] = {
+        {0x211B, 0x014C}, {0x211C, 0x00C0}, {0x211D, 0xFF40}, {0x211E, 0x014C}, {0x211F, 0x0200}, {0x2120, 0x0200},
+    };
+    for (const auto& [address, value] : kMode7) WriteTwice(*ppu, address, value);
+    static constexpr std::pair<uint16_t, uint8_t> kRegisters[] = {
+        {0x2105, 0x07}, {0x2101, 0x60}, {0x212C, 0x11}, {0x212D, 0x10}, {0x2125, 0x02}, {0x2126, 64},
+        {0x2127, 191}, {0x212E, 0x10}, {0x2130, 0x02}, {0x2131, 0x41}, {0x2100, 0x0F},
+    };
+    for (const auto& [address, value] : kRegisters) ppu->WriteRegister(address, value);
+
+    for (int frame = 0; frame < 2; frame++) {
+        ppu->OnFrameStart();
+        for (uint16_t line = 1; line < ppu->VBlankScanline(); line++) {
+            if (mid_frame_writes) {
+                if (line % 37 == 0) {
+                    ppu->WriteRegister(0x2121, line & 0xFF);
+                    WriteTwice(*ppu, 0x2122, static_cast<uint16_t>(random()));
+                }
+                if (line == 90) {
+                    // VRAM only takes writes in force blank
+                    ppu->WriteRegister(0x2100, 0x80);
+                    WritePair(*ppu, 0x2116, 0);
+                    for (int i = 0; i < 0x800; i++) WritePair(*ppu, 0x2118, static_cast<uint16_t>(random()));
+                }
+                if (line == 95) ppu->WriteRegister(0x2100, 0x0A);
+                if (line == 120) {
+                    ppu->WriteRegister(0x2126, static_cast<uint8_t>(10 + frame));
+                    ppu->WriteRegister(0x2133, 0x08);
+                    ppu->WriteRegister(0x212D, 0x11);
+                }
+                if (line == 150) {
+                    WritePair(*ppu, 0x2102, 0);
+                    for (int i = 0; i < 64; i++) ppu->WriteRegister(0x2104, static_cast<uint8_t>(random()));
+                }
+            }
+            ppu->RenderScanline(line);
+        }
+        ppu->OnVBlankStart();
+    }
+    return HashFrame(*ppu);
+}
+
+} // namespace
+
+int main() {
+    const uint64_t inline_hash = RenderFrames(0, true);
+    bool passed = true;
+    for (const uint32_t threads : {1u, 4u}) {
+        const uint64_t deferred_hash = RenderFrames(threads, true);
+        std::cout << "inline " << std::hex << inline_hash << ", deferred on " << std::dec << threads << " thread(s) "
+                  << std::hex << deferred_hash << std::dec << std::endl;
+        passed &= deferred_hash == inline_hash;
+    }
+    // Otherwise the comparison above would prove nothing about the writes
+    if (RenderFrames(0, false) == inline_hash) {
+        std::cout << "The mid-frame writes didn't change the picture" << std::endl;
+        passed = false;
+    }
+    std::cout << (passed ? "Passed" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+}
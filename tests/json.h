@@ -0,0 +1,161 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+#ifndef JSON_H
+#define JSON_H
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Just enough JSON for test vectors: objects, arrays, strings, numbers, booleans and null.
+// String escapes other than \" \\ \/ \b \f \n \r \t are kept as-is.
+class JSONValue {
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0;
+    std::string string;
+    std::vector<JSONValue> array;
+    std::vector<std::pair<std::string, JSONValue>> object;
+
+    [[nodiscard]] const JSONValue* Find(const std::string_view key) const {
+        for (const auto& [name, value] : object) {
+            if (name == key) return &value;
+        }
+        return nullptr;
+    }
+
+    // 0 for anything that isn't a number
+    [[nodiscard]] int64_t Int(const std::string_view key) const {
+        const JSONValue* value = Find(key);
+        return value && value->type == Type::Number ? static_cast<int64_t>(value->number) : 0;
+    }
+};
+
+class JSONParser {
+    std::string_view text;
+    size_t at = 0;
+    std::string error;
+
+    void SkipSpace() {
+        while (at < text.size() && (text[at] == ' ' || text[at] == '\n' || text[at] == '\r' || text[at] == '\t')) at++;
+    }
+
+    bool Fail(const std::string& message) {
+        if (error.empty()) error = message + " at offset " + std::to_string(at);
+        return false;
+    }
+
+    bool Expect(const std::string_view word) {
+        if (text.substr(at, word.size()) != word) return Fail("Expected " + std::string(word));
+        at += word.size();
+        return true;
+    }
+
+    bool ParseString(std::string& out) {
+        if (!Expect("\"")) return false;
+        while (at < text.size() && text[at] != '"') {
+            char c = text[at++];
+            if (c == '\\' && at < text.size()) {
+                switch (c = text[at++]) {
+                    case 'b': c = '\b'; break;
+                    case 'f': c = '\f'; break;
+                    case 'n': c = '\n'; break;
+                    case 'r': c = '\r'; break;
+                    case 't': c = '\t'; break;
+                    case '"': case '\\': case '/': break;
+                    default: out += '\\'; break;
+                }
+            }
+            out += c;
+        }
+        return Expect("\"");
+    }
+
+    bool ParseValue(JSONValue& out, const int depth) {
+        if (depth > 64) return Fail("Nested too deeply");
+        SkipSpace();
+        if (at >= text.size()) return Fail("Unexpected end of input");
+
+        switch (text[at]) {
+            case '{': {
+                out.type = JSONValue::Type::Object;
+                at++;
+                SkipSpace();
+                if (at < text.size() && text[at] == '}') {
+                    at++;
+                    return true;
+                }
+                while (true) {
+                    SkipSpace();
+                    auto& [name, value] = out.object.emplace_back();
+                    if (!ParseString(name)) return false;
+                    SkipSpace();
+                    if (!Expect(":") || !ParseValue(value, depth + 1)) return false;
+                    SkipSpace();
+                    if (at < text.size() && text[at] == ',') {
+                        at++;
+                        continue;
+                    }
+                    return Expect("}");
+                }
+            }
+            case '[': {
+                out.type = JSONValue::Type::Array;
+                at++;
+                SkipSpace();
+                if (at < text.size() && text[at] == ']') {
+                    at++;
+                    return true;
+                }
+                while (true) {
+                    if (!ParseValue(out.array.emplace_back(), depth + 1)) return false;
+                    SkipSpace();
+                    if (at < text.size() && text[at] == ',') {
+                        at++;
+                        continue;
+                    }
+                    return Expect("]");
+                }
+            }
+            case '"':
+                out.type = JSONValue::Type::String;
+                return ParseString(out.string);
+            case 't':
+                out.type = JSONValue::Type::Bool;
+                out.boolean = true;
+                return Expect("true");
+            case 'f':
+                out.type = JSONValue::Type::Bool;
+                return Expect("false");
+            case 'n':
+                return Expect("null");
+            default: {
+                out.type = JSONValue::Type::Number;
+                const auto [end, result] = std::from_chars(text.data() + at, text.data() + text.size(), out.number);
+                if (result != std::errc()) return Fail("Expected a value");
+                at = end - text.data();
+                return true;
+            }
+        }
+    }
+
+public:
+    explicit JSONParser(const std::string_view input) : text(input) {}
+
+    bool Parse(JSONValue& out) {
+        if (!ParseValue(out, 0)) return false;
+        SkipSpace();
+        return at == text.size() || Fail("Trailing characters");
+    }
+
+    [[nodiscard]] const std::string& GetError() const { return error; }
+};
+
+#endif //JSON_H
@@ -0,0 +1,118 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+// Runs many emulator instances at once and reports their combined speed. Every instance plays
+// the same movie, or gets its own pseudo-random pad input, or none.
+// Usage: breadedSNES-batch [--instances=k] [--threads=n] [--frames=n] [--cpu=interpreter|cached|jit]
+//                          [--frame-skip=n] [--movie=file | --random-input] rom
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "batch_runner.h"
+
+// Stateless, so any instance can work out its input for any frame on its own thread
+static uint16_t RandomButtons(const uint32_t instance, const uint64_t frame, const uint32_t port) {
+    // A new state every 8 frames, so games see presses rather than noise
+    uint64_t x = (static_cast<uint64_t>(instance) << 40) ^ ((frame / 8) << 1) ^ port;
+    x += 0x9E3779B97F4A7C15;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EB;
+    x ^= x >> 31;
+    return static_cast<uint16_t>(x) & 0xFFF0;
+}
+
+int main(const int argc, char* argv[]) {
+    uint32_t instances = std::max(std::thread::hardware_concurrency(), 1u);
+    uint32_t threads = instances;
+    std::optional<uint64_t> frames;
+    std::optional<CPUBackend> backend;
+    uint32_t frame_skip = 0;
+    std::string movie_path;
+    bool random_input = false;
+    const char* rom_path = nullptr;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg.starts_with("--instances=")) {
+            instances = std::max(static_cast<uint32_t>(std::stoul(arg.substr(12))), 1u);
+        } else if (arg.starts_with("--threads=")) {
+            threads = std::max(static_cast<uint32_t>(std::stoul(arg.substr(10))), 1u);
+        } else if (arg.starts_with("--frames=")) {
+            frames = std::stoull(arg.substr(9));
+        } else if (arg == "--cpu=interpreter") {
+            backend = CPUBackend::Interpreter;
+        } else if (arg == "--cpu=cached") {
+            backend = CPUBackend::BlockCache;
+        } else if (arg == "--cpu=jit") {
+            backend = CPUBackend::JIT;
+        } else if (arg.starts_with("--frame-skip=")) {
+            frame_skip = static_cast<uint32_t>(std::stoul(arg.substr(13)));
+        } else if (arg.starts_with("--movie=")) {
+            movie_path = arg.substr(8);
+        } else if (arg == "--random-input") {
+            random_input = true;
+        } else if (!arg.starts_with("--") && !rom_path) {
+            rom_path = argv[i];
+        } else {
+            rom_path = nullptr;
+            break;
+        }
+    }
+    if (!rom_path) {
+        std::cerr << "Usage: " << argv[0] << " [--instances=k] [--threads=n] [--frames=n]"
+                  << " [--cpu=interpreter|cached|jit] [--frame-skip=n] [--movie=file | --random-input] rom"
+                  << std::endl;
+        return 1;
+    }
+    threads = std::min(threads, instances);
+
+    BatchRunner runner(instances, threads);
+    if (!runner.LoadROM(rom_path)) return 1;
+    runner.ForEach([&](uint32_t, System& system) {
+        if (backend) system.SetCPUBackend(*backend);
+        system.SetFrameSkip(frame_skip);
+    });
+
+    Movie movie;
+    if (!movie_path.empty()) {
+        if (!movie.Load(movie_path) || !runner.StartPlayback(movie)) return 1;
+        if (!frames) frames = movie.frames.size();
+    } else if (random_input) {
+        runner.SetInputCallback([](const uint32_t instance, const uint64_t frame, System& system) {
+            for (uint32_t port = 0; port < Controllers::kPorts; port++) {
+                system.SetButtons(port, RandomButtons(instance, frame, port));
+            }
+        });
+    }
+    if (!frames) frames = 600;
+
+    const auto start = std::chrono::steady_clock::now();
+    runner.RunFrames(*frames);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Instances given the same input should all end on the same picture
+    std::set<uint64_t> final_hashes;
+    uint32_t mismatched = 0;
+    for (uint32_t instance = 0; instance < instances; instance++) {
+        System& system = runner.GetSystem(instance);
+        final_hashes.insert(system.GetFrameHash());
+        if (system.GetMovieMismatch()) mismatched++;
+    }
+
+    const double total = static_cast<double>(runner.GetTotalFrames());
+    std::printf("%u instances on %u threads, %llu frames each in %.3f s\n", instances, runner.GetThreadCount(),
+                static_cast<unsigned long long>(*frames), seconds);
+    std::printf("%.1f frames/s total, %.1f per instance\n", total / seconds, total / seconds / instances);
+    std::printf("%zu distinct final frames\n", final_hashes.size());
+    if (!movie_path.empty()) {
+        std::printf("%u of %u instances drifted from the movie\n", mismatched, instances);
+        return mismatched ? 2 : 0;
+    }
+    return 0;
+}
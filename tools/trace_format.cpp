@@ -0,0 +1,106 @@
+//
+// Created by Palindromic Bread Loaf on 10/18/26.
+//
+
+// Turns a binary trace written by TraceWriter into one disassembled line per instruction.
+// Usage: breadedSNES-trace trace.bin [max_lines]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "opcodes.h"
+#include "trace.h"
+
+static std::string FormatOperand(const TraceRecord& record) {
+    const AddressingMode mode = kOpcodeTable[record.opcode].mode;
+    const uint32_t value = record.operand[0] | (record.operand[1] << 8) | (record.operand[2] << 16);
+    const int width = 2 * (record.length - 1);
+    const uint16_t next = static_cast<uint16_t>(record.pc + record.length);
+
+    char text[24];
+    switch (mode) {
+        case AddressingMode::Implied: return "";
+        case AddressingMode::Accumulator: return "A";
+        case AddressingMode::ImmediateM:
+        case AddressingMode::ImmediateX:
+        case AddressingMode::Immediate8: std::snprintf(text, sizeof(text), "#$%0*X", width & 7, value); break;
+        case AddressingMode::DirectPage: std::snprintf(text, sizeof(text), "$%02X", value); break;
+        case AddressingMode::DirectPageX: std::snprintf(text, sizeof(text), "$%02X,X", value); break;
+        case AddressingMode::DirectPageY: std::snprintf(text, sizeof(text), "$%02X,Y", value); break;
+        case AddressingMode::DirectPageIndirect: std::snprintf(text, sizeof(text), "($%02X)", value); break;
+        case AddressingMode::DirectPageIndirectX: std::snprintf(text, sizeof(text), "($%02X,X)", value); break;
+        case AddressingMode::DirectPageIndirectY: std::snprintf(text, sizeof(text), "($%02X),Y", value); break;
+        case AddressingMode::DirectPageIndirectLong: std::snprintf(text, sizeof(text), "[$%02X]", value); break;
+        case AddressingMode::DirectPageIndirectLongY: std::snprintf(text, sizeof(text), "[$%02X],Y", value); break;
+        case AddressingMode::StackRelative: std::snprintf(text, sizeof(text), "$%02X,S", value); break;
+        case AddressingMode::StackRelativeIndirectY: std::snprintf(text, sizeof(text), "($%02X,S),Y", value); break;
+        case AddressingMode::Absolute: std::snprintf(text, sizeof(text), "$%04X", value); break;
+        case AddressingMode::AbsoluteX: std::snprintf(text, sizeof(text), "$%04X,X", value); break;
+        case AddressingMode::AbsoluteY: std::snprintf(text, sizeof(text), "$%04X,Y", value); break;
+        case AddressingMode::AbsoluteIndirect: std::snprintf(text, sizeof(text), "($%04X)", value); break;
+        case AddressingMode::AbsoluteIndirectX: std::snprintf(text, sizeof(text), "($%04X,X)", value); break;
+        case AddressingMode::AbsoluteIndirectLong: std::snprintf(text, sizeof(text), "[$%04X]", value); break;
+        case AddressingMode::AbsoluteLong: std::snprintf(text, sizeof(text), "$%06X", value); break;
+        case AddressingMode::AbsoluteLongX: std::snprintf(text, sizeof(text), "$%06X,X", value); break;
+        case AddressingMode::Relative:
+            std::snprintf(text, sizeof(text), "$%04X", static_cast<uint16_t>(next + static_cast<int8_t>(value)));
+            break;
+        case AddressingMode::RelativeLong:
+            std::snprintf(text, sizeof(text), "$%04X", static_cast<uint16_t>(next + static_cast<int16_t>(value)));
+            break;
+        case AddressingMode::BlockMove:
+            // Encoded as dest, src but written src, dest
+            std::snprintf(text, sizeof(text), "$%02X,$%02X", record.operand[1], record.operand[0]);
+            break;
+    }
+    return text;
+}
+
+int main(const int argc, char* argv[]) {
+    if (argc < 2) {
+        std::fprintf(stderr, "Usage: %s trace.bin [max_lines]\n", argv[0]);
+        return 1;
+    }
+    const uint64_t max_lines = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : UINT64_MAX;
+
+    std::FILE* file = std::fopen(argv[1], "rb");
+    if (!file) {
+        std::fprintf(stderr, "Failed to open %s\n", argv[1]);
+        return 1;
+    }
+
+    TraceFileHeader header;
+    constexpr TraceFileHeader expected;
+    if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+        std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 ||
+        header.version != expected.version || header.record_size != sizeof(TraceRecord)) {
+        std::fprintf(stderr, "%s is not a version %u trace file\n", argv[1], expected.version);
+        std::fclose(file);
+        return 1;
+    }
+
+    TraceRecord records[4096];
+    uint64_t lines = 0;
+    size_t count;
+    while (lines < max_lines && (count = std::fread(records, sizeof(TraceRecord), 4096, file)) > 0) {
+        for (size_t i = 0; i < count && lines < max_lines; i++, lines++) {
+            const TraceRecord& r = records[i];
+
+            char bytes[16];
+            int used = std::snprintf(bytes, sizeof(bytes), "%02X", r.opcode);
+            for (int b = 0; b + 1 < r.length; b++) {
+                used += std::snprintf(bytes + used, sizeof(bytes) - used, " %02X", r.operand[b]);
+            }
+
+            std::printf("%02X:%04X  %-12s %s %-12s A:%04X X:%04X Y:%04X S:%04X D:%04X DB:%02X P:%02X %c cyc:%llu\n",
+                        r.pc >> 16, r.pc & 0xFFFF, bytes, kOpcodeTable[r.opcode].mnemonic,
+                        FormatOperand(r).c_str(), r.a, r.x, r.y, r.sp, r.d, r.db, r.p,
+                        (r.flags & kTraceEmulation) ? 'E' : 'N', static_cast<unsigned long long>(r.cycles));
+        }
+    }
+
+    std::fclose(file);
+    return 0;
+}